@@ -13,8 +13,10 @@
  * limitations under the License.
  */
 
+#include <algorithm>
 #include <map>
 #include <cinttypes>
+#include <vector>
 
 #include "ohos.batteryStatistics.proj.hpp"
 #include "ohos.batteryStatistics.impl.hpp"
@@ -76,25 +78,34 @@ taihe::array<ohos::batteryStatistics::BatteryStatsInfo> GetBatteryStatsSync()
 {
     BatteryStatsInfoList nativeStatsInfos = BatteryStatsClient::GetInstance().GetBatteryStats();
     StatsError code = BatteryStatsClient::GetInstance().GetLastError();
-    std::vector<ohos::batteryStatistics::BatteryStatsInfo> tmpVector;
+    const ohos::batteryStatistics::BatteryStatsInfo emptyInfo = {
+        .uid = StatsUtils::INVALID_VALUE,
+        .type = type_key_t::CONSUMPTION_TYPE_INVALID,
+        .power = StatsUtils::DEFAULT_VALUE
+    };
     if (code != StatsError::ERR_OK && g_errorTable.find(code) != g_errorTable.end()) {
         taihe::set_business_error(static_cast<int32_t>(code), g_errorTable[code]);
-        return taihe::array_view<ohos::batteryStatistics::BatteryStatsInfo>(tmpVector);
+        return taihe::array<ohos::batteryStatistics::BatteryStatsInfo>::make(0, emptyInfo);
     }
+    // Size the result up front and fill it in place, entries of unknown type are not reported
+    size_t count = std::count_if(nativeStatsInfos.begin(), nativeStatsInfos.end(), [](const auto& item) {
+        return TaiheConsumptionTypeWrapper(item->GetConsumptionType()).get_key() !=
+            type_key_t::CONSUMPTION_TYPE_INVALID;
+    });
+    auto result = taihe::array<ohos::batteryStatistics::BatteryStatsInfo>::make(count, emptyInfo);
+    size_t index = 0;
     for (const auto& item : nativeStatsInfos) {
         auto type = TaiheConsumptionTypeWrapper(item->GetConsumptionType());
         if (type.get_key() == type_key_t::CONSUMPTION_TYPE_INVALID) {
             continue;
         }
-        ohos::batteryStatistics::BatteryStatsInfo statsInfo = {
-            .uid = item->GetUid(),
-            .type = type,
-            .power = item->GetPower()
-        };
-        tmpVector.push_back(statsInfo);
+        result[index].uid = item->GetUid();
+        result[index].type = type;
+        result[index].power = item->GetPower();
+        index++;
     }
-    STATS_HILOGI(COMP_FWK, "GetBatteryStatsSync success, size %{public}zu", tmpVector.size());
-    return taihe::array_view<ohos::batteryStatistics::BatteryStatsInfo>(tmpVector);
+    STATS_HILOGI(COMP_FWK, "GetBatteryStatsSync success, size %{public}zu", count);
+    return result;
 }
 
 double GetAppPowerValue(int32_t uid)
@@ -144,6 +155,35 @@ double GetHardwareUnitPowerPercent(ohos::batteryStatistics::ConsumptionType type
     }
     return partStatsPercent;
 }
+
+taihe::array<ohos::batteryStatistics::AppPowerValue> GetAppPowerValues(taihe::array_view<int32_t> uids)
+{
+    std::vector<int32_t> nativeUids(uids.begin(), uids.end());
+    AppStatsBatch batch = BatteryStatsClient::GetInstance().GetAppStatsBatch(nativeUids,
+        APP_STATS_FIELD_MAH | APP_STATS_FIELD_PERCENT);
+    StatsError code = BatteryStatsClient::GetInstance().GetLastError();
+    const ohos::batteryStatistics::AppPowerValue emptyValue = {
+        .uid = StatsUtils::INVALID_VALUE,
+        .power = StatsUtils::DEFAULT_VALUE,
+        .percent = StatsUtils::DEFAULT_VALUE
+    };
+    if (code != StatsError::ERR_OK && g_errorTable.find(code) != g_errorTable.end()) {
+        taihe::set_business_error(static_cast<int32_t>(code), g_errorTable[code]);
+        return taihe::array<ohos::batteryStatistics::AppPowerValue>::make(0, emptyValue);
+    }
+    auto result = taihe::array<ohos::batteryStatistics::AppPowerValue>::make(nativeUids.size(), emptyValue);
+    for (size_t i = 0; i < nativeUids.size(); i++) {
+        result[i].uid = nativeUids[i];
+        if (i < batch.appStatsMah.size()) {
+            result[i].power = batch.appStatsMah[i];
+        }
+        if (i < batch.appStatsPercent.size()) {
+            result[i].percent = batch.appStatsPercent[i];
+        }
+    }
+    STATS_HILOGI(COMP_FWK, "GetAppPowerValues success, size %{public}zu", result.size());
+    return result;
+}
 }  // namespace
 
 // Since these macros are auto-generate, lint will cause false positive
@@ -153,4 +193,5 @@ TH_EXPORT_CPP_API_GetAppPowerValue(GetAppPowerValue);
 TH_EXPORT_CPP_API_GetAppPowerPercent(GetAppPowerPercent);
 TH_EXPORT_CPP_API_GetHardwareUnitPowerValue(GetHardwareUnitPowerValue);
 TH_EXPORT_CPP_API_GetHardwareUnitPowerPercent(GetHardwareUnitPowerPercent);
+TH_EXPORT_CPP_API_GetAppPowerValues(GetAppPowerValues);
 // NOLINTEND
\ No newline at end of file
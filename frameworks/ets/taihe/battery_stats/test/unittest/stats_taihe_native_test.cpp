@@ -74,6 +74,18 @@ double BatteryStatsClient::GetPartStatsPercent(const BatteryStatsInfo::Consumpti
     return 0.0;
 }
 
+AppStatsBatch BatteryStatsClient::GetAppStatsBatch(const std::vector<int32_t>& uids, uint32_t fieldMask)
+{
+    AppStatsBatch batch;
+    if ((fieldMask & APP_STATS_FIELD_MAH) != 0) {
+        batch.appStatsMah.assign(uids.size(), 1.0);
+    }
+    if ((fieldMask & APP_STATS_FIELD_PERCENT) != 0) {
+        batch.appStatsPercent.assign(uids.size(), 0.5);
+    }
+    return batch;
+}
+
 StatsError BatteryStatsClient::GetLastError()
 {
     STATS_HILOGI(LABEL_TEST, "enter mock GetLastError, %{public}d", static_cast<int32_t>(g_error));
@@ -235,4 +247,58 @@ HWTEST_F(StatsTaiheNativeTest, StatsTaiheNativeTest_005, TestSize.Level1)
     EXPECT_TRUE(IsEqual(result, 0.0));
     STATS_HILOGI(LABEL_TEST, "StatsTaiheNativeTest_005 end");
 }
+
+/**
+ * @tc.name: StatsTaiheNativeTest_006
+ * @tc.desc: test stats taihe native batch app power values
+ * @tc.type: FUNC
+ */
+HWTEST_F(StatsTaiheNativeTest, StatsTaiheNativeTest_006, TestSize.Level1)
+{
+    STATS_HILOGI(LABEL_TEST, "StatsTaiheNativeTest_006 start");
+    std::vector<int32_t> uids = {10021, 10022};
+    g_error = StatsError::ERR_OK;
+    auto result = GetAppPowerValues(taihe::array_view<int32_t>(uids));
+    ASSERT_EQ(result.size(), uids.size());
+    EXPECT_EQ(result[1].uid, uids[1]);
+    EXPECT_TRUE(IsEqual(result[1].power, 1.0));
+    EXPECT_TRUE(IsEqual(result[1].percent, 0.5));
+
+    g_error = StatsError::ERR_SYSTEM_API_DENIED;
+    result = GetAppPowerValues(taihe::array_view<int32_t>(uids));
+    EXPECT_TRUE(result.empty());
+    STATS_HILOGI(LABEL_TEST, "StatsTaiheNativeTest_006 end");
+}
+
+/**
+ * @tc.name: StatsTaiheNativeTest_007
+ * @tc.desc: test stats taihe native result array is filled in place and skips invalid types
+ * @tc.type: FUNC
+ */
+HWTEST_F(StatsTaiheNativeTest, StatsTaiheNativeTest_007, TestSize.Level1)
+{
+    STATS_HILOGI(LABEL_TEST, "StatsTaiheNativeTest_007 start");
+    g_list.clear();
+    g_error = StatsError::ERR_OK;
+    std::shared_ptr<OHOS::PowerMgr::BatteryStatsInfo> info = std::make_shared<OHOS::PowerMgr::BatteryStatsInfo>();
+    info->SetUid(10021);
+    info->SetConsumptioType(OHOS::PowerMgr::BatteryStatsInfo::CONSUMPTION_TYPE_APP);
+    info->SetPower(1.5);
+    g_list.push_back(info);
+    g_list.push_back(std::make_shared<OHOS::PowerMgr::BatteryStatsInfo>());
+    info = std::make_shared<OHOS::PowerMgr::BatteryStatsInfo>();
+    info->SetConsumptioType(OHOS::PowerMgr::BatteryStatsInfo::CONSUMPTION_TYPE_SCREEN);
+    info->SetPower(2.5);
+    g_list.push_back(info);
+
+    auto result = GetBatteryStatsSync();
+    ASSERT_EQ(result.size(), 2);
+    EXPECT_EQ(result[0].uid, 10021);
+    EXPECT_TRUE(result[0].type.get_key() == ohos::batteryStatistics::ConsumptionType::key_t::CONSUMPTION_TYPE_APP);
+    EXPECT_TRUE(IsEqual(result[0].power, 1.5));
+    EXPECT_TRUE(result[1].type.get_key() == ohos::batteryStatistics::ConsumptionType::key_t::CONSUMPTION_TYPE_SCREEN);
+    EXPECT_TRUE(IsEqual(result[1].power, 2.5));
+    g_list.clear();
+    STATS_HILOGI(LABEL_TEST, "StatsTaiheNativeTest_007 end");
+}
 }
@@ -16,6 +16,7 @@
 #ifndef BATTERY_STATISTICS_ASYNC_CALLBACK_INFO_H
 #define BATTERY_STATISTICS_ASYNC_CALLBACK_INFO_H
 
+#include <cstdint>
 #include <vector>
 
 #include "napi/native_api.h"
@@ -49,16 +50,33 @@ public:
 
     class AsyncData {
     public:
-        struct StatsInfo {
-            int32_t uid_ = StatsUtils::INVALID_VALUE;
-            int32_t type_ = BatteryStatsInfo::CONSUMPTION_TYPE_INVALID;
-            double power_ = StatsUtils::DEFAULT_VALUE;
+        enum class QueryType : int32_t {
+            BATTERY_STATS = 0,
+            APP_STATS_MAH,
+            APP_STATS_PERCENT,
+            PART_STATS_MAH,
+            PART_STATS_PERCENT,
+            APP_STATS_BATCH,
         };
+        void SetQuery(QueryType type, int32_t arg);
+        void SetBatchQuery(std::vector<int32_t>&& uids, uint32_t fieldMask);
+        // Runs on the async work thread, must not touch the napi env
+        StatsError Execute();
+        void CreateResultValue(napi_env& env, napi_value& result);
         StatsError GetBatteryStatsInfo();
         void CreateArrayValue(napi_env& env, napi_value& arrRes);
+        static void CreateAppStatsBatchValue(napi_env& env, const std::vector<int32_t>& uids, uint32_t fieldMask,
+            const AppStatsBatch& batch, napi_value& arrRes);
 
     private:
-        std::vector<StatsInfo> statsInfos_;
+        StatsError GetStatsValue();
+        QueryType type_ = QueryType::BATTERY_STATS;
+        int32_t arg_ = StatsUtils::INVALID_VALUE;
+        double value_ = StatsUtils::DEFAULT_VALUE;
+        std::vector<int32_t> uids_;
+        uint32_t fieldMask_ = APP_STATS_FIELD_ALL;
+        AppStatsBatch batch_;
+        BatteryStatsInfoList statsInfos_;
     };
     inline AsyncData& GetData()
     {
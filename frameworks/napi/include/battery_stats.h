@@ -17,6 +17,7 @@
 #define BATTERY_STATS_H
 
 #include <functional>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -24,11 +25,13 @@
 #include "napi/native_common.h"
 #include "napi/native_node_api.h"
 
+#include "async_callback_info.h"
 #include "napi_error.h"
 namespace OHOS {
 namespace PowerMgr {
 class BatteryStats {
 public:
+    using QueryType = AsyncCallbackInfo::AsyncData::QueryType;
     explicit BatteryStats(napi_env& env);
     void StatsAsyncCallBack(napi_value& value);
     napi_value StatsPromise();
@@ -36,10 +39,16 @@ public:
     napi_value GetAppStatsPercent(napi_callback_info& info, uint32_t maxArgc, uint32_t index);
     napi_value GetPartStatsMah(napi_callback_info& info, uint32_t maxArgc, uint32_t index);
     napi_value GetPartStatsPercent(napi_callback_info& info, uint32_t maxArgc, uint32_t index);
+    napi_value GetAppStatsBatch(napi_callback_info& info, uint32_t maxArgc, uint32_t index);
+    napi_value GetStatsAsync(napi_callback_info& info, uint32_t maxArgc, uint32_t index, QueryType type);
+    napi_value GetAppStatsBatchAsync(napi_callback_info& info, uint32_t maxArgc, uint32_t index);
 
 private:
+    bool GetUidArray(napi_value& value, std::vector<int32_t>& uids);
     napi_value GetAppOrPartStats(napi_callback_info& info, uint32_t maxArgc, uint32_t index,
         std::function<double(int32_t, NapiError&)> getAppOrPart);
+    napi_value QueueStatsWork(
+        std::unique_ptr<AsyncCallbackInfo>& asyncInfo, napi_value* callback, const char* resourceName);
     napi_env env_ {nullptr};
 };
 } // namespace PowerMgr
@@ -15,12 +15,26 @@
 
 #include "async_callback_info.h"
 
+#include <map>
+#include <utility>
+
 #include "battery_stats_client.h"
 #include "napi_utils.h"
 #include "stats_log.h"
 
 namespace OHOS {
 namespace PowerMgr {
+namespace {
+constexpr napi_property_attributes JS_PROPERTY_ATTRIBUTES =
+    static_cast<napi_property_attributes>(napi_writable | napi_enumerable | napi_configurable);
+enum StatsInfoField : size_t {
+    FIELD_UID = 0,
+    FIELD_TYPE,
+    FIELD_POWER,
+    FIELD_COUNT
+};
+} // namespace
+
 void AsyncCallbackInfo::CallFunction(napi_env& env, napi_value results)
 {
     napi_value callback = nullptr;
@@ -58,20 +72,115 @@ void AsyncCallbackInfo::CreateCallback(napi_env& env, napi_value& callback)
     callbackRef_ = NapiUtils::CreateReference(env, callback);
 }
 
+void AsyncCallbackInfo::AsyncData::SetQuery(QueryType type, int32_t arg)
+{
+    type_ = type;
+    arg_ = arg;
+}
+
+void AsyncCallbackInfo::AsyncData::SetBatchQuery(std::vector<int32_t>&& uids, uint32_t fieldMask)
+{
+    type_ = QueryType::APP_STATS_BATCH;
+    uids_ = std::move(uids);
+    fieldMask_ = fieldMask;
+}
+
+StatsError AsyncCallbackInfo::AsyncData::Execute()
+{
+    // The client keeps the last error per thread, so it is read on the work thread that made the call
+    switch (type_) {
+        case QueryType::BATTERY_STATS:
+            return GetBatteryStatsInfo();
+        case QueryType::APP_STATS_BATCH:
+            batch_ = BatteryStatsClient::GetInstance().GetAppStatsBatch(uids_, fieldMask_);
+            STATS_HILOGD(COMP_FWK, "get app stats batch for %{public}zu uids", uids_.size());
+            return BatteryStatsClient::GetInstance().GetLastError();
+        default:
+            return GetStatsValue();
+    }
+}
+
+StatsError AsyncCallbackInfo::AsyncData::GetStatsValue()
+{
+    auto& client = BatteryStatsClient::GetInstance();
+    switch (type_) {
+        case QueryType::APP_STATS_MAH:
+            value_ = client.GetAppStatsMah(arg_);
+            break;
+        case QueryType::APP_STATS_PERCENT:
+            value_ = client.GetAppStatsPercent(arg_);
+            break;
+        case QueryType::PART_STATS_MAH:
+            value_ = client.GetPartStatsMah(BatteryStatsInfo::ConsumptionType(arg_));
+            break;
+        case QueryType::PART_STATS_PERCENT:
+            value_ = client.GetPartStatsPercent(BatteryStatsInfo::ConsumptionType(arg_));
+            break;
+        default:
+            return StatsError::ERR_PARAM_INVALID;
+    }
+    STATS_HILOGD(COMP_FWK, "get stats value: %{public}lf, query: %{public}d, arg: %{public}d",
+        value_, static_cast<int32_t>(type_), arg_);
+    return client.GetLastError();
+}
+
+void AsyncCallbackInfo::AsyncData::CreateResultValue(napi_env& env, napi_value& result)
+{
+    switch (type_) {
+        case QueryType::BATTERY_STATS:
+            CreateArrayValue(env, result);
+            break;
+        case QueryType::APP_STATS_BATCH:
+            CreateAppStatsBatchValue(env, uids_, fieldMask_, batch_, result);
+            break;
+        default:
+            napi_create_double(env, value_, &result);
+            break;
+    }
+}
+
+void AsyncCallbackInfo::AsyncData::CreateAppStatsBatchValue(napi_env& env, const std::vector<int32_t>& uids,
+    uint32_t fieldMask, const AppStatsBatch& batch, napi_value& arrRes)
+{
+    std::map<int32_t, std::vector<std::pair<int32_t, double>>> breakdownMap;
+    for (const auto& item : batch.breakdown) {
+        breakdownMap[item->GetUid()].emplace_back(item->GetConsumptionType(), item->GetPower());
+    }
+    if (napi_ok != napi_create_array_with_length(env, uids.size(), &arrRes)) {
+        STATS_HILOGW(COMP_FWK, "napi creates array error");
+        return;
+    }
+    for (size_t i = 0; i < uids.size(); i++) {
+        napi_value result = nullptr;
+        napi_create_object(env, &result);
+        NapiUtils::SetIntValue(env, "uid", uids[i], result);
+        if (i < batch.appStatsMah.size()) {
+            NapiUtils::SetDoubleValue(env, "power", batch.appStatsMah[i], result);
+        }
+        if (i < batch.appStatsPercent.size()) {
+            NapiUtils::SetDoubleValue(env, "percent", batch.appStatsPercent[i], result);
+        }
+        if ((fieldMask & APP_STATS_FIELD_BREAKDOWN) != 0) {
+            const auto& components = breakdownMap[uids[i]];
+            napi_value details = nullptr;
+            napi_create_array_with_length(env, components.size(), &details);
+            for (size_t j = 0; j < components.size(); j++) {
+                napi_value detail = nullptr;
+                napi_create_object(env, &detail);
+                NapiUtils::SetIntValue(env, "type", components[j].first, detail);
+                NapiUtils::SetDoubleValue(env, "power", components[j].second, detail);
+                napi_set_element(env, details, j, detail);
+            }
+            napi_set_named_property(env, result, "details", details);
+        }
+        napi_set_element(env, arrRes, i, result);
+    }
+}
+
 StatsError AsyncCallbackInfo::AsyncData::GetBatteryStatsInfo()
 {
-    statsInfos_.clear();
-    BatteryStatsInfoList nativeStatsInfos = BatteryStatsClient::GetInstance().GetBatteryStats();
-    StatsError code = BatteryStatsClient::GetInstance().GetLastError();
-    std::transform(
-        nativeStatsInfos.begin(), nativeStatsInfos.end(), std::back_inserter(statsInfos_), [](const auto& item) {
-            StatsInfo statsInfo = {
-                .uid_ = item->GetUid(),
-                .type_ = item->GetConsumptionType(),
-                .power_ = item->GetPower()};
-            return statsInfo;
-        });
-    return code;
+    statsInfos_ = BatteryStatsClient::GetInstance().GetBatteryStats();
+    return BatteryStatsClient::GetInstance().GetLastError();
 }
 
 void AsyncCallbackInfo::AsyncData::CreateArrayValue(napi_env& env, napi_value& arrRes)
@@ -80,15 +189,24 @@ void AsyncCallbackInfo::AsyncData::CreateArrayValue(napi_env& env, napi_value& a
         STATS_HILOGW(COMP_FWK, "napi creates array error");
         return;
     }
-    int32_t index = 0;
-    for (auto& item : statsInfos_) {
+    // The property names are created once per call and every object is defined in one batch
+    napi_property_descriptor desc[FIELD_COUNT] = {};
+    const char* const names[FIELD_COUNT] = { "uid", "type", "power" };
+    for (size_t i = 0; i < FIELD_COUNT; i++) {
+        napi_create_string_utf8(env, names[i], NAPI_AUTO_LENGTH, &desc[i].name);
+        desc[i].attributes = JS_PROPERTY_ATTRIBUTES;
+    }
+    uint32_t index = 0;
+    for (const auto& item : statsInfos_) {
+        if (item == nullptr) {
+            continue;
+        }
         napi_value result = nullptr;
         napi_create_object(env, &result);
-
-        NapiUtils::SetIntValue(env, "uid", item.uid_, result);
-        NapiUtils::SetIntValue(env, "type", item.type_, result);
-        NapiUtils::SetDoubleValue(env, "power", item.power_, result);
-
+        napi_create_int32(env, item->GetUid(), &desc[FIELD_UID].value);
+        napi_create_int32(env, item->GetConsumptionType(), &desc[FIELD_TYPE].value);
+        napi_create_double(env, item->GetPower(), &desc[FIELD_POWER].value);
+        napi_define_properties(env, result, FIELD_COUNT, desc);
         napi_set_element(env, arrRes, index, result);
         index++;
     }
@@ -16,6 +16,7 @@
 #include "battery_stats.h"
 
 #include <memory>
+#include <utility>
 
 #include "async_callback_info.h"
 #include "battery_stats_client.h"
@@ -31,56 +32,48 @@ BatteryStats::BatteryStats(napi_env& env) : env_(env) {}
 void BatteryStats::StatsAsyncCallBack(napi_value& value)
 {
     std::unique_ptr<AsyncCallbackInfo> asyncInfo = std::make_unique<AsyncCallbackInfo>();
-    asyncInfo->CreateCallback(env_, value);
-    napi_value resource = nullptr;
-    NAPI_CALL_RETURN_VOID(env_, napi_create_string_utf8(env_, "StatsAsyncCallBack", NAPI_AUTO_LENGTH, &resource));
-    napi_create_async_work(
-        env_, nullptr, resource,
-        [](napi_env env, void* data) {
-            AsyncCallbackInfo* asCallbackInfo = reinterpret_cast<AsyncCallbackInfo*>(data);
-            STATS_RETURN_IF(asCallbackInfo == nullptr);
-            asCallbackInfo->GetError().Error(asCallbackInfo->GetData().GetBatteryStatsInfo());
-        },
-        [](napi_env env, napi_status status, void* data) {
-            AsyncCallbackInfo* asCallbackInfo = reinterpret_cast<AsyncCallbackInfo*>(data);
-            STATS_RETURN_IF(asCallbackInfo == nullptr);
-            napi_value arrRes = nullptr;
-            asCallbackInfo->GetData().CreateArrayValue(env, arrRes);
-            asCallbackInfo->CallFunction(env, arrRes);
-            asCallbackInfo->Release(env);
-            delete asCallbackInfo;
-        },
-        reinterpret_cast<void*>(asyncInfo.get()), &asyncInfo->GetAsyncWork());
-    NAPI_CALL_RETURN_VOID(
-        env_, napi_queue_async_work_with_qos(env_, asyncInfo->GetAsyncWork(), napi_qos_utility));
-    asyncInfo.release();
+    QueueStatsWork(asyncInfo, &value, "StatsAsyncCallBack");
 }
 
 napi_value BatteryStats::StatsPromise()
 {
     std::unique_ptr<AsyncCallbackInfo> asyncInfo = std::make_unique<AsyncCallbackInfo>();
-    napi_value promise;
-    asyncInfo->CreatePromise(env_, promise);
-    STATS_RETURN_IF_WITH_RET(promise == nullptr, nullptr);
+    return QueueStatsWork(asyncInfo, nullptr, "StatsPromise");
+}
+
+napi_value BatteryStats::QueueStatsWork(
+    std::unique_ptr<AsyncCallbackInfo>& asyncInfo, napi_value* callback, const char* resourceName)
+{
+    napi_value promise = nullptr;
+    if (callback != nullptr) {
+        asyncInfo->CreateCallback(env_, *callback);
+    } else {
+        asyncInfo->CreatePromise(env_, promise);
+        STATS_RETURN_IF_WITH_RET(promise == nullptr, nullptr);
+    }
 
-    napi_value resourceName = nullptr;
-    NAPI_CALL_BASE(env_, napi_create_string_utf8(env_, "StatsPromise", NAPI_AUTO_LENGTH, &resourceName), promise);
+    napi_value resource = nullptr;
+    NAPI_CALL_BASE(env_, napi_create_string_utf8(env_, resourceName, NAPI_AUTO_LENGTH, &resource), promise);
     napi_create_async_work(
-        env_, nullptr, resourceName,
+        env_, nullptr, resource,
         [](napi_env env, void* data) {
             AsyncCallbackInfo* asCallbackInfo = reinterpret_cast<AsyncCallbackInfo*>(data);
             STATS_RETURN_IF(asCallbackInfo == nullptr);
-            asCallbackInfo->GetError().Error(asCallbackInfo->GetData().GetBatteryStatsInfo());
+            asCallbackInfo->GetError().Error(asCallbackInfo->GetData().Execute());
         },
         [](napi_env env, napi_status status, void* data) {
             AsyncCallbackInfo* asCallbackInfo = reinterpret_cast<AsyncCallbackInfo*>(data);
             STATS_RETURN_IF(asCallbackInfo == nullptr);
-            if (asCallbackInfo->GetError().IsError()) {
+            if (asCallbackInfo->GetDeferred() == nullptr) {
+                napi_value results = nullptr;
+                asCallbackInfo->GetData().CreateResultValue(env, results);
+                asCallbackInfo->CallFunction(env, results);
+            } else if (asCallbackInfo->GetError().IsError()) {
                 napi_reject_deferred(env, asCallbackInfo->GetDeferred(), asCallbackInfo->GetError().GetNapiError(env));
             } else {
-                napi_value arrRes = nullptr;
-                asCallbackInfo->GetData().CreateArrayValue(env, arrRes);
-                napi_resolve_deferred(env, asCallbackInfo->GetDeferred(), arrRes);
+                napi_value results = nullptr;
+                asCallbackInfo->GetData().CreateResultValue(env, results);
+                napi_resolve_deferred(env, asCallbackInfo->GetDeferred(), results);
             }
             asCallbackInfo->Release(env);
             delete asCallbackInfo;
@@ -91,6 +84,31 @@ napi_value BatteryStats::StatsPromise()
     return promise;
 }
 
+napi_value BatteryStats::GetStatsAsync(napi_callback_info& info, uint32_t maxArgc, uint32_t index, QueryType type)
+{
+    size_t argc = maxArgc;
+    napi_value argv[argc];
+    NapiUtils::GetCallbackInfo(env_, info, argc, argv);
+    NapiError error;
+
+    if (argc <= index || argc > maxArgc || !NapiUtils::CheckValueType(env_, argv[index], napi_number)) {
+        return error.ThrowError(env_, StatsError::ERR_PARAM_INVALID);
+    }
+    napi_value* callback = nullptr;
+    if (argc == maxArgc) {
+        if (!NapiUtils::CheckValueType(env_, argv[maxArgc - 1], napi_function)) {
+            return error.ThrowError(env_, StatsError::ERR_PARAM_INVALID);
+        }
+        callback = &argv[maxArgc - 1];
+    }
+
+    int32_t jsValue;
+    napi_get_value_int32(env_, argv[index], &jsValue);
+    std::unique_ptr<AsyncCallbackInfo> asyncInfo = std::make_unique<AsyncCallbackInfo>();
+    asyncInfo->GetData().SetQuery(type, jsValue);
+    return QueueStatsWork(asyncInfo, callback, "GetStatsAsync");
+}
+
 napi_value BatteryStats::GetAppStatsMah(napi_callback_info& info, uint32_t maxArgc, uint32_t index)
 {
     return GetAppOrPartStats(info, maxArgc, index, [&](int32_t uid, NapiError& error) {
@@ -156,5 +174,91 @@ napi_value BatteryStats::GetAppOrPartStats(
     napi_create_double(env_, statsData, &result);
     return result;
 }
+bool BatteryStats::GetUidArray(napi_value& value, std::vector<int32_t>& uids)
+{
+    bool isArray = false;
+    if (napi_ok != napi_is_array(env_, value, &isArray) || !isArray) {
+        STATS_HILOGW(COMP_FWK, "Uids is not an array");
+        return false;
+    }
+    uint32_t length = 0;
+    napi_get_array_length(env_, value, &length);
+    uids.reserve(length);
+    for (uint32_t i = 0; i < length; i++) {
+        napi_value element = nullptr;
+        napi_get_element(env_, value, i, &element);
+        if (!NapiUtils::CheckValueType(env_, element, napi_number)) {
+            return false;
+        }
+        int32_t uid = StatsUtils::INVALID_VALUE;
+        napi_get_value_int32(env_, element, &uid);
+        uids.push_back(uid);
+    }
+    return true;
+}
+
+napi_value BatteryStats::GetAppStatsBatch(napi_callback_info& info, uint32_t maxArgc, uint32_t index)
+{
+    size_t argc = maxArgc;
+    napi_value argv[argc];
+    NapiUtils::GetCallbackInfo(env_, info, argc, argv);
+    NapiError error;
+
+    std::vector<int32_t> uids;
+    if (argc <= index || argc > maxArgc || !GetUidArray(argv[index], uids)) {
+        return error.ThrowError(env_, StatsError::ERR_PARAM_INVALID);
+    }
+    uint32_t fieldMask = APP_STATS_FIELD_ALL;
+    if (argc == maxArgc) {
+        if (!NapiUtils::CheckValueType(env_, argv[maxArgc - 1], napi_number)) {
+            return error.ThrowError(env_, StatsError::ERR_PARAM_INVALID);
+        }
+        napi_get_value_uint32(env_, argv[maxArgc - 1], &fieldMask);
+    }
+
+    AppStatsBatch batch = BatteryStatsClient::GetInstance().GetAppStatsBatch(uids, fieldMask);
+    error.Error(BatteryStatsClient::GetInstance().GetLastError());
+    if (error.IsError()) {
+        return error.ThrowError(env_);
+    }
+    STATS_HILOGD(COMP_FWK, "get app stats batch for %{public}zu uids", uids.size());
+
+    napi_value arrRes = nullptr;
+    AsyncCallbackInfo::AsyncData::CreateAppStatsBatchValue(env_, uids, fieldMask, batch, arrRes);
+    return arrRes;
+}
+napi_value BatteryStats::GetAppStatsBatchAsync(napi_callback_info& info, uint32_t maxArgc, uint32_t index)
+{
+    size_t argc = maxArgc;
+    napi_value argv[argc];
+    NapiUtils::GetCallbackInfo(env_, info, argc, argv);
+    NapiError error;
+
+    std::vector<int32_t> uids;
+    if (argc <= index || argc > maxArgc || !GetUidArray(argv[index], uids)) {
+        return error.ThrowError(env_, StatsError::ERR_PARAM_INVALID);
+    }
+    // The field mask and the callback are both optional, a trailing function is always the callback
+    size_t optionalEnd = argc;
+    napi_value* callback = nullptr;
+    if (argc > index + 1 && NapiUtils::CheckValueType(env_, argv[argc - 1], napi_function)) {
+        callback = &argv[argc - 1];
+        optionalEnd--;
+    }
+    uint32_t fieldMask = APP_STATS_FIELD_ALL;
+    if (optionalEnd > index + 2) {
+        return error.ThrowError(env_, StatsError::ERR_PARAM_INVALID);
+    }
+    if (optionalEnd == index + 2) {
+        if (!NapiUtils::CheckValueType(env_, argv[index + 1], napi_number)) {
+            return error.ThrowError(env_, StatsError::ERR_PARAM_INVALID);
+        }
+        napi_get_value_uint32(env_, argv[index + 1], &fieldMask);
+    }
+
+    std::unique_ptr<AsyncCallbackInfo> asyncInfo = std::make_unique<AsyncCallbackInfo>();
+    asyncInfo->GetData().SetBatchQuery(std::move(uids), fieldMask);
+    return QueueStatsWork(asyncInfo, callback, "GetAppStatsBatchAsync");
+}
 } // namespace PowerMgr
 } // namespace OHOS
@@ -27,6 +27,9 @@ using namespace OHOS::PowerMgr;
 
 namespace {
 constexpr uint32_t MAX_ARGC = 1;
+constexpr uint32_t BATCH_MAX_ARGC = 2;
+constexpr uint32_t ASYNC_MAX_ARGC = 2;
+constexpr uint32_t BATCH_ASYNC_MAX_ARGC = 3;
 constexpr uint32_t ARGV_IND_0 = 0;
 } // namespace
 
@@ -78,6 +81,42 @@ static napi_value GetPartStatsPercent(napi_env env, napi_callback_info info)
     return stats.GetPartStatsPercent(info, MAX_ARGC, ARGV_IND_0);
 }
 
+static napi_value GetAppStatsBatch(napi_env env, napi_callback_info info)
+{
+    BatteryStats stats(env);
+    return stats.GetAppStatsBatch(info, BATCH_MAX_ARGC, ARGV_IND_0);
+}
+
+static napi_value GetAppStatsMahAsync(napi_env env, napi_callback_info info)
+{
+    BatteryStats stats(env);
+    return stats.GetStatsAsync(info, ASYNC_MAX_ARGC, ARGV_IND_0, BatteryStats::QueryType::APP_STATS_MAH);
+}
+
+static napi_value GetAppStatsPercentAsync(napi_env env, napi_callback_info info)
+{
+    BatteryStats stats(env);
+    return stats.GetStatsAsync(info, ASYNC_MAX_ARGC, ARGV_IND_0, BatteryStats::QueryType::APP_STATS_PERCENT);
+}
+
+static napi_value GetPartStatsMahAsync(napi_env env, napi_callback_info info)
+{
+    BatteryStats stats(env);
+    return stats.GetStatsAsync(info, ASYNC_MAX_ARGC, ARGV_IND_0, BatteryStats::QueryType::PART_STATS_MAH);
+}
+
+static napi_value GetPartStatsPercentAsync(napi_env env, napi_callback_info info)
+{
+    BatteryStats stats(env);
+    return stats.GetStatsAsync(info, ASYNC_MAX_ARGC, ARGV_IND_0, BatteryStats::QueryType::PART_STATS_PERCENT);
+}
+
+static napi_value GetAppStatsBatchAsync(napi_env env, napi_callback_info info)
+{
+    BatteryStats stats(env);
+    return stats.GetAppStatsBatchAsync(info, BATCH_ASYNC_MAX_ARGC, ARGV_IND_0);
+}
+
 static napi_value EnumStatsTypeConstructor(napi_env env, napi_callback_info info)
 {
     napi_value thisArg = nullptr;
@@ -129,6 +168,32 @@ static napi_value CreateEnumStatsType(napi_env env, napi_value exports)
     return exports;
 }
 
+static napi_value CreateEnumAppStatsField(napi_env env, napi_value exports)
+{
+    napi_value power = nullptr;
+    napi_value percent = nullptr;
+    napi_value details = nullptr;
+    napi_value all = nullptr;
+
+    napi_create_uint32(env, APP_STATS_FIELD_MAH, &power);
+    napi_create_uint32(env, APP_STATS_FIELD_PERCENT, &percent);
+    napi_create_uint32(env, APP_STATS_FIELD_BREAKDOWN, &details);
+    napi_create_uint32(env, APP_STATS_FIELD_ALL, &all);
+
+    napi_property_descriptor desc[] = {
+        DECLARE_NAPI_STATIC_PROPERTY("POWER", power),
+        DECLARE_NAPI_STATIC_PROPERTY("PERCENT", percent),
+        DECLARE_NAPI_STATIC_PROPERTY("DETAILS", details),
+        DECLARE_NAPI_STATIC_PROPERTY("ALL", all),
+    };
+    napi_value result = nullptr;
+    napi_define_class(env, "AppStatsField", NAPI_AUTO_LENGTH, EnumStatsTypeConstructor, nullptr,
+        sizeof(desc) / sizeof(*desc), desc, &result);
+
+    napi_set_named_property(env, exports, "AppStatsField", result);
+    return exports;
+}
+
 EXTERN_C_START
 /*
  * function for module exports
@@ -141,10 +206,17 @@ static napi_value BatteryStatsInit(napi_env env, napi_value exports)
         DECLARE_NAPI_FUNCTION("getAppPowerPercent", GetAppStatsPercent),
         DECLARE_NAPI_FUNCTION("getHardwareUnitPowerValue", GetPartStatsMah),
         DECLARE_NAPI_FUNCTION("getHardwareUnitPowerPercent", GetPartStatsPercent),
+        DECLARE_NAPI_FUNCTION("getAppPowerValues", GetAppStatsBatch),
+        DECLARE_NAPI_FUNCTION("getAppPowerValueAsync", GetAppStatsMahAsync),
+        DECLARE_NAPI_FUNCTION("getAppPowerPercentAsync", GetAppStatsPercentAsync),
+        DECLARE_NAPI_FUNCTION("getHardwareUnitPowerValueAsync", GetPartStatsMahAsync),
+        DECLARE_NAPI_FUNCTION("getHardwareUnitPowerPercentAsync", GetPartStatsPercentAsync),
+        DECLARE_NAPI_FUNCTION("getAppPowerValuesAsync", GetAppStatsBatchAsync),
     };
     NAPI_CALL(env, napi_define_properties(env, exports, sizeof(desc) / sizeof(desc[0]), desc));
 
     CreateEnumStatsType(env, exports);
+    CreateEnumAppStatsField(env, exports);
     return exports;
 }
 EXTERN_C_END
@@ -15,6 +15,8 @@
 
 #include "battery_stats_client.h"
 
+#include <chrono>
+
 #include "errors.h"
 #include "refbase.h"
 #include "if_system_ability_manager.h"
@@ -30,9 +32,19 @@ namespace OHOS {
 namespace PowerMgr {
 BatteryStatsClient::BatteryStatsClient() {}
 BatteryStatsClient::~BatteryStatsClient() {}
+thread_local StatsError BatteryStatsClient::lastError_ {StatsError::ERR_OK};
+thread_local StatsError BatteryStatsClient::tempError_ {StatsError::ERR_OK};
 constexpr int32_t INIT_VALUE = -1;
 constexpr uint32_t PARAM_MAX_NUM = 10;
 
+namespace {
+int64_t GetSteadyTimeMs()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+}
+
 ErrCode BatteryStatsClient::Connect()
 {
     std::lock_guard<std::mutex> lock(mutex_);
@@ -50,6 +62,7 @@ ErrCode BatteryStatsClient::Connect()
         return E_STATS_GET_SERVICE_FAILED;
     }
     proxy_ = iface_cast<IBatteryStats>(remoteObject_);
+    AttachEpochCounter(proxy_);
     return ERR_OK;
 }
 
@@ -61,6 +74,8 @@ void BatteryStatsClient::ResetProxy(const wptr<IRemoteObject>& remote)
     if ((serviceRemote != nullptr) && (serviceRemote == remote.promote())) {
         serviceRemote->RemoveDeathRecipient(deathRecipient_);
         proxy_ = nullptr;
+        // A restarted service counts epochs in a new region, nothing cached can be validated anymore
+        ClearCache();
     }
 }
 
@@ -85,15 +100,91 @@ BatteryStatsInfoList BatteryStatsClient::GetBatteryStats()
 
     ParcelableBatteryStatsList parcelableEntityList;
     int32_t tempError = INIT_VALUE;
-    proxy_->GetBatteryStatsIpc(parcelableEntityList, tempError);
+    if (proxy_->GetBatteryStatsPackedIpc(parcelableEntityList, tempError) != ERR_OK) {
+        // A service without the packed code only answers the legacy one
+        parcelableEntityList.statsList_.clear();
+        proxy_->GetBatteryStatsIpc(parcelableEntityList, tempError);
+    }
     tempError_ = static_cast<StatsError>(tempError);
     return parcelableEntityList.statsList_;
 }
 
+BatteryStatsRecordView BatteryStatsClient::GetBatteryStatsRecords()
+{
+    STATS_HILOGD(COMP_FWK, "Call GetBatteryStatsRecords");
+    BatteryStatsRecordView recordView;
+    if (Connect() != ERR_OK) {
+        lastError_ = StatsError::ERR_CONNECTION_FAIL;
+        return recordView;
+    }
+
+    sptr<Ashmem> statsAshmem;
+    int32_t tempError = INIT_VALUE;
+    proxy_->GetBatteryStatsAshmemIpc(statsAshmem, tempError);
+    tempError_ = static_cast<StatsError>(tempError);
+    if (!recordView.Attach(statsAshmem)) {
+        STATS_HILOGW(COMP_FWK, "Attach battery stats records failed");
+    }
+    return recordView;
+}
+
+BatteryStatsDelta BatteryStatsClient::GetBatteryStatsSince(uint64_t epoch)
+{
+    STATS_HILOGD(COMP_FWK, "Call GetBatteryStatsSince");
+    BatteryStatsDelta delta;
+    if (Connect() != ERR_OK) {
+        lastError_ = StatsError::ERR_CONNECTION_FAIL;
+        return delta;
+    }
+
+    ParcelableBatteryStatsList changed;
+    ParcelableBatteryStatsList removed;
+    int32_t tempError = INIT_VALUE;
+    proxy_->GetBatteryStatsSinceIpc(epoch, changed, removed, delta.epoch, delta.isFull, tempError);
+    tempError_ = static_cast<StatsError>(tempError);
+    delta.changed = std::move(changed.statsList_);
+    delta.removed = std::move(removed.statsList_);
+    return delta;
+}
+
+bool BatteryStatsClient::SubscribeStats(const sptr<IBatteryStatsCallback>& callback, const StatsSubscribeInfo& info)
+{
+    STATS_HILOGD(COMP_FWK, "Call SubscribeStats");
+    if (Connect() != ERR_OK) {
+        lastError_ = StatsError::ERR_CONNECTION_FAIL;
+        return false;
+    }
+
+    int32_t tempError = INIT_VALUE;
+    proxy_->SubscribeStatsIpc(callback, info.uids, info.types, info.minDeltaMah, info.minDeltaPercent,
+        info.minIntervalMs, tempError);
+    tempError_ = static_cast<StatsError>(tempError);
+    return tempError_ == StatsError::ERR_OK;
+}
+
+bool BatteryStatsClient::UnsubscribeStats(const sptr<IBatteryStatsCallback>& callback)
+{
+    STATS_HILOGD(COMP_FWK, "Call UnsubscribeStats");
+    if (Connect() != ERR_OK) {
+        lastError_ = StatsError::ERR_CONNECTION_FAIL;
+        return false;
+    }
+
+    int32_t tempError = INIT_VALUE;
+    proxy_->UnsubscribeStatsIpc(callback, tempError);
+    tempError_ = static_cast<StatsError>(tempError);
+    return tempError_ == StatsError::ERR_OK;
+}
+
 double BatteryStatsClient::GetAppStatsMah(const int32_t& uid)
 {
     STATS_HILOGD(COMP_FWK, "Call GetAppStatsMah");
     double appStatsMah = StatsUtils::DEFAULT_VALUE;
+    CacheKey cacheKey(CacheMethod::APP_STATS_MAH, uid);
+    if (GetCachedValue(cacheKey, appStatsMah)) {
+        tempError_ = StatsError::ERR_OK;
+        return appStatsMah;
+    }
     if (Connect() != ERR_OK) {
         lastError_ = StatsError::ERR_CONNECTION_FAIL;
         return appStatsMah;
@@ -101,6 +192,9 @@ double BatteryStatsClient::GetAppStatsMah(const int32_t& uid)
     int32_t tempError = INIT_VALUE;
     proxy_->GetAppStatsMahIpc(uid, appStatsMah, tempError);
     tempError_ = static_cast<StatsError>(tempError);
+    if (tempError_ == StatsError::ERR_OK) {
+        PutCachedValue(cacheKey, appStatsMah);
+    }
     return appStatsMah;
 }
 
@@ -115,6 +209,11 @@ double BatteryStatsClient::GetAppStatsPercent(const int32_t& uid)
 {
     STATS_HILOGD(COMP_FWK, "Call GetAppStatsPercent");
     double appStatsPercent = StatsUtils::DEFAULT_VALUE;
+    CacheKey cacheKey(CacheMethod::APP_STATS_PERCENT, uid);
+    if (GetCachedValue(cacheKey, appStatsPercent)) {
+        tempError_ = StatsError::ERR_OK;
+        return appStatsPercent;
+    }
     if (Connect() != ERR_OK) {
         lastError_ = StatsError::ERR_CONNECTION_FAIL;
         return appStatsPercent;
@@ -122,6 +221,9 @@ double BatteryStatsClient::GetAppStatsPercent(const int32_t& uid)
     int32_t tempError = INIT_VALUE;
     proxy_->GetAppStatsPercentIpc(uid, appStatsPercent, tempError);
     tempError_ = static_cast<StatsError>(tempError);
+    if (tempError_ == StatsError::ERR_OK) {
+        PutCachedValue(cacheKey, appStatsPercent);
+    }
     return appStatsPercent;
 }
 
@@ -129,6 +231,11 @@ double BatteryStatsClient::GetPartStatsMah(const BatteryStatsInfo::ConsumptionTy
 {
     STATS_HILOGD(COMP_FWK, "Call GetPartStatsMah");
     double partStatsMah = StatsUtils::DEFAULT_VALUE;
+    CacheKey cacheKey(CacheMethod::PART_STATS_MAH, static_cast<int32_t>(type));
+    if (GetCachedValue(cacheKey, partStatsMah)) {
+        tempError_ = StatsError::ERR_OK;
+        return partStatsMah;
+    }
     if (Connect() != ERR_OK) {
         lastError_ = StatsError::ERR_CONNECTION_FAIL;
         return partStatsMah;
@@ -136,6 +243,9 @@ double BatteryStatsClient::GetPartStatsMah(const BatteryStatsInfo::ConsumptionTy
     int32_t tempError = INIT_VALUE;
     proxy_->GetPartStatsMahIpc(static_cast<int32_t>(type), partStatsMah, tempError);
     tempError_ = static_cast<StatsError>(tempError);
+    if (tempError_ == StatsError::ERR_OK) {
+        PutCachedValue(cacheKey, partStatsMah);
+    }
     return partStatsMah;
 }
 
@@ -143,6 +253,11 @@ double BatteryStatsClient::GetPartStatsPercent(const BatteryStatsInfo::Consumpti
 {
     STATS_HILOGD(COMP_FWK, "Call GetPartStatsPercent");
     double partStatsPercent = StatsUtils::DEFAULT_VALUE;
+    CacheKey cacheKey(CacheMethod::PART_STATS_PERCENT, static_cast<int32_t>(type));
+    if (GetCachedValue(cacheKey, partStatsPercent)) {
+        tempError_ = StatsError::ERR_OK;
+        return partStatsPercent;
+    }
     if (Connect() != ERR_OK) {
         lastError_ = StatsError::ERR_CONNECTION_FAIL;
         return partStatsPercent;
@@ -150,9 +265,47 @@ double BatteryStatsClient::GetPartStatsPercent(const BatteryStatsInfo::Consumpti
     int32_t tempError = INIT_VALUE;
     proxy_->GetPartStatsPercentIpc(static_cast<int32_t>(type), partStatsPercent, tempError);
     tempError_ = static_cast<StatsError>(tempError);
+    if (tempError_ == StatsError::ERR_OK) {
+        PutCachedValue(cacheKey, partStatsPercent);
+    }
     return partStatsPercent;
 }
 
+AppStatsBatch BatteryStatsClient::GetAppStatsBatch(const std::vector<int32_t>& uids, uint32_t fieldMask)
+{
+    STATS_HILOGD(COMP_FWK, "Call GetAppStatsBatch");
+    AppStatsBatch batch;
+    if (Connect() != ERR_OK) {
+        lastError_ = StatsError::ERR_CONNECTION_FAIL;
+        return batch;
+    }
+    ParcelableBatteryStatsList breakdown;
+    int32_t tempError = INIT_VALUE;
+    proxy_->GetAppStatsBatchIpc(uids, fieldMask, batch.appStatsMah, batch.appStatsPercent, breakdown, tempError);
+    tempError_ = static_cast<StatsError>(tempError);
+    batch.breakdown = std::move(breakdown.statsList_);
+    return batch;
+}
+
+BatteryStatsInfoList BatteryStatsClient::GetTopConsumers(uint32_t topNum, BatteryStatsInfo::ConsumptionType type,
+    uint64_t& epoch)
+{
+    STATS_HILOGD(COMP_FWK, "Call GetTopConsumers");
+    BatteryStatsInfoList topConsumers;
+    if (Connect() != ERR_OK) {
+        lastError_ = StatsError::ERR_CONNECTION_FAIL;
+        return topConsumers;
+    }
+    ParcelableBatteryStatsList parcelableList;
+    uint64_t currentEpoch = epoch;
+    int32_t tempError = INIT_VALUE;
+    proxy_->GetTopConsumersIpc(topNum, static_cast<int32_t>(type), epoch, parcelableList, currentEpoch, tempError);
+    tempError_ = static_cast<StatsError>(tempError);
+    epoch = currentEpoch;
+    topConsumers = std::move(parcelableList.statsList_);
+    return topConsumers;
+}
+
 void BatteryStatsClient::Reset()
 {
     STATS_HILOGD(COMP_FWK, "Call Reset");
@@ -193,6 +346,78 @@ std::string BatteryStatsClient::Dump(const std::vector<std::string>& args)
     return dumpshell;
 }
 
+void BatteryStatsClient::SetCacheMaxStaleMs(int64_t maxStaleMs)
+{
+    STATS_HILOGD(COMP_FWK, "Call SetCacheMaxStaleMs");
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    cacheMaxStaleMs_ = maxStaleMs > 0 ? maxStaleMs : 0;
+    if (cacheMaxStaleMs_ == 0) {
+        cacheMap_.clear();
+    }
+}
+
+BatteryStatsCacheInfo BatteryStatsClient::GetCacheInfo()
+{
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    return { cacheHitCount_, cacheMissCount_ };
+}
+
+bool BatteryStatsClient::GetCachedValue(const CacheKey& key, double& value)
+{
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    if (cacheMaxStaleMs_ == 0) {
+        return false;
+    }
+    auto iter = cacheMap_.find(key);
+    if (iter != cacheMap_.end() && iter->second.epoch == epochCounter_.Load() &&
+        GetSteadyTimeMs() - iter->second.timeMs <= cacheMaxStaleMs_) {
+        value = iter->second.value;
+        cacheHitCount_++;
+        return true;
+    }
+    cacheMissCount_++;
+    return false;
+}
+
+void BatteryStatsClient::PutCachedValue(const CacheKey& key, double value)
+{
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    // Without the counter an entry could never be validated, so nothing is cached until a reconnect attaches it
+    if (cacheMaxStaleMs_ == 0 || !epochCounter_.IsAttached()) {
+        return;
+    }
+    if (cacheMap_.size() >= CACHE_MAX_ENTRY_NUM && cacheMap_.find(key) == cacheMap_.end()) {
+        cacheMap_.clear();
+    }
+    // Loaded after the call, a pass racing with it only makes the entry look newer within the staleness bound
+    cacheMap_[key] = { epochCounter_.Load(), GetSteadyTimeMs(), value };
+}
+
+void BatteryStatsClient::AttachEpochCounter(const sptr<IBatteryStats>& proxy)
+{
+    // Called once per connection under mutex_, a failure is kept until the proxy is reset
+    if (proxy == nullptr) {
+        return;
+    }
+    sptr<Ashmem> epochAshmem;
+    int32_t tempError = INIT_VALUE;
+    if (proxy->GetComputeEpochAshmemIpc(epochAshmem, tempError) != ERR_OK) {
+        STATS_HILOGW(COMP_FWK, "Get compute epoch ashmem failed");
+        return;
+    }
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    if (!epochCounter_.Attach(epochAshmem)) {
+        STATS_HILOGW(COMP_FWK, "Attach compute epoch counter failed");
+    }
+}
+
+void BatteryStatsClient::ClearCache()
+{
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    cacheMap_.clear();
+    epochCounter_.Detach();
+}
+
 StatsError BatteryStatsClient::GetLastError()
 {
     if (lastError_ != StatsError::ERR_OK) {
@@ -15,12 +15,60 @@
 
 #include "battery_stats_info.h"
 
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "battery_stats_records.h"
 #include "stats_common.h"
 #include "stats_log.h"
 
 namespace OHOS {
 namespace PowerMgr {
 constexpr int32_t PARAM_MAX_NUM = 2000;
+namespace {
+// Stands where a legacy list carries its size, which is never negative, so the first word tells the layouts apart
+constexpr int32_t STATS_LIST_PACKED_TAG = -0x53544c50;
+constexpr int32_t STATS_LIST_PACKED_VERSION = 1;
+
+bool ReadPackedList(Parcel& parcel, BatteryStatsInfoList& statsList)
+{
+    int32_t version = 0;
+    int32_t recordSize = 0;
+    int32_t size = 0;
+    STATS_RETURN_IF_READ_PARCEL_FAILED_WITH_RET(COMP_FWK, parcel, Int32, version, false);
+    STATS_RETURN_IF_READ_PARCEL_FAILED_WITH_RET(COMP_FWK, parcel, Int32, recordSize, false);
+    STATS_RETURN_IF_READ_PARCEL_FAILED_WITH_RET(COMP_FWK, parcel, Int32, size, false);
+    // A newer writer may append fields to each record, only the prefix known here is read
+    if (version < STATS_LIST_PACKED_VERSION || recordSize < static_cast<int32_t>(sizeof(BatteryStatsRecord)) ||
+        size < 0 || size > PARAM_MAX_NUM) {
+        STATS_HILOGE(COMP_FWK, "Invalid packed list, version: %{public}d, record size: %{public}d, size: %{public}d",
+            version, recordSize, size);
+        return false;
+    }
+    if (size == 0) {
+        return true;
+    }
+    const uint8_t* buffer = parcel.ReadBuffer(static_cast<size_t>(size) * static_cast<size_t>(recordSize));
+    if (buffer == nullptr) {
+        STATS_HILOGE(COMP_FWK, "Read packed records failed, size: %{public}d", size);
+        return false;
+    }
+    for (int32_t i = 0; i < size; ++i) {
+        // The parcel only keeps 4 byte alignment, so every record is copied out before the double is read
+        BatteryStatsRecord record;
+        std::memcpy(&record, buffer + static_cast<size_t>(i) * static_cast<size_t>(recordSize), sizeof(record));
+        auto statsInfo = std::make_shared<BatteryStatsInfo>();
+        statsInfo->SetUid(record.uid);
+        statsInfo->SetUserId(record.userId);
+        statsInfo->SetConsumptioType(static_cast<BatteryStatsInfo::ConsumptionType>(record.type));
+        statsInfo->SetPower(record.powerMah);
+        statsList.emplace_back(statsInfo);
+    }
+    return true;
+}
+}
+
 bool BatteryStatsInfo::Marshalling(Parcel& parcel) const
 {
     STATS_RETURN_IF_WRITE_PARCEL_FAILED_WITH_RET(COMP_FWK, parcel, Int32, uid_, false);
@@ -60,7 +108,6 @@ void BatteryStatsInfo::SetUid(int32_t uid)
     if (uid > StatsUtils::INVALID_VALUE) {
         uid_ = uid;
     }
-    STATS_HILOGD(COMP_FWK, "Uid: %{public}d", uid);
 }
 
 void BatteryStatsInfo::SetUserId(int32_t userId)
@@ -68,7 +115,6 @@ void BatteryStatsInfo::SetUserId(int32_t userId)
     if (userId > StatsUtils::INVALID_VALUE) {
         userId_ = userId;
     }
-    STATS_HILOGD(COMP_FWK, "UserId: %{public}d", userId);
 }
 
 void BatteryStatsInfo::SetConsumptioType(ConsumptionType type)
@@ -78,12 +124,6 @@ void BatteryStatsInfo::SetConsumptioType(ConsumptionType type)
 
 void BatteryStatsInfo::SetPower(double power)
 {
-    if (uid_ > StatsUtils::INVALID_VALUE) {
-        STATS_HILOGD(COMP_FWK, "Set APP power: %{public}lfmAh for uid: %{public}d", totalPowerMah_, uid_);
-    } else {
-        STATS_HILOGD(COMP_FWK, "Set power: %{public}lfmAh for part: %{public}s", totalPowerMah_,
-            ConvertConsumptionType(type_).c_str());
-    }
     totalPowerMah_ = power;
 }
 
@@ -104,12 +144,6 @@ BatteryStatsInfo::ConsumptionType BatteryStatsInfo::GetConsumptionType()
 
 double BatteryStatsInfo::GetPower()
 {
-    if (uid_ > StatsUtils::INVALID_VALUE) {
-        STATS_HILOGD(COMP_FWK, "Get app power: %{public}lfmAh for uid: %{public}d", totalPowerMah_, uid_);
-    } else {
-        STATS_HILOGD(COMP_FWK, "Get power: %{public}lfmAh for part: %{public}s", totalPowerMah_,
-            ConvertConsumptionType(type_).c_str());
-    }
     return totalPowerMah_;
 }
 
@@ -212,16 +246,38 @@ std::string BatteryStatsInfo::ConvertConsumptionType(ConsumptionType type)
 
 bool ParcelableBatteryStatsList::Marshalling(Parcel& parcel) const
 {
-    int32_t size = static_cast<int32_t>(statsList_.size());
-    STATS_RETURN_IF_WRITE_PARCEL_FAILED_WITH_RET(COMP_FWK, parcel, Int32, size, false);
-    bool res = true;
+    if (!isPacked_) {
+        // Legacy layout, the size is followed by one uid, type and power per entry
+        int32_t size = static_cast<int32_t>(std::count_if(statsList_.begin(), statsList_.end(),
+            [](const std::shared_ptr<BatteryStatsInfo>& templateVal) { return templateVal != nullptr; }));
+        STATS_RETURN_IF_WRITE_PARCEL_FAILED_WITH_RET(COMP_FWK, parcel, Int32, size, false);
+        for (const auto& templateVal : statsList_) {
+            if (templateVal != nullptr && !templateVal->Marshalling(parcel)) {
+                return false;
+            }
+        }
+        return true;
+    }
+    std::vector<BatteryStatsRecord> records;
+    records.reserve(statsList_.size());
     for (const auto& templateVal : statsList_) {
         if (templateVal == nullptr) {
             continue;
         }
-        res = templateVal->Marshalling(parcel);
+        records.push_back({ templateVal->GetUid(), static_cast<int32_t>(templateVal->GetConsumptionType()),
+            templateVal->GetUserId(), 0, templateVal->GetPower() });
+    }
+    int32_t size = static_cast<int32_t>(records.size());
+    STATS_RETURN_IF_WRITE_PARCEL_FAILED_WITH_RET(COMP_FWK, parcel, Int32, STATS_LIST_PACKED_TAG, false);
+    STATS_RETURN_IF_WRITE_PARCEL_FAILED_WITH_RET(COMP_FWK, parcel, Int32, STATS_LIST_PACKED_VERSION, false);
+    STATS_RETURN_IF_WRITE_PARCEL_FAILED_WITH_RET(COMP_FWK, parcel, Int32,
+        static_cast<int32_t>(sizeof(BatteryStatsRecord)), false);
+    STATS_RETURN_IF_WRITE_PARCEL_FAILED_WITH_RET(COMP_FWK, parcel, Int32, size, false);
+    if (size > 0 && !parcel.WriteBuffer(records.data(), records.size() * sizeof(BatteryStatsRecord))) {
+        STATS_HILOGE(COMP_FWK, "Write packed records failed, size: %{public}d", size);
+        return false;
     }
-    return res;
+    return true;
 }
 
 ParcelableBatteryStatsList* ParcelableBatteryStatsList::Unmarshalling(Parcel& parcel)
@@ -230,6 +286,10 @@ ParcelableBatteryStatsList* ParcelableBatteryStatsList::Unmarshalling(Parcel& pa
     auto listPtr = std::make_unique<ParcelableBatteryStatsList>();
 
     int32_t size = parcel.ReadInt32();
+    if (size == STATS_LIST_PACKED_TAG) {
+        return ReadPackedList(parcel, listPtr->statsList_) ? listPtr.release() : nullptr;
+    }
+    // Legacy layout, the size is followed by one uid, type and power per entry
     if (size < PARAM_ZERO || size > PARAM_MAX_NUM) {
         STATS_HILOGE(COMP_FWK, "size is invalid, size=%{public}d", size);
         return nullptr;
@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "battery_stats_records.h"
+
+#include <new>
+#include <sys/mman.h>
+#include <vector>
+
+#include "stats_log.h"
+
+namespace OHOS {
+namespace PowerMgr {
+namespace {
+const char* STATS_RECORDS_ASHMEM_NAME = "BatteryStatsRecords";
+const char* STATS_EPOCH_ASHMEM_NAME = "BatteryStatsEpoch";
+}
+
+sptr<Ashmem> BatteryStatsRecordView::Pack(const BatteryStatsInfoList& statsInfoList)
+{
+    std::vector<BatteryStatsRecord> records;
+    records.reserve(statsInfoList.size());
+    for (const auto& statsInfo : statsInfoList) {
+        if (statsInfo == nullptr || records.size() >= MAX_RECORD_NUM) {
+            continue;
+        }
+        records.push_back({ statsInfo->GetUid(), static_cast<int32_t>(statsInfo->GetConsumptionType()),
+            statsInfo->GetUserId(), 0, statsInfo->GetPower() });
+    }
+    BatteryStatsRecordsHeader header = { STATS_RECORDS_MAGIC, STATS_RECORDS_VERSION,
+        static_cast<uint16_t>(sizeof(BatteryStatsRecord)), static_cast<uint32_t>(records.size()), 0 };
+    int32_t recordsLength = static_cast<int32_t>(records.size() * sizeof(BatteryStatsRecord));
+    int32_t length = static_cast<int32_t>(sizeof(header)) + recordsLength;
+
+    sptr<Ashmem> ashmem = Ashmem::CreateAshmem(STATS_RECORDS_ASHMEM_NAME, length);
+    if (ashmem == nullptr) {
+        STATS_HILOGE(COMP_FWK, "Create stats records ashmem failed, length: %{public}d", length);
+        return nullptr;
+    }
+    if (!ashmem->MapReadAndWriteAshmem() ||
+        !ashmem->WriteToAshmem(&header, static_cast<int32_t>(sizeof(header)), 0) ||
+        (recordsLength > 0 &&
+        !ashmem->WriteToAshmem(records.data(), recordsLength, static_cast<int32_t>(sizeof(header))))) {
+        STATS_HILOGE(COMP_FWK, "Write stats records ashmem failed");
+        ashmem->CloseAshmem();
+        return nullptr;
+    }
+    // The receiver only maps the region for reading
+    ashmem->SetProtection(PROT_READ);
+    STATS_HILOGD(COMP_FWK, "Pack %{public}zu stats records", records.size());
+    return ashmem;
+}
+
+bool BatteryStatsRecordView::Attach(const sptr<Ashmem>& ashmem)
+{
+    ashmem_ = nullptr;
+    records_ = nullptr;
+    recordSize_ = 0;
+    recordNum_ = 0;
+    if (ashmem == nullptr || !ashmem->MapReadOnlyAshmem()) {
+        STATS_HILOGW(COMP_FWK, "Map stats records ashmem failed");
+        return false;
+    }
+    int32_t length = ashmem->GetAshmemSize();
+    if (length < static_cast<int32_t>(sizeof(BatteryStatsRecordsHeader))) {
+        STATS_HILOGW(COMP_FWK, "Stats records ashmem is too short, length: %{public}d", length);
+        return false;
+    }
+    auto base = static_cast<const uint8_t*>(ashmem->ReadFromAshmem(length, 0));
+    if (base == nullptr) {
+        return false;
+    }
+    const auto* header = reinterpret_cast<const BatteryStatsRecordsHeader*>(base);
+    size_t recordsLength = static_cast<size_t>(length) - sizeof(BatteryStatsRecordsHeader);
+    if (header->magic != STATS_RECORDS_MAGIC || header->version < STATS_RECORDS_VERSION ||
+        header->recordSize < sizeof(BatteryStatsRecord) || header->recordSize % alignof(BatteryStatsRecord) != 0 ||
+        header->recordNum > MAX_RECORD_NUM ||
+        static_cast<size_t>(header->recordNum) * header->recordSize > recordsLength) {
+        STATS_HILOGW(COMP_FWK, "Invalid stats records header, version: %{public}u, size: %{public}u, num: %{public}u",
+            header->version, header->recordSize, header->recordNum);
+        return false;
+    }
+    ashmem_ = ashmem;
+    records_ = base + sizeof(BatteryStatsRecordsHeader);
+    recordSize_ = header->recordSize;
+    recordNum_ = header->recordNum;
+    return true;
+}
+
+size_t BatteryStatsRecordView::GetSize() const
+{
+    return recordNum_;
+}
+
+const BatteryStatsRecord& BatteryStatsRecordView::operator[](size_t index) const
+{
+    return *reinterpret_cast<const BatteryStatsRecord*>(records_ + index * recordSize_);
+}
+
+bool BatteryStatsEpochCounter::Create()
+{
+    if (ashmem_ != nullptr) {
+        return true;
+    }
+    sptr<Ashmem> ashmem = Ashmem::CreateAshmem(STATS_EPOCH_ASHMEM_NAME, static_cast<int32_t>(sizeof(uint64_t)));
+    if (ashmem == nullptr || !ashmem->MapReadAndWriteAshmem()) {
+        STATS_HILOGE(COMP_FWK, "Create stats epoch ashmem failed");
+        return false;
+    }
+    // ReadFromAshmem hands out the writable mapping as const, this side is the only writer
+    auto base = const_cast<void*>(ashmem->ReadFromAshmem(static_cast<int32_t>(sizeof(uint64_t)), 0));
+    if (base == nullptr) {
+        ashmem->CloseAshmem();
+        return false;
+    }
+    counter_ = new (base) std::atomic<uint64_t>(0);
+    // Mappings made by the receivers are read-only
+    ashmem->SetProtection(PROT_READ);
+    ashmem_ = ashmem;
+    return true;
+}
+
+void BatteryStatsEpochCounter::Publish(uint64_t epoch)
+{
+    if (counter_ != nullptr) {
+        counter_->store(epoch, std::memory_order_release);
+    }
+}
+
+sptr<Ashmem> BatteryStatsEpochCounter::GetAshmem() const
+{
+    return ashmem_;
+}
+
+bool BatteryStatsEpochCounter::Attach(const sptr<Ashmem>& ashmem)
+{
+    Detach();
+    if (ashmem == nullptr || ashmem->GetAshmemSize() < static_cast<int32_t>(sizeof(uint64_t)) ||
+        !ashmem->MapReadOnlyAshmem()) {
+        STATS_HILOGW(COMP_FWK, "Map stats epoch ashmem failed");
+        return false;
+    }
+    auto base = const_cast<void*>(ashmem->ReadFromAshmem(static_cast<int32_t>(sizeof(uint64_t)), 0));
+    if (base == nullptr) {
+        return false;
+    }
+    ashmem_ = ashmem;
+    counter_ = static_cast<std::atomic<uint64_t>*>(base);
+    return true;
+}
+
+void BatteryStatsEpochCounter::Detach()
+{
+    ashmem_ = nullptr;
+    counter_ = nullptr;
+}
+
+bool BatteryStatsEpochCounter::IsAttached() const
+{
+    return counter_ != nullptr;
+}
+
+uint64_t BatteryStatsEpochCounter::Load() const
+{
+    return counter_ != nullptr ? counter_->load(std::memory_order_acquire) : 0;
+}
+} // namespace PowerMgr
+} // namespace OHOS
@@ -16,15 +16,20 @@
 #ifndef BATTERY_STATS_CLIENT_H
 #define BATTERY_STATS_CLIENT_H
 
+#include <map>
 #include <memory>
 #include <mutex>
 #include <singleton.h>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "iremote_object.h"
 
+#include "battery_stats_callback_stub.h"
 #include "battery_stats_errors.h"
 #include "battery_stats_info.h"
+#include "battery_stats_records.h"
 #include "ibattery_stats.h"
 #include "stats_utils.h"
 
@@ -36,16 +41,33 @@ class BatteryStatsClient final : public DelayedRefSingleton<BatteryStatsClient>
 public:
     DISALLOW_COPY_AND_MOVE(BatteryStatsClient);
     BatteryStatsInfoList GetBatteryStats();
+    // Same records as GetBatteryStats, read in place from shared memory instead of unmarshalled one by one
+    BatteryStatsRecordView GetBatteryStatsRecords();
+    // Entries changed since the epoch of an earlier result, epoch 0 asks for everything
+    BatteryStatsDelta GetBatteryStatsSince(uint64_t epoch);
     void SetOnBattery(bool isOnBattery);
     double GetAppStatsMah(const int32_t& uid);
     double GetAppStatsPercent(const int32_t& uid);
     double GetPartStatsMah(const BatteryStatsInfo::ConsumptionType& type);
     double GetPartStatsPercent(const BatteryStatsInfo::ConsumptionType& type);
+    AppStatsBatch GetAppStatsBatch(const std::vector<int32_t>& uids, uint32_t fieldMask = APP_STATS_FIELD_ALL);
+    // Type CONSUMPTION_TYPE_INVALID ranks all consumers but users, whose rows sum their apps. Epoch 0 asks for a
+    // fresh compute, the epoch the result belongs to is written back and passing it again reads the same snapshot
+    // while no newer one exists.
+    BatteryStatsInfoList GetTopConsumers(uint32_t topNum, BatteryStatsInfo::ConsumptionType type, uint64_t& epoch);
+    // Changes crossing the thresholds are pushed to the callback after a compute pass, at most once per interval
+    bool SubscribeStats(const sptr<IBatteryStatsCallback>& callback, const StatsSubscribeInfo& info);
+    bool UnsubscribeStats(const sptr<IBatteryStatsCallback>& callback);
     uint64_t GetTotalTimeSecond(const StatsUtils::StatsType& statsType, const int32_t& uid = StatsUtils::INVALID_VALUE);
     uint64_t GetTotalDataBytes(const StatsUtils::StatsType& statsType, const int32_t& uid = StatsUtils::INVALID_VALUE);
     void Reset();
     std::string Dump(const std::vector<std::string>& args);
+    // The error of the last call made on the calling thread, so concurrent callers never read each other's
     StatsError GetLastError();
+    // Opt-in cache of the app and part power getters. A result is reused while no compute pass has run in the
+    // service since it was fetched and it is at most maxStaleMs old, zero turns the cache off.
+    void SetCacheMaxStaleMs(int64_t maxStaleMs);
+    BatteryStatsCacheInfo GetCacheInfo();
 
 #ifndef STATS_SERVICE_DEATH_UT
 private:
@@ -59,13 +81,37 @@ private:
         DISALLOW_COPY_AND_MOVE(BatteryStatsDeathRecipient);
     };
 
+    enum class CacheMethod : int32_t {
+        APP_STATS_MAH = 0,
+        APP_STATS_PERCENT,
+        PART_STATS_MAH,
+        PART_STATS_PERCENT
+    };
+    using CacheKey = std::pair<CacheMethod, int32_t>;
+    struct CacheEntry {
+        uint64_t epoch = 0;
+        int64_t timeMs = 0;
+        double value = 0.0;
+    };
+    static constexpr size_t CACHE_MAX_ENTRY_NUM = 1000;
+
     ErrCode Connect();
-    StatsError lastError_ {StatsError::ERR_OK};
-    StatsError tempError_ {StatsError::ERR_OK};
+    bool GetCachedValue(const CacheKey& key, double& value);
+    void PutCachedValue(const CacheKey& key, double value);
+    void AttachEpochCounter(const sptr<IBatteryStats>& proxy);
+    void ClearCache();
+    static thread_local StatsError lastError_;
+    static thread_local StatsError tempError_;
     sptr<IBatteryStats> proxy_ {nullptr};
     sptr<IRemoteObject::DeathRecipient> deathRecipient_ {nullptr};
     void ResetProxy(const wptr<IRemoteObject>& remote);
     std::mutex mutex_;
+    std::mutex cacheMutex_;
+    std::map<CacheKey, CacheEntry> cacheMap_;
+    BatteryStatsEpochCounter epochCounter_;
+    int64_t cacheMaxStaleMs_ = 0;
+    uint64_t cacheHitCount_ = 0;
+    uint64_t cacheMissCount_ = 0;
 };
 } // namespace PowerMgr
 } // namespace OHOS
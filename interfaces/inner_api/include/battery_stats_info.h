@@ -20,6 +20,7 @@
 #include <memory>
 #include <parcel.h>
 #include <string>
+#include <vector>
 
 #include "stats_utils.h"
 
@@ -69,9 +70,51 @@ private:
 };
 using BatteryStatsInfoList = std::list<std::shared_ptr<BatteryStatsInfo>>;
 
+// Fields of an app stats batch query, combined as a bit mask
+enum AppStatsField : uint32_t {
+    APP_STATS_FIELD_MAH = 1 << 0,
+    APP_STATS_FIELD_PERCENT = 1 << 1,
+    APP_STATS_FIELD_BREAKDOWN = 1 << 2,
+    APP_STATS_FIELD_ALL = APP_STATS_FIELD_MAH | APP_STATS_FIELD_PERCENT | APP_STATS_FIELD_BREAKDOWN
+};
+
+struct AppStatsBatch {
+    // Aligned with the queried uids, empty when the field is not requested
+    std::vector<double> appStatsMah;
+    std::vector<double> appStatsPercent;
+    // Non-zero consumption of each queried uid per hardware component, the type names the component
+    BatteryStatsInfoList breakdown;
+};
+
+struct BatteryStatsCacheInfo {
+    uint64_t hitCount = 0;
+    uint64_t missCount = 0;
+};
+
+struct BatteryStatsDelta {
+    // Entries new or with a different power since the queried epoch, or every entry when isFull is set
+    BatteryStatsInfoList changed;
+    // Entries gone since the queried epoch, only the identifying fields are meaningful
+    BatteryStatsInfoList removed;
+    uint64_t epoch = 0;
+    bool isFull = false;
+};
+
+struct StatsSubscribeInfo {
+    // Uids and ConsumptionType values to watch, an empty filter matches every entry
+    std::vector<int32_t> uids;
+    std::vector<int32_t> types;
+    // An entry is pushed once its power moved by either amount since the last push, zero for both pushes any change
+    double minDeltaMah = 0.0;
+    double minDeltaPercent = 0.0;
+    int64_t minIntervalMs = 60000;
+};
+
 class ParcelableBatteryStatsList : public Parcelable {
 public:
     BatteryStatsInfoList statsList_;
+    // Written as one buffer of records when set, only readers that know the packed layout may be sent it
+    bool isPacked_ = false;
 
     virtual bool Marshalling(Parcel &parcel) const override;
     static ParcelableBatteryStatsList* Unmarshalling(Parcel &parcel);
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef BATTERY_STATS_RECORDS_H
+#define BATTERY_STATS_RECORDS_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include <ashmem.h>
+#include <refbase.h>
+
+#include "battery_stats_info.h"
+
+namespace OHOS {
+namespace PowerMgr {
+constexpr uint32_t STATS_RECORDS_MAGIC = 0x42535453;
+constexpr uint16_t STATS_RECORDS_VERSION = 1;
+
+struct BatteryStatsRecordsHeader {
+    uint32_t magic;
+    uint16_t version;
+    // Stride of one record, a newer writer may append fields and a reader only uses the prefix it knows
+    uint16_t recordSize;
+    uint32_t recordNum;
+    uint32_t reserved;
+};
+
+struct BatteryStatsRecord {
+    int32_t uid;
+    int32_t type;
+    int32_t userId;
+    int32_t reserved;
+    double powerMah;
+};
+
+static_assert(sizeof(BatteryStatsRecordsHeader) == 16, "Stats records header layout is shared over IPC");
+static_assert(sizeof(BatteryStatsRecord) == 24, "Stats record layout is shared over IPC");
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "Compute epoch is shared across processes");
+
+/**
+ * Read-only view of battery stats records packed into anonymous shared memory.
+ * Records are read in place from the mapping, which lives as long as the view.
+ */
+class BatteryStatsRecordView {
+public:
+    static constexpr uint32_t MAX_RECORD_NUM = 100000;
+
+    BatteryStatsRecordView() = default;
+    ~BatteryStatsRecordView() = default;
+    static sptr<Ashmem> Pack(const BatteryStatsInfoList& statsInfoList);
+    bool Attach(const sptr<Ashmem>& ashmem);
+    size_t GetSize() const;
+    const BatteryStatsRecord& operator[](size_t index) const;
+private:
+    sptr<Ashmem> ashmem_;
+    const uint8_t* records_ = nullptr;
+    size_t recordSize_ = 0;
+    size_t recordNum_ = 0;
+};
+
+/**
+ * Compute epoch published in anonymous shared memory.
+ * The service stores the epoch after every compute pass, clients map the region
+ * read-only and load it to tell whether a result they hold is still current.
+ */
+class BatteryStatsEpochCounter {
+public:
+    BatteryStatsEpochCounter() = default;
+    ~BatteryStatsEpochCounter() = default;
+    bool Create();
+    void Publish(uint64_t epoch);
+    sptr<Ashmem> GetAshmem() const;
+    bool Attach(const sptr<Ashmem>& ashmem);
+    void Detach();
+    bool IsAttached() const;
+    // Zero when nothing is mapped, a published epoch never is
+    uint64_t Load() const;
+private:
+    sptr<Ashmem> ashmem_;
+    std::atomic<uint64_t>* counter_ = nullptr;
+};
+} // namespace PowerMgr
+} // namespace OHOS
+#endif // BATTERY_STATS_RECORDS_H
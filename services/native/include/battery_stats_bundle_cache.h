@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef BATTERY_STATS_BUNDLE_CACHE_H
+#define BATTERY_STATS_BUNDLE_CACHE_H
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace OHOS {
+namespace PowerMgr {
+/**
+ * Caches the bundle name of each uid for dumps.
+ * Missing names are resolved in batches with one bundle manager proxy and no lock held.
+ * Uids the bundle manager does not know are kept apart for UNRESOLVED_TTL_MS, so native uids are not
+ * looked up on every dump. Both are dropped when a package is added or removed under the uid, and the
+ * whole cache is cleared when the bundle manager restarts.
+ */
+class BatteryStatsBundleCache {
+public:
+    BatteryStatsBundleCache() = default;
+    ~BatteryStatsBundleCache() = default;
+    void Prefetch(const std::vector<int32_t>& uids);
+    std::string GetBundleName(int32_t uid);
+    // Never resolves, a name that is not cached reads as unknown, so it is safe under other locks
+    std::string PeekBundleName(int32_t uid);
+    void Invalidate(int32_t uid);
+    void Clear();
+    uint64_t GetHitCount();
+    uint64_t GetMissCount();
+    void DumpInfo(std::string& result);
+    static constexpr int64_t UNRESOLVED_TTL_MS = 10 * 60 * 1000;
+#ifndef STATS_SERVICE_UT_TEST
+private:
+#endif
+    // Returns false when the bundle manager could not be asked, then no uid is known to be unresolved
+    static bool ResolveBundleNames(const std::vector<int32_t>& uids,
+        std::unordered_map<int32_t, std::string>& bundleNames);
+    bool IsUnresolvedLocked(int32_t uid, int64_t nowMs);
+    void StoreLocked(const std::vector<int32_t>& uids, const std::unordered_map<int32_t, std::string>& bundleNames,
+        bool isAnswered);
+    std::mutex mutex_;
+    std::unordered_map<int32_t, std::string> bundleNameMap_;
+    // Boot time of the lookup that did not resolve the uid
+    std::unordered_map<int32_t, int64_t> unresolvedMap_;
+    // Bumped on every invalidation, a batch resolved across one is not stored
+    uint64_t generation_ = 0;
+    uint64_t hitCount_ = 0;
+    uint64_t missCount_ = 0;
+};
+} // namespace PowerMgr
+} // namespace OHOS
+#endif // BATTERY_STATS_BUNDLE_CACHE_H
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef BATTERY_STATS_COALESCER_H
+#define BATTERY_STATS_COALESCER_H
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+
+#include "stats_utils.h"
+
+namespace OHOS {
+namespace AppExecFwk {
+class EventHandler;
+} // namespace AppExecFwk
+
+namespace PowerMgr {
+/**
+ * Drops state events that would not change any timer at ingest time.
+ * The last applied state is kept per (type, uid, level) key, so the key must
+ * mirror how the core keys its timers. When a flap window is set, a stop is held
+ * back for the window and dropped together with a restart arriving within it,
+ * otherwise it is applied with the time it was reported at.
+ */
+class BatteryStatsCoalescer {
+public:
+    using ApplyCallback = std::function<void(const StatsUtils::StatsData& data, int64_t timeMs)>;
+    BatteryStatsCoalescer() = default;
+    ~BatteryStatsCoalescer();
+    bool Coalesce(const StatsUtils::StatsData& data);
+    void SetApplyCallback(const ApplyCallback& callback);
+    void SetFlapWindowMs(int64_t windowMs);
+    int64_t GetFlapWindowMs();
+    uint64_t GetSuppressedCount();
+    uint64_t GetMergedFlapCount();
+    void DumpInfo(std::string& result);
+    // Forgets the state of every key of the uid, a held back stop of it is dropped
+    void RemoveUid(int32_t uid);
+    void Reset();
+private:
+    using EventKey = std::tuple<int32_t, int32_t, int32_t>;
+    struct EventState {
+        StatsUtils::StatsState state = StatsUtils::STATS_STATE_INVALID;
+        int16_t level = StatsUtils::INVALID_VALUE;
+    };
+    struct PendingEvent {
+        StatsUtils::StatsData data;
+        int64_t timeMs = StatsUtils::DEFAULT_VALUE;
+        uint64_t sequence = 0;
+    };
+    static bool IsCoalescable(StatsUtils::StatsType type);
+    static EventKey GetEventKey(const StatsUtils::StatsData& data);
+    bool IsRedundant(const EventKey& key, const StatsUtils::StatsData& data);
+    bool DeferStop(const EventKey& key, const StatsUtils::StatsData& data);
+    void FlushPending(const EventKey& key, uint64_t sequence);
+    std::mutex mutex_;
+    std::map<EventKey, EventState> lastStateMap_;
+    std::map<EventKey, PendingEvent> pendingMap_;
+    std::shared_ptr<AppExecFwk::EventHandler> handler_;
+    ApplyCallback applyCallback_;
+    int64_t flapWindowMs_ = 0;
+    uint64_t sequence_ = 0;
+    uint64_t admittedCount_ = 0;
+    uint64_t suppressedCount_ = 0;
+    uint64_t mergedFlapCount_ = 0;
+};
+} // namespace PowerMgr
+} // namespace OHOS
+#endif // BATTERY_STATS_COALESCER_H
@@ -16,34 +16,60 @@
 #ifndef BATTERY_STATS_CORE_H
 #define BATTERY_STATS_CORE_H
 
+#include <atomic>
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <tuple>
 #include <cstdint>
 #include <iosfwd>
+#include <map>
+#include <vector>
 
 #include <cJSON.h>
 
+#include "battery_stats_coalescer.h"
+#include "battery_stats_debug_ring.h"
 #include "battery_stats_info.h"
+#include "battery_stats_records.h"
+#include "battery_stats_user_resolver.h"
 #include "entities/battery_stats_entity.h"
 #include "stats_log.h"
 #include "stats_utils.h"
 
 namespace OHOS {
 namespace PowerMgr {
+class CameraEntity;
+class UidEntity;
+
 class BatteryStatsCore {
 public:
+    using ComputeCallback = std::function<void(const std::vector<std::shared_ptr<BatteryStatsInfo>>& statsInfos,
+        double totalPowerMah, uint64_t epoch)>;
     explicit BatteryStatsCore()
     {
         STATS_HILOGI(COMP_SVC, "BatteryStatsCore instance is created");
     }
     ~BatteryStatsCore() = default;
     void ComputePower();
+    // Take the ticket before waiting on any caller side lock, a pass started after it covers the caller
+    uint64_t GetComputeTicket();
+    void ComputePowerShared(uint64_t ticket);
+    void SetComputeFreshnessMs(int64_t freshnessMs);
+    uint64_t GetComputePassCount();
+    uint64_t GetComputeReusedCount();
     BatteryStatsInfoList GetBatteryStats();
     double GetAppStatsMah(const int32_t& uid);
     double GetAppStatsPercent(const int32_t& uid);
     double GetPartStatsMah(const BatteryStatsInfo::ConsumptionType& type);
     double GetPartStatsPercent(const BatteryStatsInfo::ConsumptionType& type);
+    AppStatsBatch GetAppStatsBatch(const std::vector<int32_t>& uids, uint32_t fieldMask);
+    BatteryStatsInfoList GetTopConsumers(uint32_t topNum, BatteryStatsInfo::ConsumptionType type);
+    uint64_t GetComputeEpoch();
+    sptr<Ashmem> GetComputeEpochAshmem();
+    BatteryStatsDelta GetBatteryStatsSince(uint64_t epoch);
+    void SetComputeCallback(const ComputeCallback& callback);
     int64_t GetTotalTimeMs(StatsUtils::StatsType statsType, int16_t level = StatsUtils::INVALID_VALUE);
     int64_t GetTotalTimeMs(int32_t uid, StatsUtils::StatsType statsType,
         int16_t level = StatsUtils::INVALID_VALUE);
@@ -54,18 +80,51 @@ public:
         const std::string& deviceId = "");
     void UpdateStats(StatsUtils::StatsType statsType, int64_t time, int64_t data,
         int32_t uid = StatsUtils::INVALID_VALUE);
+    // Callers coalesce the events first, the whole batch is applied under the core lock
+    void ApplyBatch(const std::vector<StatsUtils::StatsData>& events);
     std::shared_ptr<BatteryStatsEntity> GetEntity(const BatteryStatsInfo::ConsumptionType& type);
+    int32_t GetUserId(int32_t uid);
+    void RefreshUserMap();
+    void RemoveUid(int32_t uid);
+    // Only forgets the coalesced state of the uid, compute passes call it for compacted uids under the core lock
+    void RemoveCoalescedUid(int32_t uid);
     bool SaveBatteryStatsData();
     bool LoadBatteryStatsData();
     void DumpInfo(std::string& result);
-    void UpdateDebugInfo(const std::string& info);
+    void DumpHistory(std::string& result);
+    // Runs the task under the core lock, so it sees no compute pass or event half applied.
+    // The task must not call core methods that take the lock themselves.
+    void RunLocked(const std::function<void()>& task);
+    bool CoalesceEvent(const StatsUtils::StatsData& data);
+    void SetCoalesceWindowMs(int64_t windowMs);
+    void UpdateDebugInfo(const StatsUtils::StatsData& data);
+    void SetDebugInfoCapacity(size_t capacity);
     void GetDebugInfo(std::string& result);
     void Reset();
     bool Init();
+    // Entries of the rank index kept in order at compute time, also the largest top query served
+    static constexpr uint32_t RANK_INDEX_SORTED_NUM = 100;
+    // Removed entries remembered for delta queries before they are dropped
+    static constexpr size_t DELTA_REMOVED_MAX_NUM = 1000;
 private:
+    static constexpr uint32_t EPOCH_SEED_SHIFT = 20;
+    using DeltaKey = std::tuple<int32_t, int32_t, int32_t>;
+    struct DeltaEntry {
+        std::shared_ptr<BatteryStatsInfo> info;
+        uint64_t changedEpoch = 0;
+        uint64_t seenEpoch = 0;
+        bool isRemoved = false;
+    };
+    // Timer resolved last by the batch being applied, a run of events on it resolves it only once
+    struct BatchTimerCache {
+        const BatteryStatsEntity* entity = nullptr;
+        StatsUtils::StatsType statsType = StatsUtils::STATS_TYPE_INVALID;
+        int32_t uid = StatsUtils::INVALID_VALUE;
+        std::shared_ptr<StatsHelper::ActiveTimer> timer;
+    };
     std::shared_ptr<BatteryStatsEntity> audioEntity_;
     std::shared_ptr<BatteryStatsEntity> bluetoothEntity_;
-    std::shared_ptr<BatteryStatsEntity> cameraEntity_;
+    std::shared_ptr<CameraEntity> cameraEntity_;
     std::shared_ptr<BatteryStatsEntity> cpuEntity_;
     std::shared_ptr<BatteryStatsEntity> flashlightEntity_;
     std::shared_ptr<BatteryStatsEntity> gnssEntity_;
@@ -73,7 +132,7 @@ private:
     std::shared_ptr<BatteryStatsEntity> phoneEntity_;
     std::shared_ptr<BatteryStatsEntity> screenEntity_;
     std::shared_ptr<BatteryStatsEntity> sensorEntity_;
-    std::shared_ptr<BatteryStatsEntity> uidEntity_;
+    std::shared_ptr<UidEntity> uidEntity_;
     std::shared_ptr<BatteryStatsEntity> userEntity_;
     std::shared_ptr<BatteryStatsEntity> wifiEntity_;
     std::shared_ptr<BatteryStatsEntity> wakelockEntity_;
@@ -83,32 +142,66 @@ private:
     int32_t lastBrightnessLevel_ = StatsUtils::INVALID_VALUE;
     int32_t lastCameraUid_ = StatsUtils::INVALID_VALUE;
     std::mutex mutex_;
-    std::string debugInfo_;
+    uint64_t computeEpoch_ = 0;
+    std::vector<std::shared_ptr<BatteryStatsInfo>> rankIndex_;
+    std::map<DeltaKey, DeltaEntry> deltaIndex_;
+    ComputeCallback computeCallback_;
+    BatteryStatsEpochCounter epochCounter_;
+    std::atomic<uint64_t> computePassCount_ {0};
+    std::atomic<uint64_t> eventVersion_ {0};
+    uint64_t computeReusedCount_ = 0;
+    uint64_t lastPassEventVersion_ = 0;
+    int64_t lastPassStartMs_ = 0;
+    int64_t computeFreshnessMs_ = 0;
+    uint64_t deltaHorizonEpoch_ = 1;
+    BatteryStatsDebugRing debugRing_;
+    bool isApplyingBatch_ = false;
+    BatchTimerCache batchTimer_;
+    BatteryStatsCoalescer coalescer_;
+    BatteryStatsUserResolver userResolver_;
+    void ApplyStateStats(StatsUtils::StatsType statsType, StatsUtils::StatsState state, int16_t level, int32_t uid,
+        const std::string& deviceId, int64_t timeMs);
+    void UpdateStateStats(StatsUtils::StatsType statsType, StatsUtils::StatsState state, int16_t level, int32_t uid,
+        const std::string& deviceId, int64_t timeMs);
     void UpdateTimer(std::shared_ptr<BatteryStatsEntity> entity, StatsUtils::StatsType statsType,
-        StatsUtils::StatsState state, int32_t uid = StatsUtils::INVALID_VALUE);
+        StatsUtils::StatsState state, int64_t timeMs, int32_t uid = StatsUtils::INVALID_VALUE);
+    std::shared_ptr<StatsHelper::ActiveTimer> GetOrCreateUidTimer(const std::shared_ptr<BatteryStatsEntity>& entity,
+        StatsUtils::StatsType statsType, int32_t uid);
     void UpdateTimer(std::shared_ptr<BatteryStatsEntity> entity, StatsUtils::StatsType statsType,
         int64_t time, int32_t uid = StatsUtils::INVALID_VALUE);
-    void UpdateCameraTimer(StatsUtils::StatsState state, int32_t uid, const std::string& deviceId);
-    void UpdateScreenTimer(StatsUtils::StatsState state);
-    void UpdateBrightnessTimer(StatsUtils::StatsState state, int16_t level);
+    void UpdateCameraTimer(StatsUtils::StatsState state, int32_t uid, const std::string& deviceId, int64_t timeMs);
+    void UpdateScreenTimer(StatsUtils::StatsState state, int64_t timeMs);
+    void UpdateBrightnessTimer(StatsUtils::StatsState state, int16_t level, int64_t timeMs);
     void UpdateCounter(std::shared_ptr<BatteryStatsEntity> entity, StatsUtils::StatsType statsType,
         int64_t data, int32_t uid = StatsUtils::INVALID_VALUE);
-    void UpdateScreenStats(StatsUtils::StatsType statsType, StatsUtils::StatsState state, int16_t level);
+    void UpdateScreenStats(StatsUtils::StatsType statsType, StatsUtils::StatsState state, int16_t level,
+        int64_t timeMs);
     void UpdateCameraStats(StatsUtils::StatsType statsType, StatsUtils::StatsState state, int32_t uid,
-        const std::string& deviceId);
-    void UpdatePhoneStats(StatsUtils::StatsType statsType, StatsUtils::StatsState state, int16_t level);
-    void UpdateConnectivityStats(StatsUtils::StatsType statsType, StatsUtils::StatsState state, int32_t uid);
-    void UpdateCommonStats(StatsUtils::StatsType statsType, StatsUtils::StatsState state, int32_t uid);
+        const std::string& deviceId, int64_t timeMs);
+    void UpdatePhoneStats(StatsUtils::StatsType statsType, StatsUtils::StatsState state, int16_t level,
+        int64_t timeMs);
+    void UpdateConnectivityStats(StatsUtils::StatsType statsType, StatsUtils::StatsState state, int32_t uid,
+        int64_t timeMs);
+    void UpdateCommonStats(StatsUtils::StatsType statsType, StatsUtils::StatsState state, int32_t uid,
+        int64_t timeMs);
     void CreatePartEntity();
     void CreateAppEntity();
+    // Callers hold the core lock, the per uid power of the entities is rewritten by compute passes
+    void AddAppBreakdown(int32_t uid, BatteryStatsInfoList& breakdown);
+    void UpdateSnapshot();
+    void ComputePowerLocked();
+    void UpdateRankIndex(const BatteryStatsEntity::StatsInfoVector& statsInfos);
+    void UpdateDeltaIndex(const BatteryStatsEntity::StatsInfoVector& statsInfos);
     void UpdateStatsEntity(cJSON* root);
     void SaveForHardware(cJSON* root);
     void SaveForHardwareInternal(cJSON* hardwareObj);
+    void AddLevelTimesArray(cJSON* hardwareObj, const char* name, const std::vector<int64_t>& levelTimesMs);
     void SaveForSoftware(cJSON* root);
     void SaveForSoftwareCommon(cJSON* root, int32_t uid);
     void SaveForSoftwareCommonInternal(cJSON* uidObj, int32_t uid);
     void SaveForSoftwareConnectivity(cJSON* root, int32_t uid);
     void SaveForPower(cJSON* root);
+    static cJSON* GetOrAddObject(cJSON* root, const char* name);
 };
 } // namespace PowerMgr
 } // namespace OHOS
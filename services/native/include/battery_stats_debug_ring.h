@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef BATTERY_STATS_DEBUG_RING_H
+#define BATTERY_STATS_DEBUG_RING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "stats_utils.h"
+
+namespace OHOS {
+namespace PowerMgr {
+/**
+ * Fixed-capacity ring of binary debug event records.
+ * Records are kept raw at ingest time and only formatted to text when dumped,
+ * once full the oldest record is overwritten and counted.
+ * Not thread safe, the owner is responsible for locking.
+ */
+class BatteryStatsDebugRing {
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 512;
+    static constexpr size_t MAX_CAPACITY = 8192;
+    static constexpr size_t NAME_LENGTH = 48;
+    static constexpr size_t DETAIL_LENGTH = 160;
+
+    struct Record {
+        StatsUtils::StatsType type = StatsUtils::STATS_TYPE_INVALID;
+        StatsUtils::StatsState state = StatsUtils::STATS_STATE_INVALID;
+        int64_t bootTimeMs = StatsUtils::DEFAULT_VALUE;
+        int32_t uid = StatsUtils::INVALID_VALUE;
+        int32_t pid = StatsUtils::INVALID_VALUE;
+        int32_t level = StatsUtils::INVALID_VALUE;
+        int32_t eventDataType = StatsUtils::INVALID_VALUE;
+        int32_t eventDataExtra = StatsUtils::INVALID_VALUE;
+        char name[NAME_LENGTH] = {};
+        char detail[DETAIL_LENGTH] = {};
+    };
+
+    explicit BatteryStatsDebugRing(size_t capacity = DEFAULT_CAPACITY);
+    ~BatteryStatsDebugRing() = default;
+    static bool IsRecordable(StatsUtils::StatsType type);
+    void Push(const StatsUtils::StatsData& data, int64_t bootTimeMs);
+    void SetCapacity(size_t capacity);
+    size_t GetCapacity() const;
+    size_t GetSize() const;
+    uint64_t GetOverwrittenCount() const;
+    void Dump(std::string& result) const;
+    void Clear();
+private:
+    std::vector<Record> records_;
+    size_t head_ = 0;
+    size_t size_ = 0;
+    uint64_t overwrittenCount_ = 0;
+    static void CopyText(const std::string& src, char* dest, size_t destLength);
+    static void FormatRecord(const Record& record, std::string& result);
+    static void FormatAdditionalInfo(const Record& record, std::string& result);
+};
+} // namespace PowerMgr
+} // namespace OHOS
+#endif // BATTERY_STATS_DEBUG_RING_H
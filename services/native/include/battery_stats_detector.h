@@ -17,7 +17,9 @@
 #define BATTERY_STATS_DETECTOR_H
 
 #include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
 
 #include "refbase.h"
 
@@ -37,15 +39,11 @@ public:
 private:
     bool IsDurationRelated(StatsUtils::StatsType type);
     bool IsStateRelated(StatsUtils::StatsType type);
-    void HandleDebugInfo(StatsUtils::StatsData data);
-    void HandleThermalInfo(StatsUtils::StatsData data, int64_t bootTimeMs, std::string& debugInfo);
-    void HandleBatteryInfo(StatsUtils::StatsData data, int64_t bootTimeMs, std::string& debugInfo);
-    void HandleDisplayInfo(StatsUtils::StatsData data, int64_t bootTimeMs, std::string& debugInfo);
-    void HandleWakelockInfo(StatsUtils::StatsData data, int64_t bootTimeMs, std::string& debugInfo);
-    void HandleWorkschedulerInfo(StatsUtils::StatsData data, int64_t bootTimeMs, std::string& debugInfo);
-    void HandlePhoneInfo(StatsUtils::StatsData data, int64_t bootTimeMs, std::string& debugInfo);
-    void HandleFlashlightInfo(StatsUtils::StatsData data, int64_t bootTimeMs, std::string& debugInfo);
-    void HandleDistributedSchedulerInfo(StatsUtils::StatsData data, int64_t bootTimeMs, std::string& debugInfo);
+    void DrainPendingEvents();
+    std::mutex mutex_;
+    // Events admitted by the coalescer and waiting for the draining thread
+    std::vector<StatsUtils::StatsData> pendingEvents_;
+    bool isDraining_ = false;
 };
 } // namespace PowerMgr
 } // namespace OHOS
@@ -16,18 +16,51 @@
 #ifndef BATTERY_STATS_DUMPER_H
 #define BATTERY_STATS_DUMPER_H
 
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
 
+#include <refbase.h>
+
+#include "stats_utils.h"
+
 namespace OHOS {
 namespace PowerMgr {
+class BatteryStatsCore;
+class BatteryStatsService;
+
 class BatteryStatsDumper {
 public:
+    enum DumpSection : uint32_t {
+        SECTION_BLUETOOTH = 1 << 0,
+        SECTION_IDLE = 1 << 1,
+        SECTION_RADIO = 1 << 2,
+        SECTION_SCREEN = 1 << 3,
+        SECTION_WIFI = 1 << 4,
+        SECTION_APP = 1 << 5,
+        SECTION_CPU = 1 << 6,
+        SECTION_HISTORY = 1 << 7,
+        SECTION_ALL = (1 << 8) - 1
+    };
+    struct DumpFilter {
+        int32_t uid = StatsUtils::INVALID_VALUE;
+        uint32_t sectionMask = SECTION_ALL;
+        uint32_t topNum = 0;
+    };
     BatteryStatsDumper() = delete;
     ~BatteryStatsDumper() = delete;
 
     static bool Dump(const std::vector<std::string>& args, std::string& result);
+    // Writes the output to the fd in bounded chunks instead of building it in memory first
+    static bool Dump(const std::vector<std::string>& args, int32_t fd);
+    static bool ParseFilter(const std::vector<std::string>& args, DumpFilter& filter);
 private:
+    class DumpWriter;
+    static bool DumpArgs(const std::vector<std::string>& args, DumpWriter& writer);
+    static void DumpStats(const sptr<BatteryStatsService>& bss, const DumpFilter& filter, DumpWriter& writer);
+    static void DumpApps(const std::shared_ptr<BatteryStatsCore>& core, const DumpFilter& filter,
+        DumpWriter& writer);
     static void ShowUsage(std::string& result);
 };
 } // namespace PowerMgr
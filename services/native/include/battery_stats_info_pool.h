@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef BATTERY_STATS_INFO_POOL_H
+#define BATTERY_STATS_INFO_POOL_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "battery_stats_info.h"
+
+namespace OHOS {
+namespace PowerMgr {
+/**
+ * Recycles the stats records produced by each compute pass.
+ * Records are kept per consumption type, since every producer of a type sets the same fields.
+ * A record is only handed out again once the pool holds its last reference, so a list
+ * returned to a caller or kept by an index of the previous pass is never rewritten.
+ * Not thread safe, the owner is responsible for locking.
+ */
+class BatteryStatsInfoPool {
+public:
+    static constexpr size_t MAX_POOL_SIZE = 4096;
+    BatteryStatsInfoPool() = default;
+    ~BatteryStatsInfoPool() = default;
+    // The returned record has the type set, its other fields are stale when reused and must be set by the caller
+    std::shared_ptr<BatteryStatsInfo> Acquire(BatteryStatsInfo::ConsumptionType type);
+    size_t GetSize() const;
+    uint64_t GetCreatedCount() const;
+    uint64_t GetReusedCount() const;
+private:
+    static constexpr size_t TYPE_NUM = -BatteryStatsInfo::CONSUMPTION_TYPE_INVALID;
+    struct Bucket {
+        std::vector<std::shared_ptr<BatteryStatsInfo>> infos;
+        size_t cursor = 0;
+    };
+    std::array<Bucket, TYPE_NUM> buckets_;
+    size_t size_ = 0;
+    uint64_t createdCount_ = 0;
+    uint64_t reusedCount_ = 0;
+};
+} // namespace PowerMgr
+} // namespace OHOS
+#endif // BATTERY_STATS_INFO_POOL_H
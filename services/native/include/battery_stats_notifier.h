@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef BATTERY_STATS_NOTIFIER_H
+#define BATTERY_STATS_NOTIFIER_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "iremote_object.h"
+
+#include "battery_stats_info.h"
+#include "ibattery_stats_callback.h"
+
+namespace OHOS {
+namespace AppExecFwk {
+class EventHandler;
+} // namespace AppExecFwk
+
+namespace PowerMgr {
+/**
+ * Pushes consumption changes to subscribed callbacks.
+ * Subscriptions are evaluated on a worker after each compute pass, and a periodic compute is only
+ * scheduled while at least one subscription exists, so an idle system with no subscriber does no work.
+ */
+class BatteryStatsNotifier : public std::enable_shared_from_this<BatteryStatsNotifier> {
+public:
+    using ComputeTrigger = std::function<void()>;
+    using StatsInfoVector = std::vector<std::shared_ptr<BatteryStatsInfo>>;
+    static constexpr size_t MAX_SUBSCRIPTION_NUM = 64;
+    static constexpr size_t MAX_FILTER_NUM = 1000;
+    static constexpr int64_t MIN_NOTIFY_INTERVAL_MS = 1000;
+    static constexpr int64_t MIN_PERIODIC_COMPUTE_MS = 30000;
+
+    BatteryStatsNotifier() = default;
+    ~BatteryStatsNotifier();
+    void SetComputeTrigger(const ComputeTrigger& trigger);
+    bool Subscribe(const sptr<IBatteryStatsCallback>& callback, const StatsSubscribeInfo& info);
+    bool Unsubscribe(const sptr<IBatteryStatsCallback>& callback);
+    bool HasSubscription() const;
+    void OnComputed(const StatsInfoVector& statsInfos, double totalPowerMah, uint64_t epoch);
+    void DumpInfo(std::string& result);
+private:
+    class CallbackDeathRecipient : public IRemoteObject::DeathRecipient {
+    public:
+        explicit CallbackDeathRecipient(const std::weak_ptr<BatteryStatsNotifier>& notifier) : notifier_(notifier) {}
+        ~CallbackDeathRecipient() = default;
+        void OnRemoteDied(const wptr<IRemoteObject>& remote) override;
+    private:
+        std::weak_ptr<BatteryStatsNotifier> notifier_;
+    };
+    using EntryKey = std::tuple<int32_t, int32_t, int32_t>;
+    struct Subscription {
+        sptr<IBatteryStatsCallback> callback;
+        std::set<int32_t> uids;
+        std::set<int32_t> types;
+        double minDeltaMah = 0.0;
+        double minDeltaPercent = 0.0;
+        int64_t minIntervalMs = MIN_NOTIFY_INTERVAL_MS;
+        int64_t lastNotifyMs = 0;
+        uint64_t notifyCount = 0;
+        // Power last pushed per entry, deltas keep adding up against it until they cross a threshold
+        std::map<EntryKey, double> notifiedPowerMap;
+    };
+    static bool IsMatched(const Subscription& subscription, const std::shared_ptr<BatteryStatsInfo>& info);
+    static bool IsOverThreshold(const Subscription& subscription, double delta, double totalPowerMah);
+    void Evaluate(const StatsInfoVector& statsInfos, double totalPowerMah, uint64_t epoch);
+    void EvaluateSubscription(Subscription& subscription, const StatsInfoVector& statsInfos,
+        double totalPowerMah, uint64_t epoch, int64_t nowMs);
+    void RemoveSubscription(const sptr<IRemoteObject>& remote);
+    void SchedulePeriodicCompute();
+    void PeriodicCompute();
+    bool EnsureHandler();
+    std::mutex mutex_;
+    std::map<sptr<IRemoteObject>, Subscription> subscriptionMap_;
+    std::atomic_bool hasSubscription_ {false};
+    sptr<IRemoteObject::DeathRecipient> deathRecipient_;
+    std::shared_ptr<AppExecFwk::EventHandler> handler_;
+    ComputeTrigger computeTrigger_;
+};
+} // namespace PowerMgr
+} // namespace OHOS
+#endif // BATTERY_STATS_NOTIFIER_H
@@ -21,10 +21,12 @@
 #include "hisysevent_listener.h"
 #include "system_ability.h"
 
+#include "battery_stats_bundle_cache.h"
 #include "battery_stats_core.h"
 #include "battery_stats_detector.h"
 #include "battery_stats_errors.h"
 #include "battery_stats_info.h"
+#include "battery_stats_notifier.h"
 #include "battery_stats_parser.h"
 #include "battery_stats_stub.h"
 
@@ -54,12 +56,33 @@ public:
     int32_t GetTotalDataBytesIpc(int32_t statsType, int32_t uid, uint64_t& totalDataBytes) override;
     int32_t ResetIpc() override;
     int32_t ShellDumpIpc(const std::vector<std::string>& args, uint32_t argc, std::string& dumpShell) override;
+    int32_t GetAppStatsBatchIpc(const std::vector<int32_t>& uids, uint32_t fieldMask,
+        std::vector<double>& appStatsMah, std::vector<double>& appStatsPercent,
+        ParcelableBatteryStatsList& breakdown, int32_t& tempError) override;
+    int32_t GetTopConsumersIpc(uint32_t topNum, int32_t type, uint64_t epoch,
+        ParcelableBatteryStatsList& topConsumers, uint64_t& currentEpoch, int32_t& tempError) override;
+    int32_t GetBatteryStatsAshmemIpc(sptr<Ashmem>& statsAshmem, int32_t& tempError) override;
+    int32_t GetBatteryStatsSinceIpc(uint64_t epoch, ParcelableBatteryStatsList& changed,
+        ParcelableBatteryStatsList& removed, uint64_t& currentEpoch, bool& isFull, int32_t& tempError) override;
+    int32_t SubscribeStatsIpc(const sptr<IBatteryStatsCallback>& callback, const std::vector<int32_t>& uids,
+        const std::vector<int32_t>& types, double minDeltaMah, double minDeltaPercent, int64_t minIntervalMs,
+        int32_t& tempError) override;
+    int32_t UnsubscribeStatsIpc(const sptr<IBatteryStatsCallback>& callback, int32_t& tempError) override;
+    int32_t GetComputeEpochAshmemIpc(sptr<Ashmem>& epochAshmem, int32_t& tempError) override;
+    int32_t GetBatteryStatsPackedIpc(ParcelableBatteryStatsList& batteryStats, int32_t& tempError) override;
 
     BatteryStatsInfoList GetBatteryStats();
+    sptr<Ashmem> GetBatteryStatsAshmem();
+    sptr<Ashmem> GetComputeEpochAshmem();
+    BatteryStatsDelta GetBatteryStatsSince(uint64_t epoch);
     double GetAppStatsMah(const int32_t& uid);
     double GetAppStatsPercent(const int32_t& uid);
     double GetPartStatsMah(const BatteryStatsInfo::ConsumptionType& type);
     double GetPartStatsPercent(const BatteryStatsInfo::ConsumptionType& type);
+    AppStatsBatch GetAppStatsBatch(const std::vector<int32_t>& uids, uint32_t fieldMask);
+    BatteryStatsInfoList GetTopConsumers(uint32_t topNum, BatteryStatsInfo::ConsumptionType type, uint64_t& epoch);
+    bool SubscribeStats(const sptr<IBatteryStatsCallback>& callback, const StatsSubscribeInfo& info);
+    bool UnsubscribeStats(const sptr<IBatteryStatsCallback>& callback);
     uint64_t GetTotalTimeSecond(const StatsUtils::StatsType& statsType, const int32_t& uid = StatsUtils::INVALID_VALUE);
     uint64_t GetTotalDataBytes(const StatsUtils::StatsType& statsType, const int32_t& uid = StatsUtils::INVALID_VALUE);
     void Reset();
@@ -68,6 +91,8 @@ public:
     std::shared_ptr<BatteryStatsCore> GetBatteryStatsCore() const;
     std::shared_ptr<BatteryStatsParser> GetBatteryStatsParser() const;
     std::shared_ptr<BatteryStatsDetector> GetBatteryStatsDetector() const;
+    std::shared_ptr<BatteryStatsNotifier> GetBatteryStatsNotifier() const;
+    std::shared_ptr<BatteryStatsBundleCache> GetBatteryStatsBundleCache() const;
 
     static sptr<BatteryStatsService> GetInstance();
     static void DestroyInstance();
@@ -76,10 +101,15 @@ public:
 private:
 #endif
     static constexpr int32_t DEPENDENCY_CHECK_DELAY_MS = 2000;
+    static constexpr size_t APP_STATS_BATCH_MAX_UIDS = 1000;
+    // A uid adds up to one breakdown entry per app entity, the reply list must stay within the parcel limit
+    static constexpr size_t APP_STATS_BATCH_MAX_BREAKDOWN_UIDS = 200;
     bool Init();
     std::shared_ptr<BatteryStatsCore> core_;
     std::shared_ptr<BatteryStatsParser> parser_;
     std::shared_ptr<BatteryStatsDetector> detector_;
+    std::shared_ptr<BatteryStatsNotifier> notifier_;
+    std::shared_ptr<BatteryStatsBundleCache> bundleCache_;
     std::shared_ptr<EventFwk::CommonEventSubscriber> subscriberPtr_;
     std::shared_ptr<HiviewDFX::HiSysEventListener> listenerPtr_;
     bool ready_ = false;
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef BATTERY_STATS_UID_SLAB_H
+#define BATTERY_STATS_UID_SLAB_H
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "stats_helper.h"
+#include "stats_utils.h"
+
+namespace OHOS {
+namespace PowerMgr {
+/**
+ * Keeps the timers and counters of one uid in a single row shared by all app entities.
+ * A row is found through a dense uid index and a slot is picked by a compile-time enum.
+ * Rows never move and are recycled once their last slot is released, so the returned
+ * pointers do not own the timer and stay valid for the lifetime of the slab.
+ * A returned pointer may only be held while the core lock is, slots are released under
+ * the same lock, so a recycled row is never reached through a pointer of its last uid.
+ */
+class BatteryStatsUidSlab {
+public:
+    enum TimerSlot : uint32_t {
+        TIMER_AUDIO_ON = 0,
+        TIMER_FLASHLIGHT_ON,
+        TIMER_GNSS_ON,
+        TIMER_SENSOR_GRAVITY_ON,
+        TIMER_SENSOR_PROXIMITY_ON,
+        TIMER_WAKELOCK_HOLD,
+        TIMER_BLUETOOTH_BR_SCAN,
+        TIMER_BLUETOOTH_BLE_SCAN,
+        TIMER_SLOT_NUM
+    };
+    enum CounterSlot : uint32_t {
+        COUNTER_ALARM = 0,
+        COUNTER_SLOT_NUM
+    };
+    BatteryStatsUidSlab() = default;
+    ~BatteryStatsUidSlab() = default;
+    std::shared_ptr<StatsHelper::ActiveTimer> GetOrCreateTimer(int32_t uid, TimerSlot slot);
+    std::shared_ptr<StatsHelper::Counter> GetOrCreateCounter(int32_t uid, CounterSlot slot);
+    // Returns nullptr when the slot was never created for the uid
+    StatsHelper::ActiveTimer* GetTimer(int32_t uid, TimerSlot slot);
+    StatsHelper::Counter* GetCounter(int32_t uid, CounterSlot slot);
+    size_t ReleaseTimer(int32_t uid, TimerSlot slot);
+    size_t ReleaseCounter(int32_t uid, CounterSlot slot);
+    void ResetTimers(TimerSlot slot);
+    void ResetCounters(CounterSlot slot);
+    // Whether a timer of the uid is running or a counter of it is not zero
+    bool IsRowActive(int32_t uid);
+    size_t GetRowNum();
+private:
+    struct Row {
+        int32_t uid = StatsUtils::INVALID_VALUE;
+        uint32_t timerMask = 0;
+        uint32_t counterMask = 0;
+        StatsHelper::ActiveTimer timers[TIMER_SLOT_NUM];
+        StatsHelper::Counter counters[COUNTER_SLOT_NUM];
+    };
+    Row* FindRowLocked(int32_t uid);
+    Row& GetOrCreateRowLocked(int32_t uid);
+    void ReleaseRowLocked(Row& row);
+    std::mutex mutex_;
+    std::deque<Row> rows_;
+    std::vector<uint32_t> freeRows_;
+    std::unordered_map<int32_t, uint32_t> indexMap_;
+    // The entities of one uid are computed back to back, so the last row found is looked up first
+    Row* lastRow_ = nullptr;
+};
+} // namespace PowerMgr
+} // namespace OHOS
+#endif // BATTERY_STATS_UID_SLAB_H
@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef BATTERY_STATS_USER_RESOLVER_H
+#define BATTERY_STATS_USER_RESOLVER_H
+
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+
+namespace OHOS {
+namespace PowerMgr {
+/**
+ * Maps a uid to the user owning it without calling the account service on the compute path.
+ * Uids of the standard layout carry the user id in their range, other uids are looked up once
+ * and kept in a flat map until the users change.
+ */
+class BatteryStatsUserResolver {
+public:
+    static constexpr int32_t UID_RANGE_PER_USER = 200000;
+    BatteryStatsUserResolver() = default;
+    ~BatteryStatsUserResolver() = default;
+    int32_t GetUserId(int32_t uid);
+    void Refresh();
+    size_t GetCachedNum();
+private:
+    std::mutex mutex_;
+    std::unordered_map<int32_t, int32_t> userMap_;
+};
+} // namespace PowerMgr
+} // namespace OHOS
+#endif // BATTERY_STATS_USER_RESOLVER_H
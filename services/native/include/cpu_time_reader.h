@@ -32,6 +32,7 @@ public:
     bool UpdateCpuTime();
     std::vector<int64_t> GetUidCpuTimeMs(int32_t uid);
     void DumpInfo(std::string& result, int32_t uid);
+    size_t RemoveUid(int32_t uid);
 
 private:
     uint32_t wakelockCounts_ = 0;
@@ -32,10 +32,10 @@ public:
     double GetStatsPowerMah(StatsUtils::StatsType statsType, int32_t uid = StatsUtils::INVALID_VALUE) override;
     std::shared_ptr<StatsHelper::Counter> GetOrCreateCounter(StatsUtils::StatsType statsType,
         int32_t uid = StatsUtils::INVALID_VALUE) override;
+    size_t RemoveUid(int32_t uid) override;
     void Reset() override;
 private:
-    std::map<int32_t, std::shared_ptr<StatsHelper::Counter>> alarmCounterMap_;
-    std::map<int32_t, double> alarmPowerMap_;
+    std::map<int32_t, int64_t> alarmEnergyMap_;
 };
 } // namespace PowerMgr
 } // namespace OHOS
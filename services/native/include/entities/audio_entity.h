@@ -34,10 +34,10 @@ public:
     double GetStatsPowerMah(StatsUtils::StatsType statsType, int32_t uid = StatsUtils::INVALID_VALUE) override;
     std::shared_ptr<StatsHelper::ActiveTimer> GetOrCreateTimer(int32_t uid, StatsUtils::StatsType statsType,
         int16_t level = StatsUtils::INVALID_VALUE) override;
+    size_t RemoveUid(int32_t uid) override;
     void Reset() override;
 private:
-    std::map<int32_t, std::shared_ptr<StatsHelper::ActiveTimer>> audioTimerMap_;
-    std::map<int32_t, double> audioPowerMap_;
+    std::map<int32_t, int64_t> audioEnergyMap_;
 };
 } // namespace PowerMgr
 } // namespace OHOS
@@ -23,19 +23,26 @@
 #include "stats_utils.h"
 #include "stats_helper.h"
 #include "battery_stats_info.h"
+#include "battery_stats_info_pool.h"
+#include "battery_stats_uid_slab.h"
 
 namespace OHOS {
 namespace PowerMgr {
 class BatteryStatsEntity {
 public:
+    using StatsInfoVector = std::vector<std::shared_ptr<BatteryStatsInfo>>;
     BatteryStatsEntity() = default;
     virtual ~BatteryStatsEntity() = default;
     virtual double GetEntityPowerMah(int32_t uidOrUserId = StatsUtils::INVALID_VALUE) = 0;
+    // The nAh value the power was converted from, entity powers are kept in nAh so this is exact
+    virtual int64_t GetEntityEnergyNah(int32_t uidOrUserId = StatsUtils::INVALID_VALUE);
     virtual void Reset() = 0;
     virtual void Calculate(int32_t uid = StatsUtils::INVALID_VALUE) = 0;
     virtual int64_t GetActiveTimeMs(StatsUtils::StatsType statsType, int16_t level = StatsUtils::INVALID_VALUE);
     virtual int64_t GetActiveTimeMs(int32_t uid, StatsUtils::StatsType statsType,
         int16_t level = StatsUtils::INVALID_VALUE);
+    // Fills the active time of every level of a leveled timer at one instant, indexed by the level
+    virtual void GetLevelTimesMs(StatsUtils::StatsType statsType, std::vector<int64_t>& levelTimesMs);
     virtual int64_t GetTrafficByte(StatsUtils::StatsType statsType, int32_t uid = StatsUtils::INVALID_VALUE);
     virtual int64_t GetConsumptionCount(StatsUtils::StatsType statsType, int32_t uid = StatsUtils::INVALID_VALUE);
     virtual double GetStatsPowerMah(StatsUtils::StatsType statsType, int32_t uid = StatsUtils::INVALID_VALUE);
@@ -47,20 +54,32 @@ public:
         StatsUtils::StatsType statsType, int16_t level = StatsUtils::INVALID_VALUE);
     virtual std::shared_ptr<StatsHelper::Counter> GetOrCreateCounter(StatsUtils::StatsType statsType,
         int32_t uid = StatsUtils::INVALID_VALUE);
-    virtual void AggregateUserPowerMah(int32_t userId, double power);
+    virtual void AggregateUserEnergyNah(int32_t userId, int64_t energyNah);
     virtual void UpdateUidMap(int32_t uid);
+    virtual void UpdateUidMap(const std::vector<int32_t>& uids);
     virtual int64_t GetCpuTimeMs(int32_t uid);
     virtual void UpdateCpuTime();
+    // Drops the per uid rows of the uid and returns how many were erased
+    virtual size_t RemoveUid(int32_t uid);
+    // Whether a per uid timer kept outside the uid slab is running for the uid
+    virtual bool IsUidActive(int32_t uid);
     virtual std::vector<int32_t> GetUids();
     virtual void DumpInfo(std::string& result, int32_t uid = StatsUtils::INVALID_VALUE);
     BatteryStatsInfo::ConsumptionType GetConsumptionType();
     static double GetTotalPowerMah();
     static void ResetStatsEntity();
     static BatteryStatsInfoList GetStatsInfoList();
+    // Read in place under the core lock, without copying the records into a list
+    static const StatsInfoVector& GetStatsInfos();
+    static const BatteryStatsInfoPool& GetStatsInfoPool();
     static void UpdateStatsInfoList(std::shared_ptr<BatteryStatsInfo> info);
 protected:
-    static double totalPowerMah_;
-    static BatteryStatsInfoList statsInfoList_;
+    static int64_t totalEnergyNah_;
+    // Cleared but not shrunk between passes, the records come from statsInfoPool_
+    static StatsInfoVector statsInfoList_;
+    static BatteryStatsInfoPool statsInfoPool_;
+    // Per uid timers and counters of all app entities
+    static BatteryStatsUidSlab uidSlab_;
     BatteryStatsInfo::ConsumptionType consumptionType_ = BatteryStatsInfo::CONSUMPTION_TYPE_INVALID;
 };
 } // namespace PowerMgr
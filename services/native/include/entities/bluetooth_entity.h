@@ -37,6 +37,7 @@ public:
         int16_t level = StatsUtils::INVALID_VALUE) override;
     double GetEntityPowerMah(int32_t uidOrUserId = StatsUtils::INVALID_VALUE) override;
     double GetStatsPowerMah(StatsUtils::StatsType statsType, int32_t uid = StatsUtils::INVALID_VALUE) override;
+    size_t RemoveUid(int32_t uid) override;
     void Reset() override;
     void DumpInfo(std::string& result, int32_t uid = StatsUtils::INVALID_VALUE) override;
     std::shared_ptr<StatsHelper::ActiveTimer> GetOrCreateTimer(StatsUtils::StatsType statsType,
@@ -45,20 +46,18 @@ public:
         int16_t level = StatsUtils::INVALID_VALUE) override;
 
 private:
-    double GetBluetoothUidPower();
+    int64_t GetBluetoothUidEnergy();
     void CalculateBtPower();
     void CalculateBtPowerForApp(int32_t uid);
-    void UpdateAppBluetoothBlePower(PowerType type, int32_t uid, double powerMah);
-    double bluetoothBrPowerMah_ = StatsUtils::DEFAULT_VALUE;
-    double bluetoothBlePowerMah_ = StatsUtils::DEFAULT_VALUE;
-    double bluetoothPowerMah_ = StatsUtils::DEFAULT_VALUE;
-    std::map<int32_t, double> appBluetoothBrPowerMap_;
-    std::map<int32_t, double> appBluetoothBlePowerMap_;
-    std::map<int32_t, double> appBluetoothPowerMap_;
+    void UpdateAppBluetoothBlePower(PowerType type, int32_t uid, int64_t energyNah);
+    int64_t bluetoothBrEnergyNah_ = StatsUtils::DEFAULT_VALUE;
+    int64_t bluetoothBleEnergyNah_ = StatsUtils::DEFAULT_VALUE;
+    int64_t bluetoothEnergyNah_ = StatsUtils::DEFAULT_VALUE;
+    std::map<int32_t, int64_t> appBluetoothBrEnergyMap_;
+    std::map<int32_t, int64_t> appBluetoothBleEnergyMap_;
+    std::map<int32_t, int64_t> appBluetoothEnergyMap_;
     std::shared_ptr<StatsHelper::ActiveTimer> bluetoothBrOnTimer_;
     std::shared_ptr<StatsHelper::ActiveTimer> bluetoothBleOnTimer_;
-    std::map<int32_t, std::shared_ptr<StatsHelper::ActiveTimer>> appBluetoothBrScanTimerMap_;
-    std::map<int32_t, std::shared_ptr<StatsHelper::ActiveTimer>> appBluetoothBleScanTimerMap_;
 };
 } // namespace PowerMgr
 } // namespace OHOS
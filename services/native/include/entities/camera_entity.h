@@ -16,7 +16,11 @@
 #ifndef CAMERA_ENTITY_H
 #define CAMERA_ENTITY_H
 
+#include <cstdint>
 #include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "entities/battery_stats_entity.h"
 #include "stats_helper.h"
@@ -25,8 +29,11 @@ namespace OHOS {
 namespace PowerMgr {
 class CameraEntity : public BatteryStatsEntity {
 public:
+    static constexpr uint16_t MAX_DEVICE_NUM = 32;
+    static constexpr uint16_t INVALID_DEVICE_INDEX = UINT16_MAX;
     CameraEntity();
     ~CameraEntity() = default;
+    using BatteryStatsEntity::GetOrCreateTimer;
     void Calculate(int32_t uid = StatsUtils::INVALID_VALUE) override;
     int64_t GetActiveTimeMs(int32_t uid, StatsUtils::StatsType statsType,
         int16_t level = StatsUtils::INVALID_VALUE) override;
@@ -34,10 +41,33 @@ public:
     double GetStatsPowerMah(StatsUtils::StatsType statsType, int32_t uid = StatsUtils::INVALID_VALUE) override;
     std::shared_ptr<StatsHelper::ActiveTimer> GetOrCreateTimer(const std::string& deviceId, int32_t uid,
         StatsUtils::StatsType statsType, int16_t level = StatsUtils::INVALID_VALUE) override;
+    static constexpr const char* OVERFLOW_DEVICE_ID = "Overflow";
+    // The same device id always maps to the same index, once MAX_DEVICE_NUM ids are known
+    // the later ones share the index of OVERFLOW_DEVICE_ID, so their time still counts for the uid
+    uint16_t InternDeviceId(const std::string& deviceId);
+    // The returned timer only aliases the entity, it must not be held past the core lock
+    std::shared_ptr<StatsHelper::ActiveTimer> GetOrCreateDeviceTimer(uint16_t deviceIndex, int32_t uid);
+    std::vector<std::string> GetDeviceIds();
+    // Sums over every uid of the device when the uid is invalid
+    int64_t GetDeviceActiveTimeMs(const std::string& deviceId, int32_t uid = StatsUtils::INVALID_VALUE);
+    double GetDevicePowerMah(const std::string& deviceId, int32_t uid = StatsUtils::INVALID_VALUE);
+    // Running timers are kept for the event stopping them, but restarted at the removal time,
+    // since their time so far is already folded into the removed apps power
+    size_t RemoveUid(int32_t uid) override;
+    bool IsUidActive(int32_t uid) override;
+    void DumpInfo(std::string& result, int32_t uid = StatsUtils::INVALID_VALUE) override;
     void Reset() override;
 private:
-    std::map<std::string, std::map<int32_t, std::shared_ptr<StatsHelper::ActiveTimer>>> cameraTimerMap_;
-    std::map<int32_t, double> cameraPowerMap_;
+    using TimerKey = uint64_t;
+    static TimerKey MakeTimerKey(uint32_t deviceIndex, int32_t uid);
+    bool FindDeviceIndex(const std::string& deviceId, uint16_t& deviceIndex);
+    int64_t GetDeviceActiveTimeMs(uint16_t deviceIndex, int32_t uid, int64_t nowMs);
+    // Device ids in intern order, the position of an id is its device index
+    std::vector<std::string> deviceIds_;
+    std::unordered_map<std::string, uint16_t> deviceIndexMap_;
+    // Keyed by (device index, uid), so the timers of one device are contiguous
+    std::map<TimerKey, StatsHelper::ActiveTimer> cameraTimerMap_;
+    std::map<int32_t, int64_t> cameraEnergyMap_;
 };
 } // namespace PowerMgr
 } // namespace OHOS
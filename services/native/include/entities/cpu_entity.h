@@ -32,19 +32,20 @@ public:
     double GetEntityPowerMah(int32_t uidOrUserId = StatsUtils::INVALID_VALUE) override;
     double GetStatsPowerMah(StatsUtils::StatsType statsType, int32_t uid = StatsUtils::INVALID_VALUE) override;
     int64_t GetCpuTimeMs(int32_t uid) override;
+    size_t RemoveUid(int32_t uid) override;
     void Reset() override;
     void DumpInfo(std::string& result, int32_t uid = StatsUtils::INVALID_VALUE) override;
     void UpdateCpuTime() override;
 private:
     std::shared_ptr<CpuTimeReader> cpuReader_;
     std::map<int32_t, int64_t> cpuTimeMap_;
-    std::map<int32_t, double> cpuTotalPowerMap_;
-    std::map<int32_t, double> cpuActivePowerMap_;
-    std::map<int32_t, double> cpuClusterPowerMap_;
-    std::map<int32_t, double> cpuSpeedPowerMap_;
-    double CalculateCpuActivePower(int32_t uid);
-    double CalculateCpuClusterPower(int32_t uid);
-    double CalculateCpuSpeedPower(int32_t uid);
+    std::map<int32_t, int64_t> cpuTotalEnergyMap_;
+    std::map<int32_t, int64_t> cpuActiveEnergyMap_;
+    std::map<int32_t, int64_t> cpuClusterEnergyMap_;
+    std::map<int32_t, int64_t> cpuSpeedEnergyMap_;
+    int64_t CalculateCpuActiveEnergy(int32_t uid);
+    int64_t CalculateCpuClusterEnergy(int32_t uid);
+    int64_t CalculateCpuSpeedEnergy(int32_t uid);
 };
 } // namespace PowerMgr
 } // namespace OHOS
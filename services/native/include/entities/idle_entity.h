@@ -32,11 +32,11 @@ public:
     void Reset() override;
     void DumpInfo(std::string& result, int32_t uid = StatsUtils::INVALID_VALUE) override;
 private:
-    double idleTotalPowerMah_ = StatsUtils::DEFAULT_VALUE;
-    double cpuSuspendPowerMah_ = StatsUtils::DEFAULT_VALUE;
-    double cpuIdlePowerMah_  = StatsUtils::DEFAULT_VALUE;
-    double CalculateCpuSuspendPower();
-    double CalculateCpuIdlePower();
+    int64_t idleTotalEnergyNah_ = StatsUtils::DEFAULT_VALUE;
+    int64_t cpuSuspendEnergyNah_ = StatsUtils::DEFAULT_VALUE;
+    int64_t cpuIdleEnergyNah_  = StatsUtils::DEFAULT_VALUE;
+    int64_t CalculateCpuSuspendEnergy();
+    int64_t CalculateCpuIdleEnergy();
 };
 } // namespace PowerMgr
 } // namespace OHOS
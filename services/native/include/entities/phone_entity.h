@@ -16,7 +16,7 @@
 #ifndef PHONE_ENTITY_H
 #define PHONE_ENTITY_H
 
-#include <map>
+#include <array>
 
 #include "entities/battery_stats_entity.h"
 #include "stats_helper.h"
@@ -35,11 +35,23 @@ public:
         int16_t level = StatsUtils::INVALID_VALUE) override;
     void Reset() override;
     void DumpInfo(std::string& result, int32_t uid = StatsUtils::INVALID_VALUE) override;
+    void GetLevelTimesMs(StatsUtils::StatsType statsType, std::vector<int64_t>& levelTimesMs) override;
 private:
+    // A timer is accepted for the level equal to the bin count as well, it is not part of the power
+    static constexpr size_t SIGNAL_LEVEL_NUM = StatsUtils::RADIO_SIGNAL_BIN + 1;
+    using LevelTimers = std::array<StatsHelper::ActiveTimer, SIGNAL_LEVEL_NUM>;
+    using LevelAverageMa = std::array<double, SIGNAL_LEVEL_NUM>;
     int64_t GetTotalTimeMs(StatsUtils::StatsType statsType);
-    std::map<int32_t, std::shared_ptr<StatsHelper::ActiveTimer>> phoneOnTimerMap_;
-    std::map<int32_t, std::shared_ptr<StatsHelper::ActiveTimer>> phoneDataTimerMap_;
-    double phonePowerMah_ = StatsUtils::DEFAULT_VALUE;
+    LevelTimers* GetLevelTimers(StatsUtils::StatsType statsType);
+    void LoadAverageMa();
+    static int64_t CalculateLevelEnergyNah(LevelTimers& timers, const LevelAverageMa& averageMa, int64_t nowMs);
+    // Indexed by the signal level, every level has its timer from the start
+    LevelTimers phoneOnTimers_;
+    LevelTimers phoneDataTimers_;
+    LevelAverageMa phoneOnAverageMa_ {};
+    LevelAverageMa phoneDataAverageMa_ {};
+    bool isAverageMaLoaded_ = false;
+    int64_t phoneEnergyNah_ = StatsUtils::DEFAULT_VALUE;
 };
 } // namespace PowerMgr
 } // namespace OHOS
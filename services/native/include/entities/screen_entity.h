@@ -16,7 +16,7 @@
 #ifndef SCREEN_ENTITY_H
 #define SCREEN_ENTITY_H
 
-#include <map>
+#include <array>
 
 #include "entities/battery_stats_entity.h"
 
@@ -34,11 +34,17 @@ public:
     void DumpInfo(std::string& result, int32_t uid = StatsUtils::INVALID_VALUE) override;
     std::shared_ptr<StatsHelper::ActiveTimer> GetOrCreateTimer(StatsUtils::StatsType statsType,
         int16_t level = StatsUtils::INVALID_VALUE) override;
+    void GetLevelTimesMs(StatsUtils::StatsType statsType, std::vector<int64_t>& levelTimesMs) override;
 private:
+    static constexpr size_t BRIGHTNESS_LEVEL_NUM = StatsUtils::SCREEN_BRIGHTNESS_BIN + 1;
     int64_t GetBrightnessTotalTimeMs();
-    double screenPowerMah_ = StatsUtils::DEFAULT_VALUE;
+    void LoadAverageMa();
+    int64_t screenEnergyNah_ = StatsUtils::DEFAULT_VALUE;
     std::shared_ptr<StatsHelper::ActiveTimer> screenOnTimer_;
-    std::map<int32_t, std::shared_ptr<StatsHelper::ActiveTimer>> screenBrightnessTimerMap_;
+    // Indexed by the brightness level, every level has its timer from the start
+    std::array<StatsHelper::ActiveTimer, BRIGHTNESS_LEVEL_NUM> brightnessTimers_;
+    std::array<double, BRIGHTNESS_LEVEL_NUM> brightnessAverageMa_ {};
+    bool isAverageMaLoaded_ = false;
 };
 } // namespace PowerMgr
 } // namespace OHOS
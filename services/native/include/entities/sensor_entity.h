@@ -34,15 +34,14 @@ public:
     double GetStatsPowerMah(StatsUtils::StatsType statsType, int32_t uid = StatsUtils::INVALID_VALUE) override;
     std::shared_ptr<StatsHelper::ActiveTimer> GetOrCreateTimer(int32_t uid, StatsUtils::StatsType statsType,
         int16_t level = StatsUtils::INVALID_VALUE) override;
+    size_t RemoveUid(int32_t uid) override;
     void Reset() override;
 private:
-    std::map<int32_t, std::shared_ptr<StatsHelper::ActiveTimer>> gravityTimerMap_;
-    std::map<int32_t, std::shared_ptr<StatsHelper::ActiveTimer>> proximityTimerMap_;
-    std::map<int32_t, double> sensorTotalPowerMap_;
-    std::map<int32_t, double> gravityPowerMap_;
-    std::map<int32_t, double> proximityPowerMap_;
-    double CalculateGravity(int32_t uid);
-    double CalculateProximity(int32_t uid);
+    std::map<int32_t, int64_t> sensorTotalEnergyMap_;
+    std::map<int32_t, int64_t> gravityEnergyMap_;
+    std::map<int32_t, int64_t> proximityEnergyMap_;
+    int64_t CalculateGravity(int32_t uid);
+    int64_t CalculateProximity(int32_t uid);
 };
 } // namespace PowerMgr
 } // namespace OHOS
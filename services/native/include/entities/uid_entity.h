@@ -33,19 +33,40 @@ public:
     double GetStatsPowerMah(StatsUtils::StatsType statsType, int32_t uid = StatsUtils::INVALID_VALUE)
         override;
     void UpdateUidMap(int32_t uid) override;
+    void UpdateUidMap(const std::vector<int32_t>& uids) override;
     std::vector<int32_t> GetUids() override;
     void Reset() override;
     void DumpInfo(std::string& result, int32_t uid = StatsUtils::INVALID_VALUE) override;
+    // Folds the power of the uid into the removed apps bucket and frees its rows in every app entity
+    size_t RemoveUid(int32_t uid) override;
+    // Whether any app entity still runs a timer or holds a count for the uid
+    bool IsUidActive(int32_t uid) override;
+    void DumpLifecycle(std::string& result);
+    // Only reads cached bundle names, callers prefetch them before taking the core lock
+    void DumpForUid(int32_t uid, std::string& result);
+    // How long a uid may stay without any power before its rows are compacted
+    static constexpr int64_t IDLE_COMPACT_MS = 60 * 60 * 1000;
+#ifndef STATS_SERVICE_UT_TEST
 private:
+#endif
+    int64_t idleCompactMs_ = IDLE_COMPACT_MS;
     std::mutex uidEntityMutex_;
-    std::map<int32_t, double> uidPowerMap_;
-    void AddtoStatsList(int32_t uid, double power);
+    std::map<int32_t, int64_t> uidEnergyMap_;
+    // Boot time since which a uid had no power, only idle uids are kept here
+    std::map<int32_t, int64_t> idleSinceMap_;
+    // Energy of removed apps by user id
+    std::map<int32_t, int64_t> removedEnergyMap_;
+    uint64_t compactedUidCount_ = 0;
+    uint64_t freedRowCount_ = 0;
+    size_t RemoveUidLocked(int32_t uid, int64_t energyNah);
+    void AggregateRemovedPower();
+    void AddtoStatsList(int32_t uid, int64_t energyNah);
     double GetPowerForCommon(StatsUtils::StatsType statsType, int32_t uid);
     double GetPowerForConnectivity(StatsUtils::StatsType statsType, int32_t uid);
     void DumpForBluetooth(int32_t uid, std::string& result);
     void DumpForCommon(int32_t uid, std::string& result);
-    double CalculateForConnectivity(int32_t uid);
-    double CalculateForCommon(int32_t uid);
+    int64_t CalculateForConnectivity(int32_t uid);
+    int64_t CalculateForCommon(int32_t uid);
 };
 } // namespace PowerMgr
 } // namespace OHOS
@@ -28,11 +28,11 @@ public:
     UserEntity();
     ~UserEntity() = default;
     double GetEntityPowerMah(int32_t uidOrUserId = StatsUtils::INVALID_VALUE) override;
-    void AggregateUserPowerMah(int32_t userId, double power) override;
+    void AggregateUserEnergyNah(int32_t userId, int64_t energyNah) override;
     void Calculate(int32_t uid = StatsUtils::INVALID_VALUE) override;
     void Reset() override;
 private:
-    std::map<int32_t, double> userPowerMap_;
+    std::map<int32_t, int64_t> userEnergyMap_;
 };
 } // namespace PowerMgr
 } // namespace OHOS
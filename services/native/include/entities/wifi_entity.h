@@ -38,7 +38,7 @@ public:
     void Reset() override;
     void DumpInfo(std::string& result, int32_t uid = StatsUtils::INVALID_VALUE) override;
 private:
-    double wifiPowerMah_ = StatsUtils::DEFAULT_VALUE;
+    int64_t wifiEnergyNah_ = StatsUtils::DEFAULT_VALUE;
     std::shared_ptr<StatsHelper::ActiveTimer> wifiOnTimer_;
     std::shared_ptr<StatsHelper::Counter> wifiScanCounter_;
 };
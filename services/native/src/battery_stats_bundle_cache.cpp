@@ -0,0 +1,208 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "battery_stats_bundle_cache.h"
+
+#ifdef SYS_MGR_CLIENT_ENABLE
+#include <bundle_constants.h>
+#include <bundle_mgr_interface.h>
+#include <ipc_skeleton.h>
+#include <system_ability_definition.h>
+#include <sys_mgr_client.h>
+#endif
+
+#include "stats_helper.h"
+#include "stats_log.h"
+#include "stats_utils.h"
+#include "string_ex.h"
+
+namespace OHOS {
+namespace PowerMgr {
+namespace {
+const std::string UNKNOWN_BUNDLE_NAME = "NULL";
+}
+
+bool BatteryStatsBundleCache::ResolveBundleNames(const std::vector<int32_t>& uids,
+    std::unordered_map<int32_t, std::string>& bundleNames)
+{
+#ifdef SYS_MGR_CLIENT_ENABLE
+    auto bundleObj =
+        DelayedSingleton<AppExecFwk::SysMrgClient>::GetInstance()
+            ->GetSystemAbility(BUNDLE_MGR_SERVICE_SYS_ABILITY_ID);
+    if (bundleObj == nullptr) {
+        STATS_HILOGE(COMP_SVC, "Failed to get bundle manager service");
+        return false;
+    }
+    sptr<AppExecFwk::IBundleMgr> bmgr = iface_cast<AppExecFwk::IBundleMgr>(bundleObj);
+    if (bmgr == nullptr) {
+        STATS_HILOGE(COMP_SVC, "Failed to get bundle manager proxy");
+        return false;
+    }
+    std::string identity = IPCSkeleton::ResetCallingIdentity();
+    for (int32_t uid : uids) {
+        // Only resolved names are returned, the caller remembers the uids left out
+        std::string bundleName;
+        ErrCode res = bmgr->GetNameForUid(uid, bundleName);
+        if (res != ERR_OK || bundleName.empty()) {
+            STATS_HILOGE(COMP_SVC, "Failed to get bundle name for uid=%{public}d, ErrCode=%{public}d",
+                uid, static_cast<int32_t>(res));
+            continue;
+        }
+        bundleNames.emplace(uid, std::move(bundleName));
+    }
+    IPCSkeleton::SetCallingIdentity(identity);
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool BatteryStatsBundleCache::IsUnresolvedLocked(int32_t uid, int64_t nowMs)
+{
+    auto iter = unresolvedMap_.find(uid);
+    if (iter == unresolvedMap_.end()) {
+        return false;
+    }
+    if (nowMs - iter->second < UNRESOLVED_TTL_MS) {
+        return true;
+    }
+    unresolvedMap_.erase(iter);
+    return false;
+}
+
+void BatteryStatsBundleCache::StoreLocked(const std::vector<int32_t>& uids,
+    const std::unordered_map<int32_t, std::string>& bundleNames, bool isAnswered)
+{
+    int64_t nowMs = StatsHelper::GetBootTimeMs();
+    for (int32_t uid : uids) {
+        auto iter = bundleNames.find(uid);
+        if (iter != bundleNames.end()) {
+            bundleNameMap_[uid] = iter->second;
+            unresolvedMap_.erase(uid);
+        } else if (isAnswered) {
+            unresolvedMap_[uid] = nowMs;
+        }
+    }
+}
+
+void BatteryStatsBundleCache::Prefetch(const std::vector<int32_t>& uids)
+{
+    std::vector<int32_t> missingUids;
+    uint64_t generation = 0;
+    {
+        std::lock_guard lock(mutex_);
+        int64_t nowMs = StatsHelper::GetBootTimeMs();
+        for (int32_t uid : uids) {
+            if (bundleNameMap_.find(uid) == bundleNameMap_.end() && !IsUnresolvedLocked(uid, nowMs)) {
+                missingUids.push_back(uid);
+            }
+        }
+        generation = generation_;
+    }
+    if (missingUids.empty()) {
+        return;
+    }
+    std::unordered_map<int32_t, std::string> bundleNames;
+    bool isAnswered = ResolveBundleNames(missingUids, bundleNames);
+    std::lock_guard lock(mutex_);
+    missCount_ += missingUids.size();
+    if (generation != generation_) {
+        return;
+    }
+    StoreLocked(missingUids, bundleNames, isAnswered);
+}
+
+std::string BatteryStatsBundleCache::GetBundleName(int32_t uid)
+{
+    uint64_t generation = 0;
+    {
+        std::lock_guard lock(mutex_);
+        auto iter = bundleNameMap_.find(uid);
+        if (iter != bundleNameMap_.end()) {
+            hitCount_++;
+            return iter->second;
+        }
+        if (IsUnresolvedLocked(uid, StatsHelper::GetBootTimeMs())) {
+            hitCount_++;
+            return UNKNOWN_BUNDLE_NAME;
+        }
+        generation = generation_;
+    }
+    std::unordered_map<int32_t, std::string> bundleNames;
+    bool isAnswered = ResolveBundleNames({ uid }, bundleNames);
+    std::lock_guard lock(mutex_);
+    missCount_++;
+    if (generation == generation_) {
+        StoreLocked({ uid }, bundleNames, isAnswered);
+    }
+    auto iter = bundleNames.find(uid);
+    return iter != bundleNames.end() ? iter->second : UNKNOWN_BUNDLE_NAME;
+}
+
+std::string BatteryStatsBundleCache::PeekBundleName(int32_t uid)
+{
+    std::lock_guard lock(mutex_);
+    auto iter = bundleNameMap_.find(uid);
+    if (iter == bundleNameMap_.end()) {
+        return UNKNOWN_BUNDLE_NAME;
+    }
+    hitCount_++;
+    return iter->second;
+}
+
+void BatteryStatsBundleCache::Invalidate(int32_t uid)
+{
+    std::lock_guard lock(mutex_);
+    bundleNameMap_.erase(uid);
+    unresolvedMap_.erase(uid);
+    generation_++;
+}
+
+void BatteryStatsBundleCache::Clear()
+{
+    std::lock_guard lock(mutex_);
+    bundleNameMap_.clear();
+    unresolvedMap_.clear();
+    generation_++;
+}
+
+uint64_t BatteryStatsBundleCache::GetHitCount()
+{
+    std::lock_guard lock(mutex_);
+    return hitCount_;
+}
+
+uint64_t BatteryStatsBundleCache::GetMissCount()
+{
+    std::lock_guard lock(mutex_);
+    return missCount_;
+}
+
+void BatteryStatsBundleCache::DumpInfo(std::string& result)
+{
+    std::lock_guard lock(mutex_);
+    result.append("Bundle name cache dump:\n")
+        .append("Cached uids: ")
+        .append(ToString(bundleNameMap_.size()))
+        .append(", hits: ")
+        .append(ToString(hitCount_))
+        .append(", misses: ")
+        .append(ToString(missCount_))
+        .append(", unresolved uids: ")
+        .append(ToString(unresolvedMap_.size()))
+        .append("\n");
+}
+} // namespace PowerMgr
+} // namespace OHOS
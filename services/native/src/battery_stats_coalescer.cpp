@@ -0,0 +1,257 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "battery_stats_coalescer.h"
+
+#include <cinttypes>
+
+#include "event_handler.h"
+#include "event_runner.h"
+#include "stats_helper.h"
+#include "stats_log.h"
+#include "string_ex.h"
+
+namespace OHOS {
+namespace PowerMgr {
+namespace {
+const std::string COALESCER_RUNNER_NAME = "BatteryStatsCoalescer";
+const std::string FLAP_FLUSH_TASK_NAME = "BatteryStatsFlapFlush";
+}
+
+BatteryStatsCoalescer::~BatteryStatsCoalescer()
+{
+    if (handler_ != nullptr) {
+        handler_->RemoveTask(FLAP_FLUSH_TASK_NAME);
+    }
+}
+
+bool BatteryStatsCoalescer::IsCoalescable(StatsUtils::StatsType type)
+{
+    bool isMatch = false;
+    switch (type) {
+        // Camera and flashlight timers are also driven by each other, their state is not owned by one key
+        case StatsUtils::STATS_TYPE_SCREEN_ON:
+        case StatsUtils::STATS_TYPE_SCREEN_BRIGHTNESS:
+        case StatsUtils::STATS_TYPE_PHONE_ACTIVE:
+        case StatsUtils::STATS_TYPE_PHONE_DATA:
+        case StatsUtils::STATS_TYPE_BLUETOOTH_BR_ON:
+        case StatsUtils::STATS_TYPE_BLUETOOTH_BLE_ON:
+        case StatsUtils::STATS_TYPE_WIFI_ON:
+        case StatsUtils::STATS_TYPE_BLUETOOTH_BR_SCAN:
+        case StatsUtils::STATS_TYPE_BLUETOOTH_BLE_SCAN:
+        case StatsUtils::STATS_TYPE_GNSS_ON:
+        case StatsUtils::STATS_TYPE_SENSOR_GRAVITY_ON:
+        case StatsUtils::STATS_TYPE_SENSOR_PROXIMITY_ON:
+        case StatsUtils::STATS_TYPE_AUDIO_ON:
+        case StatsUtils::STATS_TYPE_WAKELOCK_HOLD:
+            isMatch = true;
+            break;
+        default:
+            break;
+    }
+    return isMatch;
+}
+
+BatteryStatsCoalescer::EventKey BatteryStatsCoalescer::GetEventKey(const StatsUtils::StatsData& data)
+{
+    int32_t uid = data.uid;
+    int32_t level = StatsUtils::INVALID_VALUE;
+    switch (data.type) {
+        case StatsUtils::STATS_TYPE_PHONE_ACTIVE:
+        case StatsUtils::STATS_TYPE_PHONE_DATA:
+            // Phone timers are kept per signal level
+            uid = StatsUtils::INVALID_VALUE;
+            level = data.level;
+            break;
+        case StatsUtils::STATS_TYPE_SCREEN_ON:
+        case StatsUtils::STATS_TYPE_SCREEN_BRIGHTNESS:
+        case StatsUtils::STATS_TYPE_BLUETOOTH_BR_ON:
+        case StatsUtils::STATS_TYPE_BLUETOOTH_BLE_ON:
+        case StatsUtils::STATS_TYPE_WIFI_ON:
+            // Global timers, the reporting uid does not select a timer
+            uid = StatsUtils::INVALID_VALUE;
+            break;
+        default:
+            break;
+    }
+    return EventKey(static_cast<int32_t>(data.type), uid, level);
+}
+
+bool BatteryStatsCoalescer::IsRedundant(const EventKey& key, const StatsUtils::StatsData& data)
+{
+    auto iter = lastStateMap_.find(key);
+    if (iter == lastStateMap_.end()) {
+        return false;
+    }
+    if (data.type == StatsUtils::STATS_TYPE_SCREEN_BRIGHTNESS) {
+        return iter->second.level == data.level;
+    }
+    return iter->second.state == data.state;
+}
+
+bool BatteryStatsCoalescer::Coalesce(const StatsUtils::StatsData& data)
+{
+    if (!IsCoalescable(data.type)) {
+        return false;
+    }
+    if (data.type != StatsUtils::STATS_TYPE_SCREEN_BRIGHTNESS &&
+        data.state != StatsUtils::STATS_STATE_ACTIVATED && data.state != StatsUtils::STATS_STATE_DEACTIVATED) {
+        return false;
+    }
+    EventKey key = GetEventKey(data);
+    std::lock_guard lock(mutex_);
+    if (IsRedundant(key, data)) {
+        suppressedCount_++;
+        return true;
+    }
+
+    auto pendingIter = pendingMap_.find(key);
+    if (pendingIter != pendingMap_.end() && data.state == StatsUtils::STATS_STATE_ACTIVATED) {
+        // The held back stop and this start cancel out, the timer keeps running
+        pendingMap_.erase(pendingIter);
+        lastStateMap_[key].state = data.state;
+        mergedFlapCount_ += 2;
+        return true;
+    }
+
+    lastStateMap_[key] = { data.state, data.level };
+    if (data.type == StatsUtils::STATS_TYPE_SCREEN_ON) {
+        // Brightness is ignored by the core while the screen is off, so forget the last level
+        lastStateMap_.erase(EventKey(static_cast<int32_t>(StatsUtils::STATS_TYPE_SCREEN_BRIGHTNESS),
+            StatsUtils::INVALID_VALUE, StatsUtils::INVALID_VALUE));
+    }
+    if (data.state == StatsUtils::STATS_STATE_DEACTIVATED && DeferStop(key, data)) {
+        return true;
+    }
+    admittedCount_++;
+    return false;
+}
+
+bool BatteryStatsCoalescer::DeferStop(const EventKey& key, const StatsUtils::StatsData& data)
+{
+    if (flapWindowMs_ <= 0 || handler_ == nullptr || applyCallback_ == nullptr ||
+        data.type == StatsUtils::STATS_TYPE_SCREEN_BRIGHTNESS) {
+        return false;
+    }
+    uint64_t sequence = ++sequence_;
+    // Keep the on battery time of the stop, the timer must not run on for the window
+    pendingMap_[key] = { data, StatsHelper::GetOnBatteryBootTimeMs(), sequence };
+    handler_->PostTask([this, key, sequence]() { FlushPending(key, sequence); },
+        FLAP_FLUSH_TASK_NAME, flapWindowMs_);
+    return true;
+}
+
+void BatteryStatsCoalescer::FlushPending(const EventKey& key, uint64_t sequence)
+{
+    StatsUtils::StatsData data;
+    int64_t timeMs = StatsUtils::DEFAULT_VALUE;
+    ApplyCallback callback;
+    {
+        std::lock_guard lock(mutex_);
+        auto iter = pendingMap_.find(key);
+        if (iter == pendingMap_.end() || iter->second.sequence != sequence) {
+            return;
+        }
+        data = iter->second.data;
+        timeMs = iter->second.timeMs;
+        pendingMap_.erase(iter);
+        callback = applyCallback_;
+        admittedCount_++;
+    }
+    if (callback != nullptr) {
+        callback(data, timeMs);
+    }
+}
+
+void BatteryStatsCoalescer::SetApplyCallback(const ApplyCallback& callback)
+{
+    std::lock_guard lock(mutex_);
+    applyCallback_ = callback;
+}
+
+void BatteryStatsCoalescer::SetFlapWindowMs(int64_t windowMs)
+{
+    std::lock_guard lock(mutex_);
+    flapWindowMs_ = windowMs > 0 ? windowMs : 0;
+    if (flapWindowMs_ > 0 && handler_ == nullptr) {
+        auto runner = AppExecFwk::EventRunner::Create(COALESCER_RUNNER_NAME);
+        if (runner == nullptr) {
+            STATS_HILOGE(COMP_SVC, "Create coalescer runner failed, flap merging is disabled");
+            flapWindowMs_ = 0;
+            return;
+        }
+        handler_ = std::make_shared<AppExecFwk::EventHandler>(runner);
+    }
+    STATS_HILOGI(COMP_SVC, "Set flap window: %{public}" PRId64 "ms", flapWindowMs_);
+}
+
+int64_t BatteryStatsCoalescer::GetFlapWindowMs()
+{
+    std::lock_guard lock(mutex_);
+    return flapWindowMs_;
+}
+
+uint64_t BatteryStatsCoalescer::GetSuppressedCount()
+{
+    std::lock_guard lock(mutex_);
+    return suppressedCount_;
+}
+
+uint64_t BatteryStatsCoalescer::GetMergedFlapCount()
+{
+    std::lock_guard lock(mutex_);
+    return mergedFlapCount_;
+}
+
+void BatteryStatsCoalescer::DumpInfo(std::string& result)
+{
+    std::lock_guard lock(mutex_);
+    result.append("Event coalescer dump:\n")
+        .append("Flap window: ")
+        .append(ToString(flapWindowMs_))
+        .append("ms, admitted: ")
+        .append(ToString(admittedCount_))
+        .append(", suppressed: ")
+        .append(ToString(suppressedCount_))
+        .append(", merged flaps: ")
+        .append(ToString(mergedFlapCount_))
+        .append(", pending stops: ")
+        .append(ToString(pendingMap_.size()))
+        .append("\n");
+}
+
+void BatteryStatsCoalescer::RemoveUid(int32_t uid)
+{
+    std::lock_guard lock(mutex_);
+    auto isUidKey = [uid](const auto& item) { return std::get<1>(item.first) == uid; };
+    for (auto iter = lastStateMap_.begin(); iter != lastStateMap_.end();) {
+        iter = isUidKey(*iter) ? lastStateMap_.erase(iter) : std::next(iter);
+    }
+    for (auto iter = pendingMap_.begin(); iter != pendingMap_.end();) {
+        iter = isUidKey(*iter) ? pendingMap_.erase(iter) : std::next(iter);
+    }
+}
+
+void BatteryStatsCoalescer::Reset()
+{
+    std::lock_guard lock(mutex_);
+    lastStateMap_.clear();
+    pendingMap_.clear();
+    admittedCount_ = 0;
+    suppressedCount_ = 0;
+    mergedFlapCount_ = 0;
+}
+} // namespace PowerMgr
+} // namespace OHOS
@@ -16,9 +16,12 @@
 
 #include <cinttypes>
 #include <cstdio>
+#include <ctime>
 #include <fstream>
+#include <algorithm>
 #include <map>
 #include <functional>
+#include <iterator>
 #include <list>
 #include <utility>
 #include <vector>
@@ -26,7 +29,6 @@
 #include <cJSON.h>
 
 #include "ios"
-#include "ohos_account_kits.h"
 
 #include "battery_info.h"
 #include "battery_srv_client.h"
@@ -55,6 +57,87 @@ namespace OHOS {
 namespace PowerMgr {
 namespace {
 static const std::string BATTERY_STATS_JSON = "/data/service/el0/stats/battery_stats.json";
+const std::string COMPUTE_POWER_TIMER_NAME = "BatteryStatsCoreComputePower";
+
+// Hardware components an app consumption is split into, each backed by an entity keeping per uid power
+const BatteryStatsInfo::ConsumptionType APP_BREAKDOWN_TYPES[] = {
+    BatteryStatsInfo::CONSUMPTION_TYPE_BLUETOOTH,
+    BatteryStatsInfo::CONSUMPTION_TYPE_CAMERA,
+    BatteryStatsInfo::CONSUMPTION_TYPE_FLASHLIGHT,
+    BatteryStatsInfo::CONSUMPTION_TYPE_AUDIO,
+    BatteryStatsInfo::CONSUMPTION_TYPE_SENSOR,
+    BatteryStatsInfo::CONSUMPTION_TYPE_GNSS,
+    BatteryStatsInfo::CONSUMPTION_TYPE_CPU,
+    BatteryStatsInfo::CONSUMPTION_TYPE_WAKELOCK,
+    BatteryStatsInfo::CONSUMPTION_TYPE_ALARM,
+};
+
+enum BatchGroup : int32_t {
+    BATCH_GROUP_SCREEN = 0,
+    BATCH_GROUP_CAMERA,
+    BATCH_GROUP_PHONE,
+    BATCH_GROUP_BLUETOOTH,
+    BATCH_GROUP_WIFI,
+    BATCH_GROUP_GNSS,
+    BATCH_GROUP_SENSOR,
+    BATCH_GROUP_AUDIO,
+    BATCH_GROUP_WAKELOCK,
+    BATCH_GROUP_ALARM,
+    BATCH_GROUP_OTHER,
+};
+
+// Higher power first, ties ordered by type and uid so equal consumers always rank the same way
+bool IsRankedBefore(const std::shared_ptr<BatteryStatsInfo>& lhs, const std::shared_ptr<BatteryStatsInfo>& rhs)
+{
+    if (lhs->GetPower() != rhs->GetPower()) {
+        return lhs->GetPower() > rhs->GetPower();
+    }
+    if (lhs->GetConsumptionType() != rhs->GetConsumptionType()) {
+        return lhs->GetConsumptionType() < rhs->GetConsumptionType();
+    }
+    return lhs->GetUid() < rhs->GetUid();
+}
+
+// Order key of a batched event: entity group first, then uid for groups whose timers are kept per uid.
+// Events sharing a timer or a cross-uid state keep uid 0, so the stable sort leaves their order untouched.
+std::pair<int32_t, int32_t> GetBatchOrderKey(const StatsUtils::StatsData& event)
+{
+    switch (event.type) {
+        case StatsUtils::STATS_TYPE_SCREEN_ON:
+        case StatsUtils::STATS_TYPE_SCREEN_BRIGHTNESS:
+            return { BATCH_GROUP_SCREEN, 0 };
+        case StatsUtils::STATS_TYPE_CAMERA_ON:
+        case StatsUtils::STATS_TYPE_CAMERA_FLASHLIGHT_ON:
+        case StatsUtils::STATS_TYPE_FLASHLIGHT_ON:
+            return { BATCH_GROUP_CAMERA, 0 };
+        case StatsUtils::STATS_TYPE_PHONE_ACTIVE:
+        case StatsUtils::STATS_TYPE_PHONE_DATA:
+            return { BATCH_GROUP_PHONE, 0 };
+        case StatsUtils::STATS_TYPE_BLUETOOTH_BR_ON:
+        case StatsUtils::STATS_TYPE_BLUETOOTH_BLE_ON:
+            return { BATCH_GROUP_BLUETOOTH, 0 };
+        case StatsUtils::STATS_TYPE_BLUETOOTH_BR_SCAN:
+        case StatsUtils::STATS_TYPE_BLUETOOTH_BLE_SCAN:
+            return { BATCH_GROUP_BLUETOOTH, event.uid };
+        case StatsUtils::STATS_TYPE_WIFI_ON:
+            return { BATCH_GROUP_WIFI, 0 };
+        case StatsUtils::STATS_TYPE_WIFI_SCAN:
+            return { BATCH_GROUP_WIFI, event.uid };
+        case StatsUtils::STATS_TYPE_GNSS_ON:
+            return { BATCH_GROUP_GNSS, event.uid };
+        case StatsUtils::STATS_TYPE_SENSOR_GRAVITY_ON:
+        case StatsUtils::STATS_TYPE_SENSOR_PROXIMITY_ON:
+            return { BATCH_GROUP_SENSOR, event.uid };
+        case StatsUtils::STATS_TYPE_AUDIO_ON:
+            return { BATCH_GROUP_AUDIO, event.uid };
+        case StatsUtils::STATS_TYPE_WAKELOCK_HOLD:
+            return { BATCH_GROUP_WAKELOCK, event.uid };
+        case StatsUtils::STATS_TYPE_ALARM:
+            return { BATCH_GROUP_ALARM, event.uid };
+        default:
+            return { BATCH_GROUP_OTHER, 0 };
+    }
+}
 } // namespace
 void BatteryStatsCore::CreatePartEntity()
 {
@@ -129,6 +212,20 @@ bool BatteryStatsCore::Init()
     STATS_HILOGI(COMP_SVC, "Battery stats core init");
     CreateAppEntity();
     CreatePartEntity();
+    {
+        // Seed from the wall clock so epochs handed out before a service restart stay below the new ones
+        std::lock_guard lock(mutex_);
+        computeEpoch_ = static_cast<uint64_t>(std::time(nullptr)) << EPOCH_SEED_SHIFT;
+        deltaHorizonEpoch_ = computeEpoch_ + 1;
+        if (!epochCounter_.Create()) {
+            STATS_HILOGW(COMP_SVC, "Create compute epoch counter failed");
+        }
+        epochCounter_.Publish(computeEpoch_);
+    }
+    coalescer_.SetApplyCallback([this](const StatsUtils::StatsData& data, int64_t timeMs) {
+        ApplyStateStats(data.type, data.state, data.level, data.uid, data.deviceId, timeMs);
+        UpdateDebugInfo(data);
+    });
     auto& batterySrvClient = BatterySrvClient::GetInstance();
     BatteryPluggedType plugType = batterySrvClient.GetPluggedType();
     if (plugType == BatteryPluggedType::PLUGGED_TYPE_NONE || plugType == BatteryPluggedType::PLUGGED_TYPE_BUTT) {
@@ -146,11 +243,60 @@ bool BatteryStatsCore::Init()
 void BatteryStatsCore::ComputePower()
 {
     std::lock_guard lock(mutex_);
+    ComputePowerLocked();
+}
+
+uint64_t BatteryStatsCore::GetComputeTicket()
+{
+    return computePassCount_.load();
+}
+
+void BatteryStatsCore::ComputePowerShared(uint64_t ticket)
+{
+    // Passes run under the lock, so once it is taken no pass is in flight
+    std::lock_guard lock(mutex_);
+    if (computePassCount_.load() > ticket) {
+        computeReusedCount_++;
+        return;
+    }
+    if (computeFreshnessMs_ > 0 && eventVersion_.load() == lastPassEventVersion_ &&
+        StatsHelper::GetBootTimeMs() - lastPassStartMs_ <= computeFreshnessMs_) {
+        computeReusedCount_++;
+        return;
+    }
+    ComputePowerLocked();
+}
+
+void BatteryStatsCore::SetComputeFreshnessMs(int64_t freshnessMs)
+{
+    std::lock_guard lock(mutex_);
+    computeFreshnessMs_ = freshnessMs > 0 ? freshnessMs : 0;
+    STATS_HILOGI(COMP_SVC, "Set compute freshness: %{public}" PRId64 "ms", computeFreshnessMs_);
+}
+
+uint64_t BatteryStatsCore::GetComputePassCount()
+{
+    return computePassCount_.load();
+}
+
+uint64_t BatteryStatsCore::GetComputeReusedCount()
+{
+    std::lock_guard lock(mutex_);
+    return computeReusedCount_;
+}
+
+void BatteryStatsCore::ComputePowerLocked()
+{
     STATS_HILOGD(COMP_SVC, "Calculate battery stats");
+    computePassCount_++;
+    lastPassEventVersion_ = eventVersion_.load();
+    lastPassStartMs_ = StatsHelper::GetBootTimeMs();
     const uint32_t DFX_DELAY_S = 60;
-    int id = HiviewDFX::XCollie::GetInstance().SetTimer("BatteryStatsCoreComputePower", DFX_DELAY_S, nullptr, nullptr,
+    int id = HiviewDFX::XCollie::GetInstance().SetTimer(COMPUTE_POWER_TIMER_NAME, DFX_DELAY_S, nullptr, nullptr,
         HiviewDFX::XCOLLIE_FLAG_LOG);
 
+    // One clock read for the whole pass, every entity is computed at the same instant
+    StatsHelper::ComputeTimeScope timeScope;
     BatteryStatsEntity::ResetStatsEntity();
     uidEntity_->Calculate();
     bluetoothEntity_->Calculate();
@@ -159,6 +305,10 @@ void BatteryStatsCore::ComputePower()
     screenEntity_->Calculate();
     wifiEntity_->Calculate();
     userEntity_->Calculate();
+    UpdateSnapshot();
+    if (computeCallback_ != nullptr) {
+        computeCallback_(rankIndex_, BatteryStatsEntity::GetTotalPowerMah(), computeEpoch_);
+    }
 
     HiviewDFX::XCollie::GetInstance().CancelTimer(id);
 }
@@ -215,6 +365,8 @@ void BatteryStatsCore::UpdateStats(StatsUtils::StatsType statsType, int64_t time
         "Update for duration, statsType: %{public}s, uid: %{public}d, time: %{public}" PRId64 ", "  \
         "data: %{public}" PRId64 "",
         StatsUtils::ConvertStatsType(statsType).c_str(), uid, time, data);
+    std::lock_guard lock(mutex_);
+    eventVersion_++;
     if (uid > StatsUtils::INVALID_VALUE) {
         uidEntity_->UpdateUidMap(uid);
     }
@@ -231,46 +383,98 @@ void BatteryStatsCore::UpdateStats(StatsUtils::StatsType statsType, int64_t time
     }
 }
 
+void BatteryStatsCore::ApplyBatch(const std::vector<StatsUtils::StatsData>& events)
+{
+    if (events.empty()) {
+        return;
+    }
+    eventVersion_++;
+    STATS_HILOGD(COMP_SVC, "Apply batch of %{public}zu events", events.size());
+    std::vector<const StatsUtils::StatsData*> orderedEvents;
+    std::vector<int32_t> uids;
+    orderedEvents.reserve(events.size());
+    uids.reserve(events.size());
+    for (const auto& event : events) {
+        orderedEvents.push_back(&event);
+        if (event.uid > StatsUtils::INVALID_VALUE) {
+            uids.push_back(event.uid);
+        }
+    }
+    std::stable_sort(orderedEvents.begin(), orderedEvents.end(),
+        [](const StatsUtils::StatsData* lhs, const StatsUtils::StatsData* rhs) {
+            return GetBatchOrderKey(*lhs) < GetBatchOrderKey(*rhs);
+        });
+
+    // One lock and one clock read for the whole batch, every timer started or stopped below shares them
+    std::lock_guard lock(mutex_);
+    uidEntity_->UpdateUidMap(uids);
+    int64_t bootTimeMs = StatsHelper::GetBootTimeMs();
+    int64_t timeMs = StatsHelper::GetOnBatteryBootTimeMs(bootTimeMs);
+    isApplyingBatch_ = true;
+    for (const auto* event : orderedEvents) {
+        switch (event->type) {
+            case StatsUtils::STATS_TYPE_WIFI_SCAN:
+                UpdateCounter(wifiEntity_, event->type, event->traffic, event->uid);
+                break;
+            case StatsUtils::STATS_TYPE_ALARM:
+                UpdateCounter(alarmEntity_, event->type, event->traffic, event->uid);
+                break;
+            default:
+                UpdateStateStats(event->type, event->state, event->level, event->uid, event->deviceId, timeMs);
+                break;
+        }
+    }
+    isApplyingBatch_ = false;
+    batchTimer_ = BatchTimerCache();
+
+    for (const auto& event : events) {
+        if (BatteryStatsDebugRing::IsRecordable(event.type)) {
+            debugRing_.Push(event, bootTimeMs);
+        }
+    }
+}
+
 void BatteryStatsCore::UpdateConnectivityStats(StatsUtils::StatsType statsType, StatsUtils::StatsState state,
-    int32_t uid)
+    int32_t uid, int64_t timeMs)
 {
     switch (statsType) {
         case StatsUtils::STATS_TYPE_BLUETOOTH_BR_ON:
         case StatsUtils::STATS_TYPE_BLUETOOTH_BLE_ON:
-            UpdateTimer(bluetoothEntity_, statsType, state);
+            UpdateTimer(bluetoothEntity_, statsType, state, timeMs);
             break;
         case StatsUtils::STATS_TYPE_WIFI_ON:
-            UpdateTimer(wifiEntity_, statsType, state);
+            UpdateTimer(wifiEntity_, statsType, state, timeMs);
             break;
         case StatsUtils::STATS_TYPE_BLUETOOTH_BR_SCAN:
         case StatsUtils::STATS_TYPE_BLUETOOTH_BLE_SCAN:
-            UpdateTimer(bluetoothEntity_, statsType, state, uid);
+            UpdateTimer(bluetoothEntity_, statsType, state, timeMs, uid);
             break;
         default:
             break;
     }
 }
 
-void BatteryStatsCore::UpdateCommonStats(StatsUtils::StatsType statsType, StatsUtils::StatsState state, int32_t uid)
+void BatteryStatsCore::UpdateCommonStats(StatsUtils::StatsType statsType, StatsUtils::StatsState state, int32_t uid,
+    int64_t timeMs)
 {
     switch (statsType) {
         case StatsUtils::STATS_TYPE_FLASHLIGHT_ON:
-            UpdateTimer(flashlightEntity_, statsType, state, uid);
+            UpdateTimer(flashlightEntity_, statsType, state, timeMs, uid);
             break;
         case StatsUtils::STATS_TYPE_GNSS_ON:
-            UpdateTimer(gnssEntity_, statsType, state, uid);
+            UpdateTimer(gnssEntity_, statsType, state, timeMs, uid);
             break;
         case StatsUtils::STATS_TYPE_SENSOR_GRAVITY_ON:
-            UpdateTimer(sensorEntity_, statsType, state, uid);
+            UpdateTimer(sensorEntity_, statsType, state, timeMs, uid);
             break;
         case StatsUtils::STATS_TYPE_SENSOR_PROXIMITY_ON:
-            UpdateTimer(sensorEntity_, statsType, state, uid);
+            UpdateTimer(sensorEntity_, statsType, state, timeMs, uid);
             break;
         case StatsUtils::STATS_TYPE_AUDIO_ON:
-            UpdateTimer(audioEntity_, statsType, state, uid);
+            UpdateTimer(audioEntity_, statsType, state, timeMs, uid);
             break;
         case StatsUtils::STATS_TYPE_WAKELOCK_HOLD:
-            UpdateTimer(wakelockEntity_, statsType, state, uid);
+            UpdateTimer(wakelockEntity_, statsType, state, timeMs, uid);
             break;
         default:
             break;
@@ -284,29 +488,42 @@ void BatteryStatsCore::UpdateStats(StatsUtils::StatsType statsType, StatsUtils::
         "Update for state, statsType: %{public}s, uid: %{public}d, state: %{public}d, level: %{public}d,"   \
         "deviceId: %{private}s",
         StatsUtils::ConvertStatsType(statsType).c_str(), uid, state, level, deviceId.c_str());
+    ApplyStateStats(statsType, state, level, uid, deviceId, StatsHelper::GetOnBatteryBootTimeMs());
+}
+
+void BatteryStatsCore::ApplyStateStats(StatsUtils::StatsType statsType, StatsUtils::StatsState state, int16_t level,
+    int32_t uid, const std::string& deviceId, int64_t timeMs)
+{
+    std::lock_guard lock(mutex_);
+    eventVersion_++;
     if (uid > StatsUtils::INVALID_VALUE) {
         uidEntity_->UpdateUidMap(uid);
     }
+    UpdateStateStats(statsType, state, level, uid, deviceId, timeMs);
+}
 
+void BatteryStatsCore::UpdateStateStats(StatsUtils::StatsType statsType, StatsUtils::StatsState state, int16_t level,
+    int32_t uid, const std::string& deviceId, int64_t timeMs)
+{
     switch (statsType) {
         case StatsUtils::STATS_TYPE_SCREEN_ON:
         case StatsUtils::STATS_TYPE_SCREEN_BRIGHTNESS:
-            UpdateScreenStats(statsType, state, level);
+            UpdateScreenStats(statsType, state, level, timeMs);
             break;
         case StatsUtils::STATS_TYPE_CAMERA_ON:
         case StatsUtils::STATS_TYPE_CAMERA_FLASHLIGHT_ON:
-            UpdateCameraStats(statsType, state, uid, deviceId);
+            UpdateCameraStats(statsType, state, uid, deviceId, timeMs);
             break;
         case StatsUtils::STATS_TYPE_PHONE_ACTIVE:
         case StatsUtils::STATS_TYPE_PHONE_DATA:
-            UpdatePhoneStats(statsType, state, level);
+            UpdatePhoneStats(statsType, state, level, timeMs);
             break;
         case StatsUtils::STATS_TYPE_BLUETOOTH_BR_ON:
         case StatsUtils::STATS_TYPE_BLUETOOTH_BLE_ON:
         case StatsUtils::STATS_TYPE_WIFI_ON:
         case StatsUtils::STATS_TYPE_BLUETOOTH_BR_SCAN:
         case StatsUtils::STATS_TYPE_BLUETOOTH_BLE_SCAN:
-            UpdateConnectivityStats(statsType, state, uid);
+            UpdateConnectivityStats(statsType, state, uid, timeMs);
             break;
         case StatsUtils::STATS_TYPE_FLASHLIGHT_ON:
         case StatsUtils::STATS_TYPE_GNSS_ON:
@@ -314,31 +531,32 @@ void BatteryStatsCore::UpdateStats(StatsUtils::StatsType statsType, StatsUtils::
         case StatsUtils::STATS_TYPE_SENSOR_PROXIMITY_ON:
         case StatsUtils::STATS_TYPE_AUDIO_ON:
         case StatsUtils::STATS_TYPE_WAKELOCK_HOLD:
-            UpdateCommonStats(statsType, state, uid);
+            UpdateCommonStats(statsType, state, uid, timeMs);
             break;
         default:
             break;
     }
 }
 
-void BatteryStatsCore::UpdateScreenStats(StatsUtils::StatsType statsType, StatsUtils::StatsState state, int16_t level)
+void BatteryStatsCore::UpdateScreenStats(StatsUtils::StatsType statsType, StatsUtils::StatsState state, int16_t level,
+    int64_t timeMs)
 {
     STATS_HILOGD(COMP_SVC,
         "statsType: %{public}s, state: %{public}d, level: %{public}d, last brightness level: %{public}d",
         StatsUtils::ConvertStatsType(statsType).c_str(), state, level, lastBrightnessLevel_);
     if (statsType == StatsUtils::STATS_TYPE_SCREEN_ON) {
-        UpdateScreenTimer(state);
+        UpdateScreenTimer(state, timeMs);
     } else if (statsType == StatsUtils::STATS_TYPE_SCREEN_BRIGHTNESS) {
         if (!isScreenOn_) {
             STATS_HILOGD(COMP_SVC, "Screen is off, return");
             return;
         }
-        UpdateBrightnessTimer(state, level);
+        UpdateBrightnessTimer(state, level, timeMs);
     }
 }
 
 void BatteryStatsCore::UpdateCameraStats(StatsUtils::StatsType statsType, StatsUtils::StatsState state,
-    int32_t uid, const std::string& deviceId)
+    int32_t uid, const std::string& deviceId, int64_t timeMs)
 {
     STATS_HILOGD(COMP_SVC, "Camera status: %{public}d, Last camera uid: %{public}d", isCameraOn_, lastCameraUid_);
     if (statsType == StatsUtils::STATS_TYPE_CAMERA_ON) {
@@ -347,24 +565,25 @@ void BatteryStatsCore::UpdateCameraStats(StatsUtils::StatsType statsType, StatsU
                 STATS_HILOGW(COMP_SVC, "Camera is already opened, return");
                 return;
             }
-            UpdateCameraTimer(state, uid, deviceId);
+            UpdateCameraTimer(state, uid, deviceId, timeMs);
         } else if (state == StatsUtils::STATS_STATE_DEACTIVATED) {
             if (!isCameraOn_) {
                 STATS_HILOGW(COMP_SVC, "Camera is off, return");
                 return;
             }
-            UpdateCameraTimer(state, lastCameraUid_, deviceId);
+            UpdateCameraTimer(state, lastCameraUid_, deviceId, timeMs);
         }
     } else if (statsType == StatsUtils::STATS_TYPE_CAMERA_FLASHLIGHT_ON) {
         if (!isCameraOn_) {
             STATS_HILOGW(COMP_SVC, "Camera is off, return");
             return;
         }
-        UpdateTimer(flashlightEntity_, StatsUtils::STATS_TYPE_FLASHLIGHT_ON, state, lastCameraUid_);
+        UpdateTimer(flashlightEntity_, StatsUtils::STATS_TYPE_FLASHLIGHT_ON, state, timeMs, lastCameraUid_);
     }
 }
 
-void BatteryStatsCore::UpdatePhoneStats(StatsUtils::StatsType statsType, StatsUtils::StatsState state, int16_t level)
+void BatteryStatsCore::UpdatePhoneStats(StatsUtils::StatsType statsType, StatsUtils::StatsState state, int16_t level,
+    int64_t timeMs)
 {
     STATS_HILOGD(COMP_SVC, "statsType: %{public}s, state: %{public}d, level: %{public}d",
         StatsUtils::ConvertStatsType(statsType).c_str(), state, level);
@@ -377,10 +596,10 @@ void BatteryStatsCore::UpdatePhoneStats(StatsUtils::StatsType statsType, StatsUt
 
     switch (state) {
         case StatsUtils::STATS_STATE_ACTIVATED:
-            timer->StartRunning();
+            timer->StartRunning(timeMs);
             break;
         case StatsUtils::STATS_STATE_DEACTIVATED:
-            timer->StopRunning();
+            timer->StopRunning(timeMs);
             break;
         default:
             break;
@@ -388,7 +607,7 @@ void BatteryStatsCore::UpdatePhoneStats(StatsUtils::StatsType statsType, StatsUt
 }
 
 void BatteryStatsCore::UpdateTimer(std::shared_ptr<BatteryStatsEntity> entity, StatsUtils::StatsType statsType,
-    StatsUtils::StatsState state, int32_t uid)
+    StatsUtils::StatsState state, int64_t timeMs, int32_t uid)
 {
     STATS_HILOGD(COMP_SVC,
         "entity: %{public}s, statsType: %{public}s, state: %{public}d, uid: %{public}d",
@@ -398,7 +617,7 @@ void BatteryStatsCore::UpdateTimer(std::shared_ptr<BatteryStatsEntity> entity, S
         uid);
     std::shared_ptr<StatsHelper::ActiveTimer> timer;
     if (uid > StatsUtils::INVALID_VALUE) {
-        timer = entity->GetOrCreateTimer(uid, statsType);
+        timer = GetOrCreateUidTimer(entity, statsType, uid);
     } else {
         timer = entity->GetOrCreateTimer(statsType);
     }
@@ -410,16 +629,33 @@ void BatteryStatsCore::UpdateTimer(std::shared_ptr<BatteryStatsEntity> entity, S
 
     switch (state) {
         case StatsUtils::STATS_STATE_ACTIVATED:
-            timer->StartRunning();
+            timer->StartRunning(timeMs);
             break;
         case StatsUtils::STATS_STATE_DEACTIVATED:
-            timer->StopRunning();
+            timer->StopRunning(timeMs);
             break;
         default:
             break;
     }
 }
 
+std::shared_ptr<StatsHelper::ActiveTimer> BatteryStatsCore::GetOrCreateUidTimer(
+    const std::shared_ptr<BatteryStatsEntity>& entity, StatsUtils::StatsType statsType, int32_t uid)
+{
+    if (!isApplyingBatch_) {
+        return entity->GetOrCreateTimer(uid, statsType);
+    }
+    // Batched events are sorted by entity and uid, so repeated events on one timer come back to back
+    if (batchTimer_.timer == nullptr || batchTimer_.entity != entity.get() || batchTimer_.statsType != statsType ||
+        batchTimer_.uid != uid) {
+        batchTimer_.entity = entity.get();
+        batchTimer_.statsType = statsType;
+        batchTimer_.uid = uid;
+        batchTimer_.timer = entity->GetOrCreateTimer(uid, statsType);
+    }
+    return batchTimer_.timer;
+}
+
 void BatteryStatsCore::UpdateTimer(std::shared_ptr<BatteryStatsEntity> entity, StatsUtils::StatsType statsType,
     int64_t time, int32_t uid)
 {
@@ -443,13 +679,16 @@ void BatteryStatsCore::UpdateTimer(std::shared_ptr<BatteryStatsEntity> entity, S
     timer->AddRunningTimeMs(time);
 }
 
-void BatteryStatsCore::UpdateCameraTimer(StatsUtils::StatsState state, int32_t uid, const std::string& deviceId)
+void BatteryStatsCore::UpdateCameraTimer(StatsUtils::StatsState state, int32_t uid, const std::string& deviceId,
+    int64_t timeMs)
 {
     STATS_HILOGD(COMP_SVC, "Camera status: %{public}d, uid: %{public}d, deviceId: %{private}s",
         state, uid, deviceId.c_str());
     std::shared_ptr<StatsHelper::ActiveTimer> timer;
-    if (uid > StatsUtils::INVALID_VALUE && deviceId != "") {
-        timer = cameraEntity_->GetOrCreateTimer(deviceId, uid, StatsUtils::STATS_TYPE_CAMERA_ON);
+    if (uid > StatsUtils::INVALID_VALUE && !deviceId.empty()) {
+        // The id string is only hashed here, timers are kept by its interned index
+        uint16_t deviceIndex = cameraEntity_->InternDeviceId(deviceId);
+        timer = cameraEntity_->GetOrCreateDeviceTimer(deviceIndex, uid);
     } else {
         timer = cameraEntity_->GetOrCreateTimer(StatsUtils::STATS_TYPE_CAMERA_ON);
     }
@@ -461,17 +700,18 @@ void BatteryStatsCore::UpdateCameraTimer(StatsUtils::StatsState state, int32_t u
 
     switch (state) {
         case StatsUtils::STATS_STATE_ACTIVATED: {
-            if (timer->StartRunning()) {
+            if (timer->StartRunning(timeMs)) {
                 isCameraOn_ = true;
                 lastCameraUid_ = uid;
             }
             break;
         }
         case StatsUtils::STATS_STATE_DEACTIVATED: {
-            if (timer->StopRunning()) {
+            if (timer->StopRunning(timeMs)) {
                 UpdateTimer(flashlightEntity_,
                             StatsUtils::STATS_TYPE_FLASHLIGHT_ON,
                             StatsUtils::STATS_STATE_DEACTIVATED,
+                            timeMs,
                             lastCameraUid_);
                 isCameraOn_ = false;
                 lastCameraUid_ = StatsUtils::INVALID_VALUE;
@@ -483,7 +723,7 @@ void BatteryStatsCore::UpdateCameraTimer(StatsUtils::StatsState state, int32_t u
     }
 }
 
-void BatteryStatsCore::UpdateScreenTimer(StatsUtils::StatsState state)
+void BatteryStatsCore::UpdateScreenTimer(StatsUtils::StatsState state, int64_t timeMs)
 {
     std::shared_ptr<StatsHelper::ActiveTimer> screenOnTimer = nullptr;
     std::shared_ptr<StatsHelper::ActiveTimer> brightnessTimer = nullptr;
@@ -494,24 +734,24 @@ void BatteryStatsCore::UpdateScreenTimer(StatsUtils::StatsState state)
     }
     if (state == StatsUtils::STATS_STATE_ACTIVATED) {
         if (screenOnTimer != nullptr) {
-            screenOnTimer->StartRunning();
+            screenOnTimer->StartRunning(timeMs);
         }
         if (brightnessTimer != nullptr) {
-            brightnessTimer->StartRunning();
+            brightnessTimer->StartRunning(timeMs);
         }
         isScreenOn_ = true;
     } else if (state == StatsUtils::STATS_STATE_DEACTIVATED) {
         if (screenOnTimer != nullptr) {
-            screenOnTimer->StopRunning();
+            screenOnTimer->StopRunning(timeMs);
         }
         if (brightnessTimer != nullptr) {
-            brightnessTimer->StopRunning();
+            brightnessTimer->StopRunning(timeMs);
         }
         isScreenOn_ = false;
     }
 }
 
-void BatteryStatsCore::UpdateBrightnessTimer(StatsUtils::StatsState state, int16_t level)
+void BatteryStatsCore::UpdateBrightnessTimer(StatsUtils::StatsState state, int16_t level, int64_t timeMs)
 {
     if (level <= StatsUtils::INVALID_VALUE || level > StatsUtils::SCREEN_BRIGHTNESS_BIN) {
         STATS_HILOGW(COMP_SVC, "Screen brightness level is out of range");
@@ -523,7 +763,7 @@ void BatteryStatsCore::UpdateBrightnessTimer(StatsUtils::StatsState state, int16
         auto brightnessTimer = screenEntity_->GetOrCreateTimer(StatsUtils::STATS_TYPE_SCREEN_BRIGHTNESS,
             level);
         if (brightnessTimer != nullptr) {
-            brightnessTimer->StartRunning();
+            brightnessTimer->StartRunning(timeMs);
         }
     } else if (level != lastBrightnessLevel_) {
         auto oldBrightnessTimer = screenEntity_->GetOrCreateTimer(StatsUtils::STATS_TYPE_SCREEN_BRIGHTNESS,
@@ -532,11 +772,11 @@ void BatteryStatsCore::UpdateBrightnessTimer(StatsUtils::StatsState state, int16
         if (oldBrightnessTimer != nullptr) {
             STATS_HILOGI(COMP_SVC, "Stop screen brightness timer for last level: %{public}d",
                 lastBrightnessLevel_);
-            oldBrightnessTimer->StopRunning();
+            oldBrightnessTimer->StopRunning(timeMs);
         }
         if (newBrightnessTimer != nullptr) {
             STATS_HILOGI(COMP_SVC, "Start screen brightness timer for latest level: %{public}d", level);
-            newBrightnessTimer->StartRunning();
+            newBrightnessTimer->StartRunning(timeMs);
         }
     }
     lastBrightnessLevel_ = level;
@@ -602,6 +842,7 @@ int64_t BatteryStatsCore::GetTotalTimeMs(StatsUtils::StatsType statsType, int16_
 
 void BatteryStatsCore::DumpInfo(std::string& result)
 {
+    StatsHelper::ComputeTimeScope timeScope;
     result.append("BATTERY STATS DUMP:\n");
     result.append("\n");
     if (bluetoothEntity_) {
@@ -628,22 +869,86 @@ void BatteryStatsCore::DumpInfo(std::string& result)
         uidEntity_->DumpInfo(result);
         result.append("\n");
     }
+    DumpHistory(result);
+}
+
+int32_t BatteryStatsCore::GetUserId(int32_t uid)
+{
+    return userResolver_.GetUserId(uid);
+}
+
+void BatteryStatsCore::RefreshUserMap()
+{
+    userResolver_.Refresh();
+}
+
+void BatteryStatsCore::RemoveUid(int32_t uid)
+{
+    if (uid <= StatsUtils::INVALID_VALUE) {
+        return;
+    }
+    coalescer_.RemoveUid(uid);
+    std::lock_guard lock(mutex_);
+    eventVersion_++;
+    StatsHelper::ComputeTimeScope timeScope;
+    uidEntity_->RemoveUid(uid);
+}
+
+void BatteryStatsCore::RemoveCoalescedUid(int32_t uid)
+{
+    coalescer_.RemoveUid(uid);
+}
+
+void BatteryStatsCore::DumpHistory(std::string& result)
+{
+    uidEntity_->DumpLifecycle(result);
+    result.append("\n");
+    coalescer_.DumpInfo(result);
+    result.append("\n");
+    result.append("Compute passes: ")
+        .append(std::to_string(GetComputePassCount()))
+        .append(", reused: ")
+        .append(std::to_string(GetComputeReusedCount()))
+        .append("\n\n");
     GetDebugInfo(result);
 }
 
-void BatteryStatsCore::UpdateDebugInfo(const std::string& info)
+void BatteryStatsCore::RunLocked(const std::function<void()>& task)
 {
     std::lock_guard lock(mutex_);
-    debugInfo_.append(info);
+    task();
+}
+
+bool BatteryStatsCore::CoalesceEvent(const StatsUtils::StatsData& data)
+{
+    return coalescer_.Coalesce(data);
+}
+
+void BatteryStatsCore::SetCoalesceWindowMs(int64_t windowMs)
+{
+    coalescer_.SetFlapWindowMs(windowMs);
+}
+
+void BatteryStatsCore::UpdateDebugInfo(const StatsUtils::StatsData& data)
+{
+    if (!BatteryStatsDebugRing::IsRecordable(data.type)) {
+        return;
+    }
+    int64_t bootTimeMs = StatsHelper::GetBootTimeMs();
+    std::lock_guard lock(mutex_);
+    debugRing_.Push(data, bootTimeMs);
+}
+
+void BatteryStatsCore::SetDebugInfoCapacity(size_t capacity)
+{
+    std::lock_guard lock(mutex_);
+    debugRing_.SetCapacity(capacity);
 }
 
 void BatteryStatsCore::GetDebugInfo(std::string& result)
 {
     std::lock_guard lock(mutex_);
-    if (debugInfo_.size() > 0) {
-        result.append("Misc stats info dump:\n");
-        result.append(debugInfo_);
-    }
+    debugRing_.Dump(result);
 }
 
 int64_t BatteryStatsCore::GetTotalTimeMs(int32_t uid, StatsUtils::StatsType statsType, int16_t level)
@@ -781,9 +1086,200 @@ double BatteryStatsCore::GetPartStatsPercent(const BatteryStatsInfo::Consumption
     return partStatsPercent;
 }
 
+AppStatsBatch BatteryStatsCore::GetAppStatsBatch(const std::vector<int32_t>& uids, uint32_t fieldMask)
+{
+    AppStatsBatch batch;
+    bool needMah = (fieldMask & APP_STATS_FIELD_MAH) != 0;
+    bool needPercent = (fieldMask & APP_STATS_FIELD_PERCENT) != 0;
+    std::map<int32_t, double> appPowerMap;
+    // The totals and the breakdown are read from the same compute pass as the app power
+    std::lock_guard lock(mutex_);
+    if (needMah || needPercent) {
+        // One pass over the stats list instead of one per uid
+        for (const auto& statsInfo : BatteryStatsEntity::GetStatsInfos()) {
+            if (statsInfo->GetConsumptionType() == BatteryStatsInfo::CONSUMPTION_TYPE_APP) {
+                appPowerMap.emplace(statsInfo->GetUid(), statsInfo->GetPower());
+            }
+        }
+    }
+    double totalConsumption = BatteryStatsEntity::GetTotalPowerMah();
+    if (needMah) {
+        batch.appStatsMah.reserve(uids.size());
+    }
+    if (needPercent) {
+        batch.appStatsPercent.reserve(uids.size());
+    }
+    for (auto uid : uids) {
+        auto iter = appPowerMap.find(uid);
+        double power = iter != appPowerMap.end() ? iter->second : StatsUtils::DEFAULT_VALUE;
+        if (needMah) {
+            batch.appStatsMah.push_back(power);
+        }
+        if (needPercent) {
+            batch.appStatsPercent.push_back(
+                totalConsumption > StatsUtils::DEFAULT_VALUE ? power / totalConsumption : StatsUtils::DEFAULT_VALUE);
+        }
+        if ((fieldMask & APP_STATS_FIELD_BREAKDOWN) != 0) {
+            AddAppBreakdown(uid, batch.breakdown);
+        }
+    }
+    STATS_HILOGD(COMP_SVC, "Get app stats batch for %{public}zu uids, field mask: %{public}u", uids.size(), fieldMask);
+    return batch;
+}
+
+void BatteryStatsCore::AddAppBreakdown(int32_t uid, BatteryStatsInfoList& breakdown)
+{
+    if (uid <= StatsUtils::INVALID_VALUE) {
+        return;
+    }
+    for (auto type : APP_BREAKDOWN_TYPES) {
+        auto entity = GetEntity(type);
+        if (entity == nullptr) {
+            continue;
+        }
+        double power = entity->GetEntityPowerMah(uid);
+        if (power <= StatsUtils::DEFAULT_VALUE) {
+            continue;
+        }
+        std::shared_ptr<BatteryStatsInfo> statsInfo = std::make_shared<BatteryStatsInfo>();
+        statsInfo->SetUid(uid);
+        statsInfo->SetConsumptioType(type);
+        statsInfo->SetPower(power);
+        breakdown.push_back(statsInfo);
+    }
+}
+
+void BatteryStatsCore::UpdateSnapshot()
+{
+    computeEpoch_++;
+    const auto& statsInfos = BatteryStatsEntity::GetStatsInfos();
+    UpdateRankIndex(statsInfos);
+    UpdateDeltaIndex(statsInfos);
+    epochCounter_.Publish(computeEpoch_);
+}
+
+void BatteryStatsCore::UpdateRankIndex(const BatteryStatsEntity::StatsInfoVector& statsInfos)
+{
+    rankIndex_.assign(statsInfos.begin(), statsInfos.end());
+    // Only the head is ever read in order, so the tail is just partitioned off instead of sorted
+    auto sortedEnd = rankIndex_.end();
+    if (rankIndex_.size() > RANK_INDEX_SORTED_NUM) {
+        sortedEnd = rankIndex_.begin() + RANK_INDEX_SORTED_NUM;
+        std::nth_element(rankIndex_.begin(), sortedEnd, rankIndex_.end(), IsRankedBefore);
+    }
+    std::sort(rankIndex_.begin(), sortedEnd, IsRankedBefore);
+}
+
+void BatteryStatsCore::SetComputeCallback(const ComputeCallback& callback)
+{
+    std::lock_guard lock(mutex_);
+    computeCallback_ = callback;
+}
+
+BatteryStatsInfoList BatteryStatsCore::GetTopConsumers(uint32_t topNum, BatteryStatsInfo::ConsumptionType type)
+{
+    std::lock_guard lock(mutex_);
+    BatteryStatsInfoList topConsumers;
+    topNum = std::min(topNum, RANK_INDEX_SORTED_NUM);
+    size_t sortedNum = std::min(rankIndex_.size(), static_cast<size_t>(RANK_INDEX_SORTED_NUM));
+    // A user row sums the apps of that user, so ranking it among all types would count the apps twice
+    auto isMatched = [type](const std::shared_ptr<BatteryStatsInfo>& info) {
+        if (type == BatteryStatsInfo::CONSUMPTION_TYPE_INVALID) {
+            return info->GetConsumptionType() != BatteryStatsInfo::CONSUMPTION_TYPE_USER;
+        }
+        return info->GetConsumptionType() == type;
+    };
+    for (size_t i = 0; i < sortedNum && topConsumers.size() < topNum; i++) {
+        if (isMatched(rankIndex_[i])) {
+            topConsumers.push_back(rankIndex_[i]);
+        }
+    }
+    if (topConsumers.size() < topNum && sortedNum < rankIndex_.size()) {
+        // The ordered head held too few entries of the type, the rest ranks below all of it
+        std::vector<std::shared_ptr<BatteryStatsInfo>> candidates;
+        std::copy_if(rankIndex_.begin() + sortedNum, rankIndex_.end(), std::back_inserter(candidates), isMatched);
+        size_t needNum = std::min(candidates.size(), static_cast<size_t>(topNum) - topConsumers.size());
+        std::partial_sort(candidates.begin(), candidates.begin() + needNum, candidates.end(), IsRankedBefore);
+        topConsumers.insert(topConsumers.end(), candidates.begin(), candidates.begin() + needNum);
+    }
+    STATS_HILOGD(COMP_SVC, "Get top %{public}zu consumers of type: %{public}d, epoch: %{public}" PRIu64,
+        topConsumers.size(), type, computeEpoch_);
+    return topConsumers;
+}
+
+void BatteryStatsCore::UpdateDeltaIndex(const BatteryStatsEntity::StatsInfoVector& statsInfos)
+{
+    for (const auto& statsInfo : statsInfos) {
+        DeltaKey key(static_cast<int32_t>(statsInfo->GetConsumptionType()), statsInfo->GetUid(),
+            statsInfo->GetUserId());
+        auto& entry = deltaIndex_[key];
+        if (entry.info == nullptr || entry.isRemoved || entry.info->GetPower() != statsInfo->GetPower()) {
+            entry.changedEpoch = computeEpoch_;
+        }
+        entry.info = statsInfo;
+        entry.isRemoved = false;
+        entry.seenEpoch = computeEpoch_;
+    }
+    size_t removedNum = 0;
+    for (auto& [key, entry] : deltaIndex_) {
+        if (!entry.isRemoved && entry.seenEpoch != computeEpoch_) {
+            entry.isRemoved = true;
+            entry.changedEpoch = computeEpoch_;
+        }
+        removedNum += entry.isRemoved ? 1 : 0;
+    }
+    if (removedNum > DELTA_REMOVED_MAX_NUM) {
+        // Forget the removals, callers older than this pass get a full snapshot instead of a delta
+        for (auto iter = deltaIndex_.begin(); iter != deltaIndex_.end();) {
+            iter = iter->second.isRemoved ? deltaIndex_.erase(iter) : std::next(iter);
+        }
+        deltaHorizonEpoch_ = computeEpoch_;
+    }
+}
+
+BatteryStatsDelta BatteryStatsCore::GetBatteryStatsSince(uint64_t epoch)
+{
+    std::lock_guard lock(mutex_);
+    BatteryStatsDelta delta;
+    delta.epoch = computeEpoch_;
+    delta.isFull = epoch < deltaHorizonEpoch_ || epoch > computeEpoch_;
+    for (const auto& [key, entry] : deltaIndex_) {
+        if (delta.isFull) {
+            if (!entry.isRemoved) {
+                delta.changed.push_back(entry.info);
+            }
+            continue;
+        }
+        if (entry.changedEpoch <= epoch) {
+            continue;
+        }
+        if (entry.isRemoved) {
+            delta.removed.push_back(entry.info);
+        } else {
+            delta.changed.push_back(entry.info);
+        }
+    }
+    STATS_HILOGD(COMP_SVC, "Get stats since epoch: %{public}" PRIu64 ", changed: %{public}zu, removed: %{public}zu, "
+        "full: %{public}d", epoch, delta.changed.size(), delta.removed.size(), delta.isFull);
+    return delta;
+}
+
+uint64_t BatteryStatsCore::GetComputeEpoch()
+{
+    std::lock_guard lock(mutex_);
+    return computeEpoch_;
+}
+
+sptr<Ashmem> BatteryStatsCore::GetComputeEpochAshmem()
+{
+    std::lock_guard lock(mutex_);
+    return epochCounter_.GetAshmem();
+}
+
 void BatteryStatsCore::SaveForHardware(cJSON* root)
 {
     STATS_HILOGD(COMP_SVC, "Save hardware battery stats");
+    StatsHelper::ComputeTimeScope timeScope;
     cJSON* hardwareObj = cJSON_CreateObject();
     if (!hardwareObj) {
         STATS_HILOGE(COMP_SVC, "Failed to create 'Hardware' object");
@@ -808,19 +1304,9 @@ void BatteryStatsCore::SaveForHardware(cJSON* root)
         GetTotalTimeMs(StatsUtils::STATS_TYPE_SCREEN_ON)) == nullptr) {
         STATS_HILOGW(COMP_SVC, "Add screen_on to Hardware failed.");
     }
-    cJSON* screenBrightnessArray = cJSON_CreateArray();
-    if (screenBrightnessArray) {
-        for (uint16_t brightness = 0; brightness <= StatsUtils::SCREEN_BRIGHTNESS_BIN; brightness++) {
-            if (!cJSON_AddItemToArray(screenBrightnessArray,
-                cJSON_CreateNumber(GetTotalTimeMs(StatsUtils::STATS_TYPE_SCREEN_BRIGHTNESS, brightness)))) {
-                STATS_HILOGW(COMP_SVC, "Add screen_brightness array failed.");
-            }
-        }
-        if (!cJSON_AddItemToObject(hardwareObj, "screen_brightness", screenBrightnessArray)) {
-            cJSON_Delete(screenBrightnessArray);
-            STATS_HILOGW(COMP_SVC, "Add screen_brightness to Hardware failed.");
-        }
-    }
+    std::vector<int64_t> levelTimesMs;
+    screenEntity_->GetLevelTimesMs(StatsUtils::STATS_TYPE_SCREEN_BRIGHTNESS, levelTimesMs);
+    AddLevelTimesArray(hardwareObj, "screen_brightness", levelTimesMs);
     // Save for Wifi
     if (cJSON_AddNumberToObject(hardwareObj, "wifi_on", GetTotalTimeMs(StatsUtils::STATS_TYPE_WIFI_ON)) == nullptr) {
         STATS_HILOGW(COMP_SVC, "Add wifi_on to Hardware failed.");
@@ -841,32 +1327,29 @@ void BatteryStatsCore::SaveForHardwareInternal(cJSON* hardwareObj)
     }
 
     // Save for Phone
-    cJSON* radioOnArray = cJSON_CreateArray();
-    if (radioOnArray) {
-        for (uint16_t signalOn = 0; signalOn < StatsUtils::RADIO_SIGNAL_BIN; signalOn++) {
-            if (!cJSON_AddItemToArray(radioOnArray,
-                cJSON_CreateNumber(GetTotalTimeMs(StatsUtils::STATS_TYPE_PHONE_ACTIVE, signalOn)))) {
-                STATS_HILOGW(COMP_SVC, "Add radio_on array failed.");
-            }
-        }
-        if (!cJSON_AddItemToObject(hardwareObj, "radio_on", radioOnArray)) {
-            cJSON_Delete(radioOnArray);
-            STATS_HILOGW(COMP_SVC, "Add radio_on to Hardware failed.");
-        }
+    std::vector<int64_t> levelTimesMs;
+    phoneEntity_->GetLevelTimesMs(StatsUtils::STATS_TYPE_PHONE_ACTIVE, levelTimesMs);
+    AddLevelTimesArray(hardwareObj, "radio_on", levelTimesMs);
+    phoneEntity_->GetLevelTimesMs(StatsUtils::STATS_TYPE_PHONE_DATA, levelTimesMs);
+    AddLevelTimesArray(hardwareObj, "radio_data", levelTimesMs);
+}
+
+void BatteryStatsCore::AddLevelTimesArray(cJSON* hardwareObj, const char* name,
+    const std::vector<int64_t>& levelTimesMs)
+{
+    cJSON* levelTimesArray = cJSON_CreateArray();
+    if (!levelTimesArray) {
+        return;
     }
-    cJSON* radioDataArray = cJSON_CreateArray();
-    if (radioDataArray) {
-        for (uint16_t signalData = 0; signalData < StatsUtils::RADIO_SIGNAL_BIN; signalData++) {
-            if (!cJSON_AddItemToArray(radioDataArray,
-                cJSON_CreateNumber(GetTotalTimeMs(StatsUtils::STATS_TYPE_PHONE_DATA, signalData)))) {
-                STATS_HILOGW(COMP_SVC, "Add radio_data array failed.");
-            }
-        }
-        if (!cJSON_AddItemToObject(hardwareObj, "radio_data", radioDataArray)) {
-            cJSON_Delete(radioDataArray);
-            STATS_HILOGW(COMP_SVC, "Add radio_data to Hardware failed.");
+    for (int64_t levelTimeMs : levelTimesMs) {
+        if (!cJSON_AddItemToArray(levelTimesArray, cJSON_CreateNumber(levelTimeMs))) {
+            STATS_HILOGW(COMP_SVC, "Add %{public}s array failed.", name);
         }
     }
+    if (!cJSON_AddItemToObject(hardwareObj, name, levelTimesArray)) {
+        cJSON_Delete(levelTimesArray);
+        STATS_HILOGW(COMP_SVC, "Add %{public}s to Hardware failed.", name);
+    }
 }
 
 void BatteryStatsCore::SaveForSoftware(cJSON* root)
@@ -1008,45 +1491,61 @@ void BatteryStatsCore::SaveForSoftwareConnectivity(cJSON* root, int32_t uid)
     }
 }
 
+cJSON* BatteryStatsCore::GetOrAddObject(cJSON* root, const char* name)
+{
+    cJSON* obj = cJSON_GetObjectItemCaseSensitive(root, name);
+    if (StatsJsonUtils::IsValidJsonObject(obj)) {
+        return obj;
+    }
+    obj = cJSON_CreateObject();
+    if (!obj) {
+        STATS_HILOGE(COMP_SVC, "Failed to create '%{public}s' object", name);
+        return nullptr;
+    }
+    if (!cJSON_AddItemToObject(root, name, obj)) {
+        cJSON_Delete(obj);
+        STATS_HILOGW(COMP_SVC, "Add %{public}s object to root failed.", name);
+        return nullptr;
+    }
+    return obj;
+}
+
 void BatteryStatsCore::SaveForPower(cJSON* root)
 {
     STATS_HILOGD(COMP_SVC, "Save power battery stats");
-    cJSON* powerObj = cJSON_GetObjectItemCaseSensitive(root, "Power");
-    if (!StatsJsonUtils::IsValidJsonObject(powerObj)) {
-        powerObj = cJSON_CreateObject();
-        if (!powerObj) {
-            STATS_HILOGE(COMP_SVC, "Failed to create 'Power' object");
-            return;
-        }
-        if (!cJSON_AddItemToObject(root, "Power", powerObj)) {
-            cJSON_Delete(powerObj);
-            STATS_HILOGW(COMP_SVC, "Add Power object to root failed.");
-            return;
-        }
+    // "Energy" keeps the exact nAh, "Power" is still written for readers of older versions
+    cJSON* powerObj = GetOrAddObject(root, "Power");
+    cJSON* energyObj = GetOrAddObject(root, "Energy");
+    if (powerObj == nullptr || energyObj == nullptr) {
+        return;
     }
 
     auto statsInfoList = BatteryStatsEntity::GetStatsInfoList();
     for (auto iter = statsInfoList.begin(); iter != statsInfoList.end(); iter++) {
+        std::string name;
         if ((*iter)->GetConsumptionType() == BatteryStatsInfo::CONSUMPTION_TYPE_APP) {
-            std::string name = std::to_string((*iter)->GetUid());
-            if (cJSON_AddNumberToObject(powerObj, name.c_str(), (*iter)->GetPower()) == nullptr) {
-                STATS_HILOGW(COMP_SVC, "Add %{public}s to powerObj failed.", name.c_str());
-            }
-            STATS_HILOGD(COMP_SVC, "Saved power: %{public}lf for uid: %{public}s", (*iter)->GetPower(),
-                name.c_str());
+            name = std::to_string((*iter)->GetUid());
         } else if ((*iter)->GetConsumptionType() != BatteryStatsInfo::CONSUMPTION_TYPE_USER) {
-            std::string name = std::to_string((*iter)->GetConsumptionType());
-            if (cJSON_AddNumberToObject(powerObj, name.c_str(), (*iter)->GetPower()) == nullptr) {
-                STATS_HILOGW(COMP_SVC, "Add %{public}s to powerObj failed.", name.c_str());
-            }
-            STATS_HILOGD(COMP_SVC, "Saved power: %{public}lf for type: %{public}s", (*iter)->GetPower(),
-                name.c_str());
+            name = std::to_string((*iter)->GetConsumptionType());
+        } else {
+            continue;
         }
+        double power = (*iter)->GetPower();
+        if (cJSON_AddNumberToObject(powerObj, name.c_str(), power) == nullptr) {
+            STATS_HILOGW(COMP_SVC, "Add %{public}s to powerObj failed.", name.c_str());
+        }
+        if (cJSON_AddNumberToObject(energyObj, name.c_str(),
+            static_cast<double>(StatsUtils::ConvertToEnergyNah(power))) == nullptr) {
+            STATS_HILOGW(COMP_SVC, "Add %{public}s to energyObj failed.", name.c_str());
+        }
+        STATS_HILOGD(COMP_SVC, "Saved power: %{public}lf for id: %{public}s", power, name.c_str());
     }
 }
 
 bool BatteryStatsCore::SaveBatteryStatsData()
 {
+    // Computed power and saved timers must describe the same instant
+    StatsHelper::ComputeTimeScope timeScope;
     ComputePower();
     cJSON* root = cJSON_CreateObject();
     if (!root) {
@@ -1054,14 +1553,18 @@ bool BatteryStatsCore::SaveBatteryStatsData()
         return false;
     }
 
-    // Save for power
-    SaveForPower(root);
+    {
+        // Timers and per uid power are read under the core lock, compaction may recycle their rows otherwise
+        std::lock_guard lock(mutex_);
+        // Save for power
+        SaveForPower(root);
 
-    // Save for hardware
-    SaveForHardware(root);
+        // Save for hardware
+        SaveForHardware(root);
 
-    // Save for software
-    SaveForSoftware(root);
+        // Save for software
+        SaveForSoftware(root);
+    }
 
     char* jsonStr = cJSON_Print(root);
     if (!jsonStr) {
@@ -1092,12 +1595,15 @@ bool BatteryStatsCore::SaveBatteryStatsData()
 void BatteryStatsCore::UpdateStatsEntity(cJSON* root)
 {
     BatteryStatsEntity::ResetStatsEntity();
-    cJSON* powerObj = cJSON_GetObjectItemCaseSensitive(root, "Power");
+    // Files saved by older versions only carry the power in mAh
+    cJSON* energyObj = cJSON_GetObjectItemCaseSensitive(root, "Energy");
+    bool hasEnergy = StatsJsonUtils::IsValidJsonObject(energyObj);
+    cJSON* powerObj = hasEnergy ? energyObj : cJSON_GetObjectItemCaseSensitive(root, "Power");
     if (!StatsJsonUtils::IsValidJsonObjectOrJsonArray(powerObj)) {
         STATS_HILOGE(COMP_SVC, "Failed to get 'Power' object from json");
         return;
     }
-    std::map<int32_t, double> tmpUserPowerMap;
+    std::map<int32_t, int64_t> tmpUserEnergyMap;
     cJSON* currentElement = nullptr;
     cJSON_ArrayForEach(currentElement, powerObj) {
         const char* key = currentElement->string;
@@ -1110,32 +1616,34 @@ void BatteryStatsCore::UpdateStatsEntity(cJSON* root)
             continue;
         }
         auto id = static_cast<int32_t>(result);
+        int64_t energyNah = hasEnergy ? static_cast<int64_t>(currentElement->valuedouble) :
+            StatsUtils::ConvertToEnergyNah(currentElement->valuedouble);
         int32_t usr = StatsUtils::INVALID_VALUE;
         std::shared_ptr<BatteryStatsInfo> info = std::make_shared<BatteryStatsInfo>();
         if (id > StatsUtils::INVALID_VALUE) {
             info->SetUid(id);
             info->SetConsumptioType(BatteryStatsInfo::CONSUMPTION_TYPE_APP);
-            info->SetPower(currentElement->valuedouble);
-            usr = AccountSA::OhosAccountKits::GetInstance().GetDeviceAccountIdByUID(id);
-            const auto& userPower = tmpUserPowerMap.find(usr);
-            if (userPower != tmpUserPowerMap.end()) {
-                userPower->second += info->GetPower();
+            info->SetPower(StatsUtils::ConvertToPowerMah(energyNah));
+            usr = userResolver_.GetUserId(id);
+            const auto& userEnergy = tmpUserEnergyMap.find(usr);
+            if (userEnergy != tmpUserEnergyMap.end()) {
+                userEnergy->second += energyNah;
             } else {
-                tmpUserPowerMap.insert(std::pair<int32_t, double>(usr, info->GetPower()));
+                tmpUserEnergyMap.insert(std::pair<int32_t, int64_t>(usr, energyNah));
             }
         } else if (id < StatsUtils::INVALID_VALUE && id > BatteryStatsInfo::CONSUMPTION_TYPE_INVALID) {
             info->SetUid(StatsUtils::INVALID_VALUE);
             info->SetConsumptioType(static_cast<BatteryStatsInfo::ConsumptionType>(id));
-            info->SetPower(currentElement->valuedouble);
+            info->SetPower(StatsUtils::ConvertToPowerMah(energyNah));
         }
         STATS_HILOGD(COMP_SVC, "Load power:%{public}lfmAh,id:%{public}d,user:%{public}d", info->GetPower(), id, usr);
         BatteryStatsEntity::UpdateStatsInfoList(info);
     }
-    for (auto& iter : tmpUserPowerMap) {
+    for (auto& iter : tmpUserEnergyMap) {
         std::shared_ptr<BatteryStatsInfo> statsInfo = std::make_shared<BatteryStatsInfo>();
         statsInfo->SetConsumptioType(BatteryStatsInfo::CONSUMPTION_TYPE_USER);
         statsInfo->SetUserId(iter.first);
-        statsInfo->SetPower(iter.second);
+        statsInfo->SetPower(StatsUtils::ConvertToPowerMah(iter.second));
         BatteryStatsEntity::UpdateStatsInfoList(statsInfo);
     }
 }
@@ -1179,12 +1687,14 @@ bool BatteryStatsCore::LoadBatteryStatsData()
 
     UpdateStatsEntity(root);
     cJSON_Delete(root);
+    eventVersion_++;
     return true;
 }
 
 void BatteryStatsCore::Reset()
 {
     std::lock_guard lock(mutex_);
+    eventVersion_++;
     audioEntity_->Reset();
     bluetoothEntity_->Reset();
     cameraEntity_->Reset();
@@ -1201,7 +1711,9 @@ void BatteryStatsCore::Reset()
     wakelockEntity_->Reset();
     alarmEntity_->Reset();
     BatteryStatsEntity::ResetStatsEntity();
-    debugInfo_.clear();
+    UpdateSnapshot();
+    debugRing_.Clear();
+    coalescer_.Reset();
 }
 } // namespace PowerMgr
 } // namespace OHOS
@@ -0,0 +1,218 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "battery_stats_debug_ring.h"
+
+#include <algorithm>
+
+#include "stats_log.h"
+#include "string_ex.h"
+
+namespace OHOS {
+namespace PowerMgr {
+BatteryStatsDebugRing::BatteryStatsDebugRing(size_t capacity)
+{
+    SetCapacity(capacity);
+}
+
+bool BatteryStatsDebugRing::IsRecordable(StatsUtils::StatsType type)
+{
+    bool isMatch = false;
+    switch (type) {
+        case StatsUtils::STATS_TYPE_THERMAL:
+        case StatsUtils::STATS_TYPE_BATTERY:
+        case StatsUtils::STATS_TYPE_WORKSCHEDULER:
+        case StatsUtils::STATS_TYPE_WAKELOCK_HOLD:
+        case StatsUtils::STATS_TYPE_DISPLAY:
+        case StatsUtils::STATS_TYPE_SCREEN_ON:
+        case StatsUtils::STATS_TYPE_SCREEN_BRIGHTNESS:
+        case StatsUtils::STATS_TYPE_PHONE_ACTIVE:
+        case StatsUtils::STATS_TYPE_PHONE_DATA:
+        case StatsUtils::STATS_TYPE_FLASHLIGHT_ON:
+        case StatsUtils::STATS_TYPE_DISTRIBUTEDSCHEDULER:
+            isMatch = true;
+            break;
+        default:
+            break;
+    }
+    return isMatch;
+}
+
+void BatteryStatsDebugRing::CopyText(const std::string& src, char* dest, size_t destLength)
+{
+    size_t copyLength = src.copy(dest, destLength - 1);
+    dest[copyLength] = '\0';
+}
+
+void BatteryStatsDebugRing::Push(const StatsUtils::StatsData& data, int64_t bootTimeMs)
+{
+    if (records_.empty()) {
+        return;
+    }
+    size_t capacity = records_.size();
+    size_t index = (head_ + size_) % capacity;
+    if (size_ == capacity) {
+        index = head_;
+        head_ = (head_ + 1) % capacity;
+        overwrittenCount_++;
+    } else {
+        size_++;
+    }
+    Record& record = records_[index];
+    record.type = data.type;
+    record.state = data.state;
+    record.bootTimeMs = bootTimeMs;
+    record.uid = data.uid;
+    record.pid = data.pid;
+    record.level = data.level;
+    record.eventDataType = data.eventDataType;
+    record.eventDataExtra = data.eventDataExtra;
+    CopyText(data.eventDataName, record.name, NAME_LENGTH);
+    CopyText(data.eventDebugInfo, record.detail, DETAIL_LENGTH);
+}
+
+void BatteryStatsDebugRing::SetCapacity(size_t capacity)
+{
+    capacity = std::clamp(capacity, static_cast<size_t>(1), MAX_CAPACITY);
+    if (capacity == records_.size()) {
+        return;
+    }
+    STATS_HILOGI(COMP_SVC, "Set debug ring capacity: %{public}zu", capacity);
+    records_.assign(capacity, Record());
+    records_.shrink_to_fit();
+    head_ = 0;
+    size_ = 0;
+    overwrittenCount_ = 0;
+}
+
+size_t BatteryStatsDebugRing::GetCapacity() const
+{
+    return records_.size();
+}
+
+size_t BatteryStatsDebugRing::GetSize() const
+{
+    return size_;
+}
+
+uint64_t BatteryStatsDebugRing::GetOverwrittenCount() const
+{
+    return overwrittenCount_;
+}
+
+void BatteryStatsDebugRing::Clear()
+{
+    head_ = 0;
+    size_ = 0;
+    overwrittenCount_ = 0;
+}
+
+void BatteryStatsDebugRing::FormatAdditionalInfo(const Record& record, std::string& result)
+{
+    if (record.detail[0] != '\0') {
+        result.append("Additional debug info: ")
+            .append(record.detail)
+            .append("\n");
+    }
+}
+
+void BatteryStatsDebugRing::FormatRecord(const Record& record, std::string& result)
+{
+    switch (record.type) {
+        case StatsUtils::STATS_TYPE_THERMAL:
+            result.append("Thermal event: Boot time after boot = ");
+            break;
+        case StatsUtils::STATS_TYPE_BATTERY:
+            result.append("Battery event: Battery level = ")
+                .append(ToString(record.level))
+                .append(", Charger type = ")
+                .append(ToString(record.eventDataExtra))
+                .append(", boot time after boot = ");
+            break;
+        case StatsUtils::STATS_TYPE_WORKSCHEDULER:
+            result.append("WorkScheduler event: UID = ")
+                .append(ToString(record.uid))
+                .append(", PID = ")
+                .append(ToString(record.pid))
+                .append(", work type = ")
+                .append(ToString(record.eventDataType))
+                .append(", work interval = ")
+                .append(ToString(record.eventDataExtra))
+                .append(", work state = ")
+                .append(ToString(record.state))
+                .append(", boot time after boot = ");
+            break;
+        case StatsUtils::STATS_TYPE_WAKELOCK_HOLD:
+            result.append("Wakelock event: UID = ")
+                .append(ToString(record.uid))
+                .append(", PID = ")
+                .append(ToString(record.pid))
+                .append(", wakelock type = ")
+                .append(ToString(record.eventDataType))
+                .append(", wakelock name = ")
+                .append(record.name)
+                .append(", boot time after boot = ");
+            break;
+        case StatsUtils::STATS_TYPE_DISPLAY:
+        case StatsUtils::STATS_TYPE_SCREEN_ON:
+        case StatsUtils::STATS_TYPE_SCREEN_BRIGHTNESS:
+            result.append("Dislpay event: Boot time after boot = ");
+            break;
+        case StatsUtils::STATS_TYPE_PHONE_ACTIVE:
+        case StatsUtils::STATS_TYPE_PHONE_DATA:
+            result.append("Phone event: Boot time after boot = ");
+            break;
+        case StatsUtils::STATS_TYPE_FLASHLIGHT_ON:
+            result.append("Flashlight event: UID = ")
+                .append(ToString(record.uid))
+                .append(", PID = ")
+                .append(ToString(record.pid))
+                .append(", flashlight state = ")
+                .append(record.state == StatsUtils::STATS_STATE_ACTIVATED ? "ON" : "OFF")
+                .append(", boot time after boot = ");
+            break;
+        case StatsUtils::STATS_TYPE_DISTRIBUTEDSCHEDULER:
+            result.append("Distributed schedule event, boot time after boot = ");
+            break;
+        default:
+            return;
+    }
+    result.append(ToString(record.bootTimeMs))
+        .append("ms\n");
+    if (record.type != StatsUtils::STATS_TYPE_FLASHLIGHT_ON) {
+        FormatAdditionalInfo(record, result);
+    }
+}
+
+void BatteryStatsDebugRing::Dump(std::string& result) const
+{
+    if (size_ == 0 && overwrittenCount_ == 0) {
+        return;
+    }
+    result.append("Misc stats info dump:\n");
+    result.append("Debug event records: ")
+        .append(ToString(size_))
+        .append("/")
+        .append(ToString(records_.size()))
+        .append(", overwritten: ")
+        .append(ToString(overwrittenCount_))
+        .append("\n");
+    size_t capacity = records_.size();
+    for (size_t i = 0; i < size_; i++) {
+        FormatRecord(records_[(head_ + i) % capacity], result);
+    }
+}
+} // namespace PowerMgr
+} // namespace OHOS
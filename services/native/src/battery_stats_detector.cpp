@@ -45,15 +45,44 @@ void BatteryStatsDetector::HandleStatsChangedEvent(StatsUtils::StatsData data)
         return;
     }
     auto core = bss->GetBatteryStatsCore();
-    if (IsDurationRelated(data.type)) {
-        // Update related timer with reported time
-        // The traffic won't participate the power consumption calculation, just for dump info
-        core->UpdateStats(data.type, data.time, data.traffic, data.uid);
-    } else if (IsStateRelated(data.type)) {
-        // Update related timer based on state or level
-        core->UpdateStats(data.type, data.state, data.level, data.uid, data.deviceId);
+    if (core->CoalesceEvent(data)) {
+        STATS_HILOGD(COMP_SVC, "Redundant event is coalesced, type: %{public}d", static_cast<int32_t>(data.type));
+        return;
+    }
+    if (!IsDurationRelated(data.type) && !IsStateRelated(data.type)) {
+        // Keep the raw event, it is only formatted when dumped
+        core->UpdateDebugInfo(data);
+        return;
+    }
+    {
+        std::lock_guard lock(mutex_);
+        pendingEvents_.push_back(std::move(data));
+        if (isDraining_) {
+            // The draining thread picks the event up with the rest of the burst
+            return;
+        }
+        isDraining_ = true;
+    }
+    DrainPendingEvents();
+}
+
+void BatteryStatsDetector::DrainPendingEvents()
+{
+    auto core = BatteryStatsService::GetInstance()->GetBatteryStatsCore();
+    std::vector<StatsUtils::StatsData> batch;
+    while (true) {
+        {
+            std::lock_guard lock(mutex_);
+            if (pendingEvents_.empty()) {
+                isDraining_ = false;
+                return;
+            }
+            batch.swap(pendingEvents_);
+        }
+        // Events queued while a batch is applied make up the next one, an idle stream is applied one by one
+        core->ApplyBatch(batch);
+        batch.clear();
     }
-    HandleDebugInfo(data);
 }
 
 bool BatteryStatsDetector::IsDurationRelated(StatsUtils::StatsType type)
@@ -102,171 +131,5 @@ bool BatteryStatsDetector::IsStateRelated(StatsUtils::StatsType type)
     }
     return isMatch;
 }
-
-void BatteryStatsDetector::HandleThermalInfo(StatsUtils::StatsData data, int64_t bootTimeMs, std::string& debugInfo)
-{
-    debugInfo.append("Thermal event: Boot time after boot = ")
-        .append(ToString(bootTimeMs))
-        .append("ms\n");
-    if (!data.eventDebugInfo.empty()) {
-        debugInfo.append("Additional debug info: ")
-            .append(data.eventDebugInfo)
-            .append("\n");
-    }
-}
-
-void BatteryStatsDetector::HandleBatteryInfo(StatsUtils::StatsData data, int64_t bootTimeMs, std::string& debugInfo)
-{
-    debugInfo.append("Battery event: Battery level = ")
-        .append(ToString(data.level))
-        .append(", Charger type = ")
-        .append(ToString(data.eventDataExtra))
-        .append(", boot time after boot = ")
-        .append(ToString(bootTimeMs))
-        .append("ms\n");
-    if (!data.eventDebugInfo.empty()) {
-        debugInfo.append("Additional debug info: ")
-            .append(data.eventDebugInfo);
-    }
-}
-
-void BatteryStatsDetector::HandleDisplayInfo(StatsUtils::StatsData data, int64_t bootTimeMs, std::string& debugInfo)
-{
-    debugInfo.append("Dislpay event: Boot time after boot = ")
-        .append(ToString(bootTimeMs))
-        .append("ms\n");
-    if (!data.eventDebugInfo.empty()) {
-        debugInfo.append("Additional debug info: ")
-            .append(data.eventDebugInfo)
-            .append("\n");
-    }
-}
-
-void BatteryStatsDetector::HandleWakelockInfo(StatsUtils::StatsData data, int64_t bootTimeMs, std::string& debugInfo)
-{
-    debugInfo.append("\n")
-        .append("Wakelock event: UID = ")
-        .append(ToString(data.uid))
-        .append(", PID = ")
-        .append(ToString(data.pid))
-        .append(", wakelock type = ")
-        .append(ToString(data.eventDataType))
-        .append(", wakelock name = ")
-        .append(data.eventDataName)
-        .append(", boot time after boot = ")
-        .append(ToString(bootTimeMs))
-        .append("ms\n");
-    if (!data.eventDebugInfo.empty()) {
-        debugInfo.append("Additional debug info: ")
-            .append(data.eventDebugInfo);
-    }
-}
-
-void BatteryStatsDetector::HandleWorkschedulerInfo(StatsUtils::StatsData data, int64_t bootTimeMs,
-    std::string& debugInfo)
-{
-    debugInfo.append("WorkScheduler event: UID = ")
-        .append(ToString(data.uid))
-        .append(", PID = ")
-        .append(ToString(data.pid))
-        .append(", work type = ")
-        .append(ToString(data.eventDataType))
-        .append(", work interval = ")
-        .append(ToString(data.eventDataExtra))
-        .append(", work state = ")
-        .append(ToString(data.state))
-        .append(", boot time after boot = ")
-        .append(ToString(bootTimeMs))
-        .append("ms\n");
-    if (!data.eventDebugInfo.empty()) {
-        debugInfo.append("Additional debug info: ")
-            .append(data.eventDebugInfo);
-    }
-}
-
-void BatteryStatsDetector::HandlePhoneInfo(StatsUtils::StatsData data, int64_t bootTimeMs, std::string& debugInfo)
-{
-    debugInfo.append("Phone event: Boot time after boot = ")
-        .append(ToString(bootTimeMs))
-        .append("ms\n");
-    if (!data.eventDebugInfo.empty()) {
-        debugInfo.append("Additional debug info: ")
-            .append(data.eventDebugInfo)
-            .append("\n");
-    }
-}
-
-void BatteryStatsDetector::HandleFlashlightInfo(StatsUtils::StatsData data, int64_t bootTimeMs, std::string& debugInfo)
-{
-    std::string eventState;
-    if (data.state == StatsUtils::STATS_STATE_ACTIVATED) {
-        eventState = "ON";
-    } else {
-        eventState = "OFF";
-    }
-    debugInfo.append("Flashlight event: UID = ")
-        .append(ToString(data.uid))
-        .append(", PID = ")
-        .append(ToString(data.pid))
-        .append(", flashlight state = ")
-        .append(eventState)
-        .append(", boot time after boot = ")
-        .append(ToString(bootTimeMs))
-        .append("ms\n");
-}
-
-void BatteryStatsDetector::HandleDistributedSchedulerInfo(StatsUtils::StatsData data, int64_t bootTimeMs,
-    std::string& debugInfo)
-{
-    debugInfo.append("Distributed schedule event")
-        .append(", boot time after boot = ")
-        .append(ToString(bootTimeMs))
-        .append("ms\n");
-    if (!data.eventDebugInfo.empty()) {
-        debugInfo.append("Additional debug info: ")
-            .append(data.eventDebugInfo)
-            .append("\n");
-    }
-}
-
-void BatteryStatsDetector::HandleDebugInfo(StatsUtils::StatsData data)
-{
-    int64_t bootTimeMs = StatsHelper::GetBootTimeMs();
-    auto core = BatteryStatsService::GetInstance()->GetBatteryStatsCore();
-    std::string debugInfo;
-    switch (data.type) {
-        case StatsUtils::STATS_TYPE_THERMAL:
-            HandleThermalInfo(data, bootTimeMs, debugInfo);
-            break;
-        case StatsUtils::STATS_TYPE_BATTERY:
-            HandleBatteryInfo(data, bootTimeMs, debugInfo);
-            break;
-        case StatsUtils::STATS_TYPE_WORKSCHEDULER:
-            HandleWorkschedulerInfo(data, bootTimeMs, debugInfo);
-            break;
-        case StatsUtils::STATS_TYPE_WAKELOCK_HOLD:
-            HandleWakelockInfo(data, bootTimeMs, debugInfo);
-            break;
-        case StatsUtils::STATS_TYPE_DISPLAY:
-        case StatsUtils::STATS_TYPE_SCREEN_ON:
-        case StatsUtils::STATS_TYPE_SCREEN_BRIGHTNESS:
-            HandleDisplayInfo(data, bootTimeMs, debugInfo);
-            break;
-        case StatsUtils::STATS_TYPE_PHONE_ACTIVE:
-        case StatsUtils::STATS_TYPE_PHONE_DATA:
-            HandlePhoneInfo(data, bootTimeMs, debugInfo);
-            break;
-        case StatsUtils::STATS_TYPE_FLASHLIGHT_ON:
-            HandleFlashlightInfo(data, bootTimeMs, debugInfo);
-            break;
-        case StatsUtils::STATS_TYPE_DISTRIBUTEDSCHEDULER:
-            HandleDistributedSchedulerInfo(data, bootTimeMs, debugInfo);
-            break;
-        default:
-            STATS_HILOGD(COMP_SVC, "Invalid type");
-            break;
-    }
-    core->UpdateDebugInfo(debugInfo);
-}
 } // namespace PowerMgr
 } // namespace OHOS
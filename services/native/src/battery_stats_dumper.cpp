@@ -15,8 +15,15 @@
 
 #include "battery_stats_dumper.h"
 
+#include <map>
+#include <sstream>
+#include <file_ex.h>
+#include <string_ex.h>
+
 #include "battery_stats_service.h"
+#include "entities/uid_entity.h"
 #include "stats_common.h"
+#include "stats_helper.h"
 
 namespace OHOS {
 namespace PowerMgr {
@@ -24,38 +31,239 @@ namespace {
 constexpr const char* ARGS_HELP = "-h";
 constexpr const char* ARGS_STATS = "-batterystats";
 constexpr const char* ARGS_POWER_AVERAGE = "-poweraverage";
+constexpr const char* ARGS_UID = "-uid";
+constexpr const char* ARGS_SECTION = "-section";
+constexpr const char* ARGS_TOP = "-top";
+constexpr char SECTION_SEPARATOR = ',';
+constexpr size_t DUMP_CHUNK_SIZE = 16 * 1024;
+const std::map<std::string, uint32_t> SECTION_MAP = {
+    { "bluetooth", BatteryStatsDumper::SECTION_BLUETOOTH },
+    { "idle", BatteryStatsDumper::SECTION_IDLE },
+    { "radio", BatteryStatsDumper::SECTION_RADIO },
+    { "screen", BatteryStatsDumper::SECTION_SCREEN },
+    { "wifi", BatteryStatsDumper::SECTION_WIFI },
+    { "app", BatteryStatsDumper::SECTION_APP },
+    { "cpu", BatteryStatsDumper::SECTION_CPU },
+    { "history", BatteryStatsDumper::SECTION_HISTORY },
+};
+const std::pair<uint32_t, BatteryStatsInfo::ConsumptionType> PART_SECTIONS[] = {
+    { BatteryStatsDumper::SECTION_BLUETOOTH, BatteryStatsInfo::CONSUMPTION_TYPE_BLUETOOTH },
+    { BatteryStatsDumper::SECTION_IDLE, BatteryStatsInfo::CONSUMPTION_TYPE_IDLE },
+    { BatteryStatsDumper::SECTION_RADIO, BatteryStatsInfo::CONSUMPTION_TYPE_PHONE },
+    { BatteryStatsDumper::SECTION_SCREEN, BatteryStatsInfo::CONSUMPTION_TYPE_SCREEN },
+    { BatteryStatsDumper::SECTION_WIFI, BatteryStatsInfo::CONSUMPTION_TYPE_WIFI },
+};
+
+bool ParseSections(const std::string& value, uint32_t& sectionMask)
+{
+    sectionMask = 0;
+    std::istringstream stream(value);
+    std::string name;
+    while (std::getline(stream, name, SECTION_SEPARATOR)) {
+        auto iter = SECTION_MAP.find(name);
+        if (iter == SECTION_MAP.end()) {
+            return false;
+        }
+        sectionMask |= iter->second;
+    }
+    return sectionMask != 0;
+}
 }
 
+/**
+ * Holds the dump text of the current section. Without an fd the text is the whole result,
+ * with an fd it is written out and dropped once a chunk is full, so memory stays bounded.
+ */
+class BatteryStatsDumper::DumpWriter {
+public:
+    explicit DumpWriter(std::string& result) : result_(result) {}
+    DumpWriter(std::string& buffer, int32_t fd) : result_(buffer), fd_(fd) {}
+    ~DumpWriter() = default;
+    std::string& GetBuffer()
+    {
+        return result_;
+    }
+    void Commit(bool isForced = false)
+    {
+        if (fd_ < 0 || result_.empty() || (!isForced && result_.size() < DUMP_CHUNK_SIZE)) {
+            return;
+        }
+        if (!isFailed_ && !SaveStringToFd(fd_, result_)) {
+            STATS_HILOGE(COMP_SVC, "Dump save to fd failed, dropping %{public}zu bytes", result_.size());
+            isFailed_ = true;
+        }
+        result_.clear();
+    }
+    bool IsFailed() const
+    {
+        return isFailed_;
+    }
+private:
+    std::string& result_;
+    int32_t fd_ = -1;
+    bool isFailed_ = false;
+};
+
 bool BatteryStatsDumper::Dump(const std::vector<std::string>& args, std::string& result)
 {
     result.clear();
+    DumpWriter writer(result);
+    return DumpArgs(args, writer);
+}
+
+bool BatteryStatsDumper::Dump(const std::vector<std::string>& args, int32_t fd)
+{
+    std::string buffer;
+    buffer.reserve(DUMP_CHUNK_SIZE);
+    DumpWriter writer(buffer, fd);
+    bool ret = DumpArgs(args, writer);
+    writer.Commit(true);
+    return ret && !writer.IsFailed();
+}
+
+bool BatteryStatsDumper::ParseFilter(const std::vector<std::string>& args, DumpFilter& filter)
+{
+    bool hasSection = false;
+    for (size_t i = 0; i < args.size(); i++) {
+        if (args[i] != ARGS_UID && args[i] != ARGS_SECTION && args[i] != ARGS_TOP) {
+            continue;
+        }
+        if (i + 1 >= args.size()) {
+            return false;
+        }
+        const std::string& value = args[++i];
+        int32_t number = 0;
+        if (args[i - 1] == ARGS_SECTION) {
+            if (!ParseSections(value, filter.sectionMask)) {
+                return false;
+            }
+            hasSection = true;
+        } else if (!StrToInt(value, number) || number < 0) {
+            return false;
+        } else if (args[i - 1] == ARGS_UID) {
+            filter.uid = number;
+        } else {
+            filter.topNum = static_cast<uint32_t>(number);
+        }
+    }
+    if (!hasSection && (filter.uid != StatsUtils::INVALID_VALUE || filter.topNum > 0)) {
+        // Selecting apps without naming sections narrows the dump to those apps
+        filter.sectionMask = SECTION_APP;
+    }
+    return true;
+}
+
+bool BatteryStatsDumper::DumpArgs(const std::vector<std::string>& args, DumpWriter& writer)
+{
+    std::string& result = writer.GetBuffer();
     auto argc = args.size();
     if ((argc == 0) || (args[0] == ARGS_HELP)) {
         ShowUsage(result);
         return true;
     }
+    DumpFilter filter;
+    if (!ParseFilter(args, filter)) {
+        result.append("Invalid dump filter\n");
+        ShowUsage(result);
+        return false;
+    }
     auto bss = BatteryStatsService::GetInstance();
     if (bss == nullptr) {
         return true;
     }
     for (auto it = args.begin(); it != args.end(); it++) {
         if (*it == ARGS_STATS) {
-            auto core = bss->GetBatteryStatsCore();
-            if (core == nullptr) {
-                continue;
-            }
-            core->DumpInfo(result);
+            DumpStats(bss, filter, writer);
         } else if (*it == ARGS_POWER_AVERAGE) {
             auto parser = bss->GetBatteryStatsParser();
             if (parser == nullptr) {
                 continue;
             }
             parser->DumpInfo(result);
+            writer.Commit();
         }
     }
     return true;
 }
 
+void BatteryStatsDumper::DumpStats(const sptr<BatteryStatsService>& bss, const DumpFilter& filter,
+    DumpWriter& writer)
+{
+    auto core = bss->GetBatteryStatsCore();
+    if (core == nullptr) {
+        return;
+    }
+    std::string& result = writer.GetBuffer();
+    // Every timer is read at the same instant, so the chunks form one snapshot
+    StatsHelper::ComputeTimeScope timeScope;
+    result.append("BATTERY STATS DUMP:\n");
+    result.append("\n");
+    for (const auto& [section, type] : PART_SECTIONS) {
+        auto entity = core->GetEntity(type);
+        if ((filter.sectionMask & section) == 0 || entity == nullptr) {
+            continue;
+        }
+        // A section is read under the core lock, the fd is only written once the lock is released
+        core->RunLocked([&entity, &result]() { entity->DumpInfo(result); });
+        result.append("\n");
+        writer.Commit();
+    }
+    if ((filter.sectionMask & (SECTION_APP | SECTION_CPU)) != 0) {
+        DumpApps(core, filter, writer);
+        result.append("\n");
+    }
+    if ((filter.sectionMask & SECTION_HISTORY) != 0) {
+        core->DumpHistory(result);
+        auto notifier = bss->GetBatteryStatsNotifier();
+        if (notifier != nullptr) {
+            notifier->DumpInfo(result);
+        }
+        auto bundleCache = bss->GetBatteryStatsBundleCache();
+        if (bundleCache != nullptr) {
+            bundleCache->DumpInfo(result);
+        }
+    }
+    writer.Commit();
+}
+
+void BatteryStatsDumper::DumpApps(const std::shared_ptr<BatteryStatsCore>& core, const DumpFilter& filter,
+    DumpWriter& writer)
+{
+    auto uidEntity = core->GetEntity(BatteryStatsInfo::CONSUMPTION_TYPE_APP);
+    auto cpuEntity = core->GetEntity(BatteryStatsInfo::CONSUMPTION_TYPE_CPU);
+    if (uidEntity == nullptr) {
+        return;
+    }
+    std::vector<int32_t> uids;
+    if (filter.uid != StatsUtils::INVALID_VALUE) {
+        uids.push_back(filter.uid);
+    } else if (filter.topNum > 0) {
+        core->ComputePowerShared(core->GetComputeTicket());
+        for (const auto& info : core->GetTopConsumers(filter.topNum, BatteryStatsInfo::CONSUMPTION_TYPE_APP)) {
+            uids.push_back(info->GetUid());
+        }
+    } else {
+        uids = uidEntity->GetUids();
+    }
+    std::string& result = writer.GetBuffer();
+    bool isAppSection = (filter.sectionMask & SECTION_APP) != 0;
+    auto bundleCache = BatteryStatsService::GetInstance()->GetBatteryStatsBundleCache();
+    if (isAppSection && bundleCache != nullptr) {
+        // Names are resolved before the core lock is taken, the app sections only read the cache
+        bundleCache->Prefetch(uids);
+    }
+    auto appEntity = std::static_pointer_cast<UidEntity>(uidEntity);
+    for (int32_t uid : uids) {
+        if (isAppSection) {
+            core->RunLocked([&appEntity, &result, uid]() { appEntity->DumpForUid(uid, result); });
+        } else if (cpuEntity != nullptr) {
+            result.append("\n").append(ToString(uid)).append(":\n");
+            core->RunLocked([&cpuEntity, &result, uid]() { cpuEntity->DumpInfo(result, uid); });
+        }
+        writer.Commit();
+    }
+}
+
 void BatteryStatsDumper::ShowUsage(std::string& result)
 {
     std::string HELP_COMMAND_MSG =
@@ -63,7 +271,12 @@ void BatteryStatsDumper::ShowUsage(std::string& result)
         "command list:\n"
         "  -h              :    Show this help menu. \n"
         "  -batterystats   :    Show all the information of battery stats.\n"
-        "  -poweraverage   :    Show all the information of power average configuration.\n";
+        "  -poweraverage   :    Show all the information of power average configuration.\n"
+        "options of -batterystats:\n"
+        "  -uid <uid>      :    Only show the app of the uid.\n"
+        "  -top <num>      :    Only show the apps consuming the most power.\n"
+        "  -section <list> :    Only show the comma separated sections, from bluetooth, idle,\n"
+        "                       radio, screen, wifi, app, cpu and history.\n";
     result.append(HELP_COMMAND_MSG);
 }
 } // namespace PowerMgr
@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "battery_stats_info_pool.h"
+
+namespace OHOS {
+namespace PowerMgr {
+std::shared_ptr<BatteryStatsInfo> BatteryStatsInfoPool::Acquire(BatteryStatsInfo::ConsumptionType type)
+{
+    size_t index = static_cast<size_t>(type - BatteryStatsInfo::CONSUMPTION_TYPE_INVALID);
+    if (index < TYPE_NUM) {
+        Bucket& bucket = buckets_[index];
+        size_t bucketSize = bucket.infos.size();
+        for (size_t i = 0; i < bucketSize; i++) {
+            const auto& info = bucket.infos[bucket.cursor];
+            bucket.cursor = (bucket.cursor + 1) % bucketSize;
+            if (info.use_count() == 1) {
+                reusedCount_++;
+                return info;
+            }
+        }
+    }
+    auto info = std::make_shared<BatteryStatsInfo>();
+    info->SetConsumptioType(type);
+    createdCount_++;
+    if (index < TYPE_NUM && size_ < MAX_POOL_SIZE) {
+        buckets_[index].infos.push_back(info);
+        size_++;
+    }
+    return info;
+}
+
+size_t BatteryStatsInfoPool::GetSize() const
+{
+    return size_;
+}
+
+uint64_t BatteryStatsInfoPool::GetCreatedCount() const
+{
+    return createdCount_;
+}
+
+uint64_t BatteryStatsInfoPool::GetReusedCount() const
+{
+    return reusedCount_;
+}
+} // namespace PowerMgr
+} // namespace OHOS
@@ -0,0 +1,289 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "battery_stats_notifier.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cmath>
+
+#include "event_handler.h"
+#include "event_runner.h"
+#include "stats_helper.h"
+#include "stats_log.h"
+#include "string_ex.h"
+
+namespace OHOS {
+namespace PowerMgr {
+namespace {
+const std::string NOTIFIER_RUNNER_NAME = "BatteryStatsNotifier";
+const std::string PERIODIC_COMPUTE_TASK_NAME = "BatteryStatsPeriodicCompute";
+constexpr int64_t MAX_NOTIFY_INTERVAL_MS = 24 * 60 * 60 * 1000;
+}
+
+BatteryStatsNotifier::~BatteryStatsNotifier()
+{
+    if (handler_ != nullptr) {
+        handler_->RemoveTask(PERIODIC_COMPUTE_TASK_NAME);
+    }
+}
+
+void BatteryStatsNotifier::CallbackDeathRecipient::OnRemoteDied(const wptr<IRemoteObject>& remote)
+{
+    auto notifier = notifier_.lock();
+    if (notifier == nullptr || remote == nullptr) {
+        return;
+    }
+    STATS_HILOGI(COMP_SVC, "Stats callback died, remove its subscription");
+    notifier->RemoveSubscription(remote.promote());
+}
+
+void BatteryStatsNotifier::SetComputeTrigger(const ComputeTrigger& trigger)
+{
+    std::lock_guard lock(mutex_);
+    computeTrigger_ = trigger;
+}
+
+bool BatteryStatsNotifier::EnsureHandler()
+{
+    if (handler_ != nullptr) {
+        return true;
+    }
+    auto runner = AppExecFwk::EventRunner::Create(NOTIFIER_RUNNER_NAME);
+    if (runner == nullptr) {
+        STATS_HILOGE(COMP_SVC, "Create notifier runner failed");
+        return false;
+    }
+    handler_ = std::make_shared<AppExecFwk::EventHandler>(runner);
+    return true;
+}
+
+bool BatteryStatsNotifier::Subscribe(const sptr<IBatteryStatsCallback>& callback, const StatsSubscribeInfo& info)
+{
+    if (callback == nullptr || callback->AsObject() == nullptr || info.uids.size() > MAX_FILTER_NUM ||
+        info.types.size() > MAX_FILTER_NUM || info.minDeltaMah < 0.0 || info.minDeltaPercent < 0.0 ||
+        std::isnan(info.minDeltaMah) || std::isnan(info.minDeltaPercent)) {
+        STATS_HILOGW(COMP_SVC, "Invalid stats subscription");
+        return false;
+    }
+    sptr<IRemoteObject> remote = callback->AsObject();
+    std::lock_guard lock(mutex_);
+    auto iter = subscriptionMap_.find(remote);
+    if (iter == subscriptionMap_.end() && subscriptionMap_.size() >= MAX_SUBSCRIPTION_NUM) {
+        STATS_HILOGW(COMP_SVC, "Stats subscriptions exceed the limit: %{public}zu", MAX_SUBSCRIPTION_NUM);
+        return false;
+    }
+    if (!EnsureHandler()) {
+        return false;
+    }
+    if (iter == subscriptionMap_.end()) {
+        if (deathRecipient_ == nullptr) {
+            deathRecipient_ = new CallbackDeathRecipient(weak_from_this());
+        }
+        remote->AddDeathRecipient(deathRecipient_);
+        iter = subscriptionMap_.emplace(remote, Subscription()).first;
+    }
+    // Subscribing again replaces the filters and starts over from the next compute pass
+    Subscription& subscription = iter->second;
+    subscription = Subscription();
+    subscription.callback = callback;
+    subscription.uids.insert(info.uids.begin(), info.uids.end());
+    subscription.types.insert(info.types.begin(), info.types.end());
+    subscription.minDeltaMah = info.minDeltaMah;
+    subscription.minDeltaPercent = info.minDeltaPercent;
+    subscription.minIntervalMs = std::clamp(info.minIntervalMs, MIN_NOTIFY_INTERVAL_MS, MAX_NOTIFY_INTERVAL_MS);
+    hasSubscription_ = true;
+    SchedulePeriodicCompute();
+    STATS_HILOGI(COMP_SVC, "Add stats subscription, uids: %{public}zu, types: %{public}zu, interval: %{public}"
+        PRId64 "ms", subscription.uids.size(), subscription.types.size(), subscription.minIntervalMs);
+    return true;
+}
+
+bool BatteryStatsNotifier::Unsubscribe(const sptr<IBatteryStatsCallback>& callback)
+{
+    if (callback == nullptr || callback->AsObject() == nullptr) {
+        return false;
+    }
+    sptr<IRemoteObject> remote = callback->AsObject();
+    {
+        std::lock_guard lock(mutex_);
+        if (subscriptionMap_.find(remote) == subscriptionMap_.end()) {
+            return false;
+        }
+    }
+    RemoveSubscription(remote);
+    return true;
+}
+
+void BatteryStatsNotifier::RemoveSubscription(const sptr<IRemoteObject>& remote)
+{
+    std::lock_guard lock(mutex_);
+    auto iter = subscriptionMap_.find(remote);
+    if (iter == subscriptionMap_.end()) {
+        return;
+    }
+    if (deathRecipient_ != nullptr) {
+        remote->RemoveDeathRecipient(deathRecipient_);
+    }
+    subscriptionMap_.erase(iter);
+    hasSubscription_ = !subscriptionMap_.empty();
+    SchedulePeriodicCompute();
+    STATS_HILOGI(COMP_SVC, "Remove stats subscription, left: %{public}zu", subscriptionMap_.size());
+}
+
+bool BatteryStatsNotifier::HasSubscription() const
+{
+    return hasSubscription_.load();
+}
+
+void BatteryStatsNotifier::SchedulePeriodicCompute()
+{
+    if (handler_ == nullptr) {
+        return;
+    }
+    handler_->RemoveTask(PERIODIC_COMPUTE_TASK_NAME);
+    if (subscriptionMap_.empty() || computeTrigger_ == nullptr) {
+        return;
+    }
+    int64_t intervalMs = MAX_NOTIFY_INTERVAL_MS;
+    for (const auto& [remote, subscription] : subscriptionMap_) {
+        intervalMs = std::min(intervalMs, subscription.minIntervalMs);
+    }
+    intervalMs = std::max(intervalMs, MIN_PERIODIC_COMPUTE_MS);
+    std::weak_ptr<BatteryStatsNotifier> weakNotifier = weak_from_this();
+    handler_->PostTask([weakNotifier]() {
+        auto notifier = weakNotifier.lock();
+        if (notifier != nullptr) {
+            notifier->PeriodicCompute();
+        }
+    }, PERIODIC_COMPUTE_TASK_NAME, intervalMs);
+}
+
+void BatteryStatsNotifier::PeriodicCompute()
+{
+    ComputeTrigger trigger;
+    {
+        std::lock_guard lock(mutex_);
+        trigger = computeTrigger_;
+    }
+    if (trigger != nullptr) {
+        // The compute pass reports back through OnComputed
+        trigger();
+    }
+    std::lock_guard lock(mutex_);
+    SchedulePeriodicCompute();
+}
+
+void BatteryStatsNotifier::OnComputed(const StatsInfoVector& statsInfos, double totalPowerMah, uint64_t epoch)
+{
+    if (!hasSubscription_) {
+        return;
+    }
+    std::lock_guard lock(mutex_);
+    if (handler_ == nullptr) {
+        return;
+    }
+    std::weak_ptr<BatteryStatsNotifier> weakNotifier = weak_from_this();
+    // Evaluated off the compute path, the caller may still hold the core lock
+    handler_->PostTask([weakNotifier, statsInfos, totalPowerMah, epoch]() {
+        auto notifier = weakNotifier.lock();
+        if (notifier != nullptr) {
+            notifier->Evaluate(statsInfos, totalPowerMah, epoch);
+        }
+    }, "", 0);
+}
+
+void BatteryStatsNotifier::Evaluate(const StatsInfoVector& statsInfos, double totalPowerMah, uint64_t epoch)
+{
+    int64_t nowMs = StatsHelper::GetBootTimeMs();
+    std::lock_guard lock(mutex_);
+    for (auto& [remote, subscription] : subscriptionMap_) {
+        EvaluateSubscription(subscription, statsInfos, totalPowerMah, epoch, nowMs);
+    }
+}
+
+bool BatteryStatsNotifier::IsMatched(const Subscription& subscription, const std::shared_ptr<BatteryStatsInfo>& info)
+{
+    if (!subscription.uids.empty() && subscription.uids.count(info->GetUid()) == 0) {
+        return false;
+    }
+    return subscription.types.empty() ||
+        subscription.types.count(static_cast<int32_t>(info->GetConsumptionType())) != 0;
+}
+
+bool BatteryStatsNotifier::IsOverThreshold(const Subscription& subscription, double delta, double totalPowerMah)
+{
+    if (delta <= 0.0) {
+        return false;
+    }
+    if (subscription.minDeltaMah <= 0.0 && subscription.minDeltaPercent <= 0.0) {
+        return true;
+    }
+    if (subscription.minDeltaMah > 0.0 && delta >= subscription.minDeltaMah) {
+        return true;
+    }
+    return subscription.minDeltaPercent > 0.0 && totalPowerMah > 0.0 &&
+        delta / totalPowerMah >= subscription.minDeltaPercent;
+}
+
+void BatteryStatsNotifier::EvaluateSubscription(Subscription& subscription, const StatsInfoVector& statsInfos,
+    double totalPowerMah, uint64_t epoch, int64_t nowMs)
+{
+    if (subscription.lastNotifyMs > 0 && nowMs - subscription.lastNotifyMs < subscription.minIntervalMs) {
+        return;
+    }
+    ParcelableBatteryStatsList changed;
+    changed.isPacked_ = true;
+    for (const auto& info : statsInfos) {
+        if (info == nullptr || !IsMatched(subscription, info)) {
+            continue;
+        }
+        EntryKey key(static_cast<int32_t>(info->GetConsumptionType()), info->GetUid(), info->GetUserId());
+        auto iter = subscription.notifiedPowerMap.find(key);
+        double lastPower = iter != subscription.notifiedPowerMap.end() ? iter->second : 0.0;
+        if (IsOverThreshold(subscription, std::fabs(info->GetPower() - lastPower), totalPowerMah)) {
+            subscription.notifiedPowerMap[key] = info->GetPower();
+            changed.statsList_.push_back(info);
+        }
+    }
+    if (changed.statsList_.empty()) {
+        return;
+    }
+    subscription.lastNotifyMs = nowMs;
+    subscription.notifyCount++;
+    subscription.callback->OnStatsChanged(changed, epoch);
+}
+
+void BatteryStatsNotifier::DumpInfo(std::string& result)
+{
+    std::lock_guard lock(mutex_);
+    result.append("Stats subscriptions dump:\n")
+        .append("Subscriptions: ")
+        .append(ToString(subscriptionMap_.size()))
+        .append("\n");
+    for (const auto& [remote, subscription] : subscriptionMap_) {
+        result.append("uids: ")
+            .append(ToString(subscription.uids.size()))
+            .append(", types: ")
+            .append(ToString(subscription.types.size()))
+            .append(", interval: ")
+            .append(ToString(subscription.minIntervalMs))
+            .append("ms, notified: ")
+            .append(ToString(subscription.notifyCount))
+            .append("\n");
+    }
+}
+} // namespace PowerMgr
+} // namespace OHOS
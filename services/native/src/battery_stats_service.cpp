@@ -15,7 +15,6 @@
 
 #include "battery_stats_service.h"
 
-#include <file_ex.h>
 #include <cmath>
 #include <ipc_skeleton.h>
 
@@ -34,6 +33,7 @@
 
 #include "battery_stats_dumper.h"
 #include "battery_stats_listener.h"
+#include "battery_stats_records.h"
 #include "battery_stats_subscriber.h"
 #include "stats_common.h"
 #include "stats_hisysevent.h"
@@ -77,6 +77,7 @@ void BatteryStatsService::OnStart()
     }
     AddSystemAbilityListener(DFX_SYS_EVENT_SERVICE_ABILITY_ID);
     AddSystemAbilityListener(COMMON_EVENT_SERVICE_ID);
+    AddSystemAbilityListener(BUNDLE_MGR_SERVICE_SYS_ABILITY_ID);
     if (!Publish(BatteryStatsService::GetInstance())) {
         STATS_HILOGE(COMP_SVC, "OnStart register to system ability manager failed");
         return;
@@ -95,6 +96,7 @@ void BatteryStatsService::OnStop()
     isBootCompleted_ = false;
     RemoveSystemAbilityListener(DFX_SYS_EVENT_SERVICE_ABILITY_ID);
     RemoveSystemAbilityListener(COMMON_EVENT_SERVICE_ID);
+    RemoveSystemAbilityListener(BUNDLE_MGR_SERVICE_SYS_ABILITY_ID);
     HiviewDFX::HiSysEventManager::RemoveListener(listenerPtr_);
     if (!OHOS::EventFwk::CommonEventManager::UnSubscribeCommonEvent(subscriberPtr_)) {
         STATS_HILOGE(COMP_SVC, "OnStart unregister to commonevent manager failed");
@@ -119,6 +121,10 @@ void BatteryStatsService::OnAddSystemAbility(int32_t systemAbilityId, const std:
     if (systemAbilityId == COMMON_EVENT_SERVICE_ID) {
         SubscribeCommonEvent();
     }
+    if (systemAbilityId == BUNDLE_MGR_SERVICE_SYS_ABILITY_ID && bundleCache_ != nullptr) {
+        // A restarted bundle manager may know uids it failed to resolve before
+        bundleCache_->Clear();
+    }
 }
 
 bool BatteryStatsService::Init()
@@ -143,6 +149,29 @@ bool BatteryStatsService::Init()
         detector_ = std::make_shared<BatteryStatsDetector>();
     }
 
+    if (bundleCache_ == nullptr) {
+        bundleCache_ = std::make_shared<BatteryStatsBundleCache>();
+    }
+
+    if (notifier_ == nullptr) {
+        notifier_ = std::make_shared<BatteryStatsNotifier>();
+        std::weak_ptr<BatteryStatsNotifier> weakNotifier = notifier_;
+        core_->SetComputeCallback([weakNotifier](const std::vector<std::shared_ptr<BatteryStatsInfo>>& statsInfos,
+            double totalPowerMah, uint64_t epoch) {
+            auto notifier = weakNotifier.lock();
+            if (notifier != nullptr) {
+                notifier->OnComputed(statsInfos, totalPowerMah, epoch);
+            }
+        });
+        std::weak_ptr<BatteryStatsCore> weakCore = core_;
+        notifier_->SetComputeTrigger([weakCore]() {
+            auto core = weakCore.lock();
+            if (core != nullptr) {
+                core->ComputePower();
+            }
+        });
+    }
+
     return true;
 }
 
@@ -153,6 +182,10 @@ bool BatteryStatsService::SubscribeCommonEvent()
     MatchingSkills matchingSkills;
     matchingSkills.AddEvent(CommonEventSupport::COMMON_EVENT_SHUTDOWN);
     matchingSkills.AddEvent(CommonEventSupport::COMMON_EVENT_BATTERY_CHANGED);
+    matchingSkills.AddEvent(CommonEventSupport::COMMON_EVENT_PACKAGE_ADDED);
+    matchingSkills.AddEvent(CommonEventSupport::COMMON_EVENT_PACKAGE_REMOVED);
+    matchingSkills.AddEvent(CommonEventSupport::COMMON_EVENT_USER_SWITCHED);
+    matchingSkills.AddEvent(CommonEventSupport::COMMON_EVENT_USER_REMOVED);
     CommonEventSubscribeInfo subscribeInfo(matchingSkills);
     subscribeInfo.SetThreadMode(CommonEventSubscribeInfo::ThreadMode::COMMON);
     if (!subscriberPtr_) {
@@ -190,17 +223,80 @@ bool BatteryStatsService::IsServiceReady() const
 
 BatteryStatsInfoList BatteryStatsService::GetBatteryStats()
 {
+    // Taken before queueing on the lock, callers queued behind a running pass then share the next one
+    uint64_t ticket = core_->GetComputeTicket();
     std::lock_guard lock(mutex_);
     BatteryStatsInfoList statsInfoList = {};
     if (!Permission::IsSystem()) {
         lastError_ = static_cast<int32_t>(StatsError::ERR_SYSTEM_API_DENIED);
         return statsInfoList;
     }
-    core_->ComputePower();
+    core_->ComputePowerShared(ticket);
     statsInfoList = core_->GetBatteryStats();
     return statsInfoList;
 }
 
+sptr<Ashmem> BatteryStatsService::GetBatteryStatsAshmem()
+{
+    uint64_t ticket = core_->GetComputeTicket();
+    std::lock_guard lock(mutex_);
+    if (!Permission::IsSystem()) {
+        lastError_ = static_cast<int32_t>(StatsError::ERR_SYSTEM_API_DENIED);
+        // The reply always carries a region, an empty one tells the caller to look at the error
+        return BatteryStatsRecordView::Pack({});
+    }
+    core_->ComputePowerShared(ticket);
+    return BatteryStatsRecordView::Pack(core_->GetBatteryStats());
+}
+
+sptr<Ashmem> BatteryStatsService::GetComputeEpochAshmem()
+{
+    if (!Permission::IsSystem()) {
+        lastError_ = static_cast<int32_t>(StatsError::ERR_SYSTEM_API_DENIED);
+        return nullptr;
+    }
+    // No compute pass here, the counter only tells the caller when one has happened
+    return core_->GetComputeEpochAshmem();
+}
+
+BatteryStatsDelta BatteryStatsService::GetBatteryStatsSince(uint64_t epoch)
+{
+    uint64_t ticket = core_->GetComputeTicket();
+    std::lock_guard lock(mutex_);
+    if (!Permission::IsSystem()) {
+        lastError_ = static_cast<int32_t>(StatsError::ERR_SYSTEM_API_DENIED);
+        return {};
+    }
+    core_->ComputePowerShared(ticket);
+    return core_->GetBatteryStatsSince(epoch);
+}
+
+bool BatteryStatsService::SubscribeStats(const sptr<IBatteryStatsCallback>& callback, const StatsSubscribeInfo& info)
+{
+    if (!Permission::IsSystem()) {
+        lastError_ = static_cast<int32_t>(StatsError::ERR_SYSTEM_API_DENIED);
+        return false;
+    }
+    if (!notifier_->Subscribe(callback, info)) {
+        lastError_ = static_cast<int32_t>(StatsError::ERR_PARAM_INVALID);
+        return false;
+    }
+    return true;
+}
+
+bool BatteryStatsService::UnsubscribeStats(const sptr<IBatteryStatsCallback>& callback)
+{
+    if (!Permission::IsSystem()) {
+        lastError_ = static_cast<int32_t>(StatsError::ERR_SYSTEM_API_DENIED);
+        return false;
+    }
+    if (!notifier_->Unsubscribe(callback)) {
+        lastError_ = static_cast<int32_t>(StatsError::ERR_PARAM_INVALID);
+        return false;
+    }
+    return true;
+}
+
 int32_t BatteryStatsService::Dump(int32_t fd, const std::vector<std::u16string>& args)
 {
     if (!isBootCompleted_) {
@@ -209,7 +305,6 @@ int32_t BatteryStatsService::Dump(int32_t fd, const std::vector<std::u16string>&
     if (!Permission::IsSystem()) {
         return ERR_PERMISSION_DENIED;
     }
-    std::lock_guard lock(mutex_);
     std::vector<std::string> argsInStr;
     std::transform(args.begin(), args.end(), std::back_inserter(argsInStr),
         [](const std::u16string &arg) {
@@ -217,59 +312,107 @@ int32_t BatteryStatsService::Dump(int32_t fd, const std::vector<std::u16string>&
         STATS_HILOGD(COMP_SVC, "arg: %{public}s", ret.c_str());
         return ret;
     });
-    std::string result;
-    BatteryStatsDumper::Dump(argsInStr, result);
-    if (!SaveStringToFd(fd, result)) {
-        STATS_HILOGE(COMP_SVC, "Dump save to fd failed, %{public}s", result.c_str());
-        return ERR_OK;
+    // Streamed without the service lock, each section is read under the core lock and written out after it
+    if (!BatteryStatsDumper::Dump(argsInStr, fd)) {
+        STATS_HILOGE(COMP_SVC, "Dump to fd failed");
     }
     return ERR_OK;
 }
 
 double BatteryStatsService::GetAppStatsMah(const int32_t& uid)
 {
+    uint64_t ticket = core_->GetComputeTicket();
     std::lock_guard lock(mutex_);
     if (!Permission::IsSystem()) {
         lastError_ = static_cast<int32_t>(StatsError::ERR_SYSTEM_API_DENIED);
         return StatsUtils::DEFAULT_VALUE;
     }
-    core_->ComputePower();
+    core_->ComputePowerShared(ticket);
     return core_->GetAppStatsMah(uid);
 }
 
 double BatteryStatsService::GetAppStatsPercent(const int32_t& uid)
 {
+    uint64_t ticket = core_->GetComputeTicket();
     std::lock_guard lock(mutex_);
     if (!Permission::IsSystem()) {
         lastError_ = static_cast<int32_t>(StatsError::ERR_SYSTEM_API_DENIED);
         return StatsUtils::DEFAULT_VALUE;
     }
-    core_->ComputePower();
+    core_->ComputePowerShared(ticket);
     return core_->GetAppStatsPercent(uid);
 }
 
 double BatteryStatsService::GetPartStatsMah(const BatteryStatsInfo::ConsumptionType& type)
 {
+    uint64_t ticket = core_->GetComputeTicket();
     std::lock_guard lock(mutex_);
     if (!Permission::IsSystem()) {
         lastError_ = static_cast<int32_t>(StatsError::ERR_SYSTEM_API_DENIED);
         return StatsUtils::DEFAULT_VALUE;
     }
-    core_->ComputePower();
+    core_->ComputePowerShared(ticket);
     return core_->GetPartStatsMah(type);
 }
 
 double BatteryStatsService::GetPartStatsPercent(const BatteryStatsInfo::ConsumptionType& type)
 {
+    uint64_t ticket = core_->GetComputeTicket();
     std::lock_guard lock(mutex_);
     if (!Permission::IsSystem()) {
         lastError_ = static_cast<int32_t>(StatsError::ERR_SYSTEM_API_DENIED);
         return StatsUtils::DEFAULT_VALUE;
     }
-    core_->ComputePower();
+    core_->ComputePowerShared(ticket);
     return core_->GetPartStatsPercent(type);
 }
 
+AppStatsBatch BatteryStatsService::GetAppStatsBatch(const std::vector<int32_t>& uids, uint32_t fieldMask)
+{
+    uint64_t ticket = core_->GetComputeTicket();
+    std::lock_guard lock(mutex_);
+    if (!Permission::IsSystem()) {
+        lastError_ = static_cast<int32_t>(StatsError::ERR_SYSTEM_API_DENIED);
+        return {};
+    }
+    size_t maxUids = (fieldMask & APP_STATS_FIELD_BREAKDOWN) != 0 ? APP_STATS_BATCH_MAX_BREAKDOWN_UIDS :
+        APP_STATS_BATCH_MAX_UIDS;
+    if (uids.empty() || uids.size() > maxUids || (fieldMask & APP_STATS_FIELD_ALL) == 0 ||
+        (fieldMask & ~static_cast<uint32_t>(APP_STATS_FIELD_ALL)) != 0) {
+        STATS_HILOGW(COMP_SVC, "Invalid app stats batch, uid num: %{public}zu, field mask: %{public}u",
+            uids.size(), fieldMask);
+        lastError_ = static_cast<int32_t>(StatsError::ERR_PARAM_INVALID);
+        return {};
+    }
+    // Every requested value comes from the same compute pass
+    core_->ComputePowerShared(ticket);
+    return core_->GetAppStatsBatch(uids, fieldMask);
+}
+
+BatteryStatsInfoList BatteryStatsService::GetTopConsumers(uint32_t topNum, BatteryStatsInfo::ConsumptionType type,
+    uint64_t& epoch)
+{
+    uint64_t ticket = core_->GetComputeTicket();
+    std::lock_guard lock(mutex_);
+    if (!Permission::IsSystem()) {
+        lastError_ = static_cast<int32_t>(StatsError::ERR_SYSTEM_API_DENIED);
+        return {};
+    }
+    if (topNum == 0 || topNum > BatteryStatsCore::RANK_INDEX_SORTED_NUM ||
+        type < BatteryStatsInfo::CONSUMPTION_TYPE_INVALID || type > BatteryStatsInfo::CONSUMPTION_TYPE_ALARM) {
+        STATS_HILOGW(COMP_SVC, "Invalid top consumers query, num: %{public}u, type: %{public}d", topNum, type);
+        lastError_ = static_cast<int32_t>(StatsError::ERR_PARAM_INVALID);
+        return {};
+    }
+    // A caller paging through one snapshot passes back its epoch, the rank index is reused while it is current
+    if (epoch == 0 || epoch != core_->GetComputeEpoch()) {
+        core_->ComputePowerShared(ticket);
+    }
+    BatteryStatsInfoList topConsumers = core_->GetTopConsumers(topNum, type);
+    epoch = core_->GetComputeEpoch();
+    return topConsumers;
+}
+
 uint64_t BatteryStatsService::GetTotalTimeSecond(const StatsUtils::StatsType& statsType, const int32_t& uid)
 {
     if (!Permission::IsSystem()) {
@@ -277,14 +420,16 @@ uint64_t BatteryStatsService::GetTotalTimeSecond(const StatsUtils::StatsType& st
         return ERR_OK;
     }
     STATS_HILOGD(COMP_SVC, "statsType: %{public}d, uid: %{public}d", statsType, uid);
-    uint64_t timeSecond;
-    if (uid > StatsUtils::INVALID_VALUE) {
-        double timeMs = static_cast<double>(core_->GetTotalTimeMs(uid, statsType));
-        timeSecond = round(timeMs / StatsUtils::MS_IN_SECOND);
-    } else {
-        double timeMs = static_cast<double>(core_->GetTotalTimeMs(statsType));
-        timeSecond = round(timeMs / StatsUtils::MS_IN_SECOND);
-    }
+    // Timers live in rows that idle compaction may recycle, they are only read under the core lock
+    double timeMs = StatsUtils::DEFAULT_VALUE;
+    core_->RunLocked([this, &timeMs, &statsType, &uid]() {
+        if (uid > StatsUtils::INVALID_VALUE) {
+            timeMs = static_cast<double>(core_->GetTotalTimeMs(uid, statsType));
+        } else {
+            timeMs = static_cast<double>(core_->GetTotalTimeMs(statsType));
+        }
+    });
+    uint64_t timeSecond = round(timeMs / StatsUtils::MS_IN_SECOND);
     return timeSecond;
 }
 
@@ -294,7 +439,11 @@ uint64_t BatteryStatsService::GetTotalDataBytes(const StatsUtils::StatsType& sta
         lastError_ = static_cast<int32_t>(StatsError::ERR_SYSTEM_API_DENIED);
         return ERR_OK;
     }
-    return core_->GetTotalDataCount(statsType, uid);
+    uint64_t dataBytes = 0;
+    core_->RunLocked([this, &dataBytes, &statsType, &uid]() {
+        dataBytes = static_cast<uint64_t>(core_->GetTotalDataCount(statsType, uid));
+    });
+    return dataBytes;
 }
 
 void BatteryStatsService::Reset()
@@ -320,6 +469,16 @@ std::shared_ptr<BatteryStatsDetector> BatteryStatsService::GetBatteryStatsDetect
     return detector_;
 }
 
+std::shared_ptr<BatteryStatsNotifier> BatteryStatsService::GetBatteryStatsNotifier() const
+{
+    return notifier_;
+}
+
+std::shared_ptr<BatteryStatsBundleCache> BatteryStatsService::GetBatteryStatsBundleCache() const
+{
+    return bundleCache_;
+}
+
 void BatteryStatsService::SetOnBattery(bool isOnBattery)
 {
     if (!Permission::IsSystem()) {
@@ -350,6 +509,77 @@ int32_t BatteryStatsService::GetBatteryStatsIpc(ParcelableBatteryStatsList& batt
     return ERR_OK;
 }
 
+int32_t BatteryStatsService::GetBatteryStatsPackedIpc(ParcelableBatteryStatsList& batteryStats, int32_t& tempError)
+{
+    StatsXCollie statsXCollie("BatteryStatsService::GetBatteryStatsPackedIpc", false);
+    // Only callers that read the packed layout use this code, GetBatteryStatsIpc keeps the legacy one
+    batteryStats.isPacked_ = true;
+    batteryStats.statsList_ = GetBatteryStats();
+    tempError = lastError_.load();
+    lastError_ = static_cast<int32_t>(StatsError::ERR_OK);
+    return ERR_OK;
+}
+
+int32_t BatteryStatsService::GetBatteryStatsAshmemIpc(sptr<Ashmem>& statsAshmem, int32_t& tempError)
+{
+    StatsXCollie statsXCollie("BatteryStatsService::GetBatteryStatsAshmemIpc", false);
+    statsAshmem = GetBatteryStatsAshmem();
+    tempError = lastError_.load();
+    lastError_ = static_cast<int32_t>(StatsError::ERR_OK);
+    return statsAshmem != nullptr ? ERR_OK : ERR_NO_MEMORY;
+}
+
+int32_t BatteryStatsService::GetComputeEpochAshmemIpc(sptr<Ashmem>& epochAshmem, int32_t& tempError)
+{
+    StatsXCollie statsXCollie("BatteryStatsService::GetComputeEpochAshmemIpc", false);
+    epochAshmem = GetComputeEpochAshmem();
+    tempError = lastError_.load();
+    lastError_ = static_cast<int32_t>(StatsError::ERR_OK);
+    return epochAshmem != nullptr ? ERR_OK : ERR_NO_MEMORY;
+}
+
+int32_t BatteryStatsService::GetBatteryStatsSinceIpc(uint64_t epoch, ParcelableBatteryStatsList& changed,
+    ParcelableBatteryStatsList& removed, uint64_t& currentEpoch, bool& isFull, int32_t& tempError)
+{
+    StatsXCollie statsXCollie("BatteryStatsService::GetBatteryStatsSinceIpc", false);
+    BatteryStatsDelta delta = GetBatteryStatsSince(epoch);
+    changed.isPacked_ = true;
+    removed.isPacked_ = true;
+    changed.statsList_ = std::move(delta.changed);
+    removed.statsList_ = std::move(delta.removed);
+    currentEpoch = delta.epoch;
+    isFull = delta.isFull;
+    tempError = lastError_.load();
+    lastError_ = static_cast<int32_t>(StatsError::ERR_OK);
+    return ERR_OK;
+}
+
+int32_t BatteryStatsService::SubscribeStatsIpc(const sptr<IBatteryStatsCallback>& callback,
+    const std::vector<int32_t>& uids, const std::vector<int32_t>& types, double minDeltaMah, double minDeltaPercent,
+    int64_t minIntervalMs, int32_t& tempError)
+{
+    StatsXCollie statsXCollie("BatteryStatsService::SubscribeStatsIpc", false);
+    StatsSubscribeInfo info;
+    info.uids = uids;
+    info.types = types;
+    info.minDeltaMah = minDeltaMah;
+    info.minDeltaPercent = minDeltaPercent;
+    info.minIntervalMs = minIntervalMs;
+    SubscribeStats(callback, info);
+    tempError = lastError_.load();
+    lastError_ = static_cast<int32_t>(StatsError::ERR_OK);
+    return ERR_OK;
+}
+
+int32_t BatteryStatsService::UnsubscribeStatsIpc(const sptr<IBatteryStatsCallback>& callback, int32_t& tempError)
+{
+    StatsXCollie statsXCollie("BatteryStatsService::UnsubscribeStatsIpc", false);
+    UnsubscribeStats(callback);
+    tempError = lastError_.load();
+    lastError_ = static_cast<int32_t>(StatsError::ERR_OK);
+    return ERR_OK;
+}
+
 int32_t BatteryStatsService::GetAppStatsMahIpc(int32_t uid, double& appStatsMah, int32_t& tempError)
 {
     StatsXCollie statsXCollie("BatteryStatsService::GetAppStatsMahIpc", false);
@@ -421,6 +651,34 @@ int32_t BatteryStatsService::ShellDumpIpc(const std::vector<std::string>& args,
     return ERR_OK;
 }
 
+int32_t BatteryStatsService::GetAppStatsBatchIpc(const std::vector<int32_t>& uids, uint32_t fieldMask,
+    std::vector<double>& appStatsMah, std::vector<double>& appStatsPercent,
+    ParcelableBatteryStatsList& breakdown, int32_t& tempError)
+{
+    StatsXCollie statsXCollie("BatteryStatsService::GetAppStatsBatchIpc", false);
+    AppStatsBatch batch = GetAppStatsBatch(uids, fieldMask);
+    appStatsMah = std::move(batch.appStatsMah);
+    appStatsPercent = std::move(batch.appStatsPercent);
+    breakdown.isPacked_ = true;
+    breakdown.statsList_ = std::move(batch.breakdown);
+    tempError = lastError_.load();
+    lastError_ = static_cast<int32_t>(StatsError::ERR_OK);
+    return ERR_OK;
+}
+
+int32_t BatteryStatsService::GetTopConsumersIpc(uint32_t topNum, int32_t type, uint64_t epoch,
+    ParcelableBatteryStatsList& topConsumers, uint64_t& currentEpoch, int32_t& tempError)
+{
+    StatsXCollie statsXCollie("BatteryStatsService::GetTopConsumersIpc", false);
+    currentEpoch = epoch;
+    topConsumers.isPacked_ = true;
+    topConsumers.statsList_ = GetTopConsumers(topNum, static_cast<BatteryStatsInfo::ConsumptionType>(type),
+        currentEpoch);
+    tempError = lastError_.load();
+    lastError_ = static_cast<int32_t>(StatsError::ERR_OK);
+    return ERR_OK;
+}
+
 void BatteryStatsService::DestroyInstance()
 {
     std::lock_guard<std::mutex> lock(singletonMutex_);
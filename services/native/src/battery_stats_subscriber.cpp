@@ -30,6 +30,7 @@ namespace OHOS {
 namespace PowerMgr {
 namespace {
     const int32_t BATTERY_LEVEL_FULL = 100;
+    const std::string COMMON_EVENT_KEY_UID = "uid";
 }
 void BatteryStatsSubscriber::OnReceiveEvent(const OHOS::EventFwk::CommonEventData &data)
 {
@@ -59,6 +60,26 @@ void BatteryStatsSubscriber::OnReceiveEvent(const OHOS::EventFwk::CommonEventDat
         } else {
             StatsHelper::SetOnBattery(false);
         }
+    } else if (action == OHOS::EventFwk::CommonEventSupport::COMMON_EVENT_USER_SWITCHED ||
+        action == OHOS::EventFwk::CommonEventSupport::COMMON_EVENT_USER_REMOVED) {
+        STATS_HILOGI(COMP_SVC, "Received %{public}s event", action.c_str());
+        statsService->GetBatteryStatsCore()->RefreshUserMap();
+    } else if (action == OHOS::EventFwk::CommonEventSupport::COMMON_EVENT_PACKAGE_ADDED ||
+        action == OHOS::EventFwk::CommonEventSupport::COMMON_EVENT_PACKAGE_REMOVED) {
+        int32_t uid = data.GetWant().GetIntParam(COMMON_EVENT_KEY_UID, StatsUtils::INVALID_VALUE);
+        STATS_HILOGD(COMP_SVC, "Received %{public}s event, uid=%{public}d", action.c_str(), uid);
+        if (action == OHOS::EventFwk::CommonEventSupport::COMMON_EVENT_PACKAGE_REMOVED) {
+            statsService->GetBatteryStatsCore()->RemoveUid(uid);
+        }
+        auto bundleCache = statsService->GetBatteryStatsBundleCache();
+        if (bundleCache == nullptr) {
+            return;
+        }
+        if (uid == StatsUtils::INVALID_VALUE) {
+            bundleCache->Clear();
+        } else {
+            bundleCache->Invalidate(uid);
+        }
     }
 }
 } // namespace PowerMgr
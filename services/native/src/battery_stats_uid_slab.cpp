@@ -0,0 +1,215 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "battery_stats_uid_slab.h"
+
+#include "stats_log.h"
+
+namespace OHOS {
+namespace PowerMgr {
+BatteryStatsUidSlab::Row* BatteryStatsUidSlab::FindRowLocked(int32_t uid)
+{
+    if (lastRow_ != nullptr && lastRow_->uid == uid) {
+        return lastRow_;
+    }
+    auto iter = indexMap_.find(uid);
+    if (iter == indexMap_.end()) {
+        return nullptr;
+    }
+    lastRow_ = &rows_[iter->second];
+    return lastRow_;
+}
+
+BatteryStatsUidSlab::Row& BatteryStatsUidSlab::GetOrCreateRowLocked(int32_t uid)
+{
+    Row* row = FindRowLocked(uid);
+    if (row != nullptr) {
+        return *row;
+    }
+    uint32_t index = 0;
+    if (!freeRows_.empty()) {
+        index = freeRows_.back();
+        freeRows_.pop_back();
+        // A recycled row must not carry any time or count of the uid it was released by
+        Row& freeRow = rows_[index];
+        freeRow.timerMask = 0;
+        freeRow.counterMask = 0;
+        for (auto& timer : freeRow.timers) {
+            timer.Reset();
+        }
+        for (auto& counter : freeRow.counters) {
+            counter.Reset();
+        }
+    } else {
+        index = static_cast<uint32_t>(rows_.size());
+        rows_.emplace_back();
+    }
+    STATS_HILOGD(COMP_SVC, "Create slab row: %{public}u for uid: %{public}d", index, uid);
+    indexMap_.emplace(uid, index);
+    lastRow_ = &rows_[index];
+    lastRow_->uid = uid;
+    return *lastRow_;
+}
+
+void BatteryStatsUidSlab::ReleaseRowLocked(Row& row)
+{
+    if (row.timerMask != 0 || row.counterMask != 0) {
+        return;
+    }
+    auto iter = indexMap_.find(row.uid);
+    if (iter != indexMap_.end()) {
+        freeRows_.push_back(iter->second);
+        indexMap_.erase(iter);
+    }
+    if (lastRow_ == &row) {
+        lastRow_ = nullptr;
+    }
+    row.uid = StatsUtils::INVALID_VALUE;
+}
+
+std::shared_ptr<StatsHelper::ActiveTimer> BatteryStatsUidSlab::GetOrCreateTimer(int32_t uid, TimerSlot slot)
+{
+    if (slot >= TIMER_SLOT_NUM) {
+        return nullptr;
+    }
+    std::lock_guard lock(mutex_);
+    Row& row = GetOrCreateRowLocked(uid);
+    row.timerMask |= 1U << slot;
+    // Aliasing an empty owner, the slab keeps the timer alive
+    return std::shared_ptr<StatsHelper::ActiveTimer>(std::shared_ptr<void>(), &row.timers[slot]);
+}
+
+std::shared_ptr<StatsHelper::Counter> BatteryStatsUidSlab::GetOrCreateCounter(int32_t uid, CounterSlot slot)
+{
+    if (slot >= COUNTER_SLOT_NUM) {
+        return nullptr;
+    }
+    std::lock_guard lock(mutex_);
+    Row& row = GetOrCreateRowLocked(uid);
+    row.counterMask |= 1U << slot;
+    return std::shared_ptr<StatsHelper::Counter>(std::shared_ptr<void>(), &row.counters[slot]);
+}
+
+StatsHelper::ActiveTimer* BatteryStatsUidSlab::GetTimer(int32_t uid, TimerSlot slot)
+{
+    if (slot >= TIMER_SLOT_NUM) {
+        return nullptr;
+    }
+    std::lock_guard lock(mutex_);
+    Row* row = FindRowLocked(uid);
+    if (row == nullptr || (row->timerMask & (1U << slot)) == 0) {
+        return nullptr;
+    }
+    return &row->timers[slot];
+}
+
+StatsHelper::Counter* BatteryStatsUidSlab::GetCounter(int32_t uid, CounterSlot slot)
+{
+    if (slot >= COUNTER_SLOT_NUM) {
+        return nullptr;
+    }
+    std::lock_guard lock(mutex_);
+    Row* row = FindRowLocked(uid);
+    if (row == nullptr || (row->counterMask & (1U << slot)) == 0) {
+        return nullptr;
+    }
+    return &row->counters[slot];
+}
+
+size_t BatteryStatsUidSlab::ReleaseTimer(int32_t uid, TimerSlot slot)
+{
+    if (slot >= TIMER_SLOT_NUM) {
+        return 0;
+    }
+    std::lock_guard lock(mutex_);
+    Row* row = FindRowLocked(uid);
+    if (row == nullptr || (row->timerMask & (1U << slot)) == 0) {
+        return 0;
+    }
+    row->timerMask &= ~(1U << slot);
+    row->timers[slot].Reset();
+    ReleaseRowLocked(*row);
+    return 1;
+}
+
+size_t BatteryStatsUidSlab::ReleaseCounter(int32_t uid, CounterSlot slot)
+{
+    if (slot >= COUNTER_SLOT_NUM) {
+        return 0;
+    }
+    std::lock_guard lock(mutex_);
+    Row* row = FindRowLocked(uid);
+    if (row == nullptr || (row->counterMask & (1U << slot)) == 0) {
+        return 0;
+    }
+    row->counterMask &= ~(1U << slot);
+    row->counters[slot].Reset();
+    ReleaseRowLocked(*row);
+    return 1;
+}
+
+void BatteryStatsUidSlab::ResetTimers(TimerSlot slot)
+{
+    if (slot >= TIMER_SLOT_NUM) {
+        return;
+    }
+    std::lock_guard lock(mutex_);
+    for (auto& row : rows_) {
+        if ((row.timerMask & (1U << slot)) != 0) {
+            row.timers[slot].Reset();
+        }
+    }
+}
+
+void BatteryStatsUidSlab::ResetCounters(CounterSlot slot)
+{
+    if (slot >= COUNTER_SLOT_NUM) {
+        return;
+    }
+    std::lock_guard lock(mutex_);
+    for (auto& row : rows_) {
+        if ((row.counterMask & (1U << slot)) != 0) {
+            row.counters[slot].Reset();
+        }
+    }
+}
+
+bool BatteryStatsUidSlab::IsRowActive(int32_t uid)
+{
+    std::lock_guard lock(mutex_);
+    Row* row = FindRowLocked(uid);
+    if (row == nullptr) {
+        return false;
+    }
+    for (uint32_t slot = 0; slot < TIMER_SLOT_NUM; slot++) {
+        if ((row->timerMask & (1U << slot)) != 0 && row->timers[slot].IsRunning()) {
+            return true;
+        }
+    }
+    for (uint32_t slot = 0; slot < COUNTER_SLOT_NUM; slot++) {
+        if ((row->counterMask & (1U << slot)) != 0 && row->counters[slot].GetCount() != StatsUtils::DEFAULT_VALUE) {
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t BatteryStatsUidSlab::GetRowNum()
+{
+    std::lock_guard lock(mutex_);
+    return indexMap_.size();
+}
+} // namespace PowerMgr
+} // namespace OHOS
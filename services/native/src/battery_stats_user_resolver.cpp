@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "battery_stats_user_resolver.h"
+
+#include "ohos_account_kits.h"
+#include "stats_log.h"
+
+namespace OHOS {
+namespace PowerMgr {
+int32_t BatteryStatsUserResolver::GetUserId(int32_t uid)
+{
+    if (uid >= 0) {
+        return uid / UID_RANGE_PER_USER;
+    }
+    {
+        std::lock_guard lock(mutex_);
+        auto iter = userMap_.find(uid);
+        if (iter != userMap_.end()) {
+            return iter->second;
+        }
+    }
+    int32_t userId = AccountSA::OhosAccountKits::GetInstance().GetDeviceAccountIdByUID(uid);
+    STATS_HILOGD(COMP_SVC, "Resolve user: %{public}d for uid: %{public}d", userId, uid);
+    std::lock_guard lock(mutex_);
+    userMap_[uid] = userId;
+    return userId;
+}
+
+void BatteryStatsUserResolver::Refresh()
+{
+    std::lock_guard lock(mutex_);
+    STATS_HILOGI(COMP_SVC, "Refresh user map, drop %{public}zu uids", userMap_.size());
+    userMap_.clear();
+}
+
+size_t BatteryStatsUserResolver::GetCachedNum()
+{
+    std::lock_guard lock(mutex_);
+    return userMap_.size();
+}
+} // namespace PowerMgr
+} // namespace OHOS
@@ -139,6 +139,16 @@ std::vector<int64_t> CpuTimeReader::GetUidCpuTimeMs(int32_t uid)
     return cpuTimeVec;
 }
 
+size_t CpuTimeReader::RemoveUid(int32_t uid)
+{
+    // The last read values stay as the baseline, a row still listed by the kernel is not counted twice
+    size_t count = activeTimeMap_.erase(uid);
+    count += clusterTimeMap_.erase(uid);
+    count += freqTimeMap_.erase(uid);
+    count += uidTimeMap_.erase(uid);
+    return count;
+}
+
 bool CpuTimeReader::UpdateCpuTime()
 {
     bool result = true;
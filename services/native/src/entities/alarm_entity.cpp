@@ -34,9 +34,9 @@ int64_t AlarmEntity::GetConsumptionCount(StatsUtils::StatsType statsType, int32_
 {
     int64_t count = StatsUtils::DEFAULT_VALUE;
     if (statsType == StatsUtils::STATS_TYPE_ALARM) {
-        auto almIter = alarmCounterMap_.find(uid);
-        if (almIter != alarmCounterMap_.end()) {
-            count = almIter->second->GetCount();
+        auto counter = uidSlab_.GetCounter(uid, BatteryStatsUidSlab::COUNTER_ALARM);
+        if (counter != nullptr) {
+            count = counter->GetCount();
             STATS_HILOGD(COMP_SVC, "Get alarm count: %{public}" PRId64 " for uid: %{public}d", count, uid);
         }
         STATS_HILOGD(COMP_SVC, "No alarm count related to uid: %{public}d was found, return 0", uid);
@@ -49,25 +49,25 @@ void AlarmEntity::Calculate(int32_t uid)
     auto bss = BatteryStatsService::GetInstance();
     auto alarmOnAverageMa = bss->GetBatteryStatsParser()->GetAveragePowerMa(StatsUtils::CURRENT_ALARM_ON);
     auto alarmOnCount = GetConsumptionCount(StatsUtils::STATS_TYPE_ALARM, uid);
-    auto alarmOnPowerMah = alarmOnAverageMa * alarmOnCount;
-    auto iter = alarmPowerMap_.find(uid);
-    if (iter != alarmPowerMap_.end()) {
+    int64_t alarmOnEnergyNah = StatsUtils::ConvertToEnergyNah(alarmOnAverageMa * alarmOnCount);
+    auto iter = alarmEnergyMap_.find(uid);
+    if (iter != alarmEnergyMap_.end()) {
         STATS_HILOGD(COMP_SVC, "Update alarm on power consumption: %{public}lfmAh for uid: %{public}d",
             alarmOnAverageMa, uid);
-        iter->second = alarmOnPowerMah;
+        iter->second = alarmOnEnergyNah;
     } else {
         STATS_HILOGD(COMP_SVC, "Create alarm on power consumption: %{public}lfmAh for uid: %{public}d",
             alarmOnAverageMa, uid);
-        alarmPowerMap_.insert(std::pair<int32_t, double>(uid, alarmOnPowerMah));
+        alarmEnergyMap_.insert(std::pair<int32_t, int64_t>(uid, alarmOnEnergyNah));
     }
 }
 
 double AlarmEntity::GetEntityPowerMah(int32_t uidOrUserId)
 {
     double power = StatsUtils::DEFAULT_VALUE;
-    auto iter = alarmPowerMap_.find(uidOrUserId);
-    if (iter != alarmPowerMap_.end()) {
-        power = iter->second;
+    auto iter = alarmEnergyMap_.find(uidOrUserId);
+    if (iter != alarmEnergyMap_.end()) {
+        power = StatsUtils::ConvertToPowerMah(iter->second);
         STATS_HILOGD(COMP_SVC, "Get app alarm power consumption: %{public}lfmAh for uid: %{public}d",
             power, uidOrUserId);
     } else {
@@ -81,9 +81,9 @@ double AlarmEntity::GetStatsPowerMah(StatsUtils::StatsType statsType, int32_t ui
 {
     double power = StatsUtils::DEFAULT_VALUE;
     if (statsType == StatsUtils::STATS_TYPE_ALARM) {
-        auto alarmOnIter = alarmPowerMap_.find(uid);
-        if (alarmOnIter != alarmPowerMap_.end()) {
-            power = alarmOnIter->second;
+        auto alarmOnIter = alarmEnergyMap_.find(uid);
+        if (alarmOnIter != alarmEnergyMap_.end()) {
+            power = StatsUtils::ConvertToPowerMah(alarmOnIter->second);
             STATS_HILOGD(COMP_SVC, "Get alarm on power consumption: %{public}lfmAh for uid: %{public}d",
                 power, uid);
         } else {
@@ -100,30 +100,23 @@ std::shared_ptr<StatsHelper::Counter> AlarmEntity::GetOrCreateCounter(StatsUtils
         return nullptr;
     }
 
-    auto alarmOnIter = alarmCounterMap_.find(uid);
-    if (alarmOnIter != alarmCounterMap_.end()) {
-        STATS_HILOGD(COMP_SVC, "Get alarm on counter for uid: %{public}d", uid);
-        return alarmOnIter->second;
-    }
-    STATS_HILOGD(COMP_SVC, "Create alarm on counter for uid: %{public}d", uid);
-    std::shared_ptr<StatsHelper::Counter> alarmCounter = std::make_shared<StatsHelper::Counter>();
-    alarmCounterMap_.insert(std::pair<int32_t, std::shared_ptr<StatsHelper::Counter>>(uid, alarmCounter));
-    return alarmCounter;
+    return uidSlab_.GetOrCreateCounter(uid, BatteryStatsUidSlab::COUNTER_ALARM);
+}
+
+size_t AlarmEntity::RemoveUid(int32_t uid)
+{
+    return uidSlab_.ReleaseCounter(uid, BatteryStatsUidSlab::COUNTER_ALARM) + alarmEnergyMap_.erase(uid);
 }
 
 void AlarmEntity::Reset()
 {
     // Reset app Alarm on total power consumption
-    for (auto& iter : alarmPowerMap_) {
+    for (auto& iter : alarmEnergyMap_) {
         iter.second = StatsUtils::DEFAULT_VALUE;
     }
 
     // Reset Alarm on counter
-    for (auto& iter : alarmCounterMap_) {
-        if (iter.second) {
-            iter.second->Reset();
-        }
-    }
+    uidSlab_.ResetCounters(BatteryStatsUidSlab::COUNTER_ALARM);
 }
 } // namespace PowerMgr
 } // namespace OHOS
\ No newline at end of file
@@ -35,9 +35,9 @@ int64_t AudioEntity::GetActiveTimeMs(int32_t uid, StatsUtils::StatsType statsTyp
     int64_t activeTimeMs = StatsUtils::DEFAULT_VALUE;
     switch (statsType) {
         case StatsUtils::STATS_TYPE_AUDIO_ON: {
-            auto iter = audioTimerMap_.find(uid);
-            if (iter != audioTimerMap_.end()) {
-                activeTimeMs = iter->second->GetRunningTimeMs();
+            auto timer = uidSlab_.GetTimer(uid, BatteryStatsUidSlab::TIMER_AUDIO_ON);
+            if (timer != nullptr) {
+                activeTimeMs = timer->GetRunningTimeMs();
                 STATS_HILOGD(COMP_SVC, "Get audio on time: %{public}" PRId64 "ms for uid: %{public}d",
                     activeTimeMs, uid);
                 break;
@@ -56,25 +56,25 @@ void AudioEntity::Calculate(int32_t uid)
     auto bss = BatteryStatsService::GetInstance();
     auto audioOnAverageMa = bss->GetBatteryStatsParser()->GetAveragePowerMa(StatsUtils::CURRENT_AUDIO_ON);
     auto audioOnTimeMs = GetActiveTimeMs(uid, StatsUtils::STATS_TYPE_AUDIO_ON);
-    auto audioOnPowerMah = audioOnAverageMa * audioOnTimeMs / StatsUtils::MS_IN_HOUR;
-    auto iter = audioPowerMap_.find(uid);
-    if (iter != audioPowerMap_.end()) {
+    int64_t audioOnEnergyNah = StatsUtils::ConvertToEnergyNah(audioOnAverageMa, audioOnTimeMs);
+    auto iter = audioEnergyMap_.find(uid);
+    if (iter != audioEnergyMap_.end()) {
         STATS_HILOGD(COMP_SVC, "Update audio on power consumption: %{public}lfmAh for uid: %{public}d",
             audioOnAverageMa, uid);
-        iter->second = audioOnPowerMah;
+        iter->second = audioOnEnergyNah;
     } else {
         STATS_HILOGD(COMP_SVC, "Create audio on power consumption: %{public}lfmAh for uid: %{public}d",
-            audioOnPowerMah, uid);
-        audioPowerMap_.insert(std::pair<int32_t, double>(uid, audioOnPowerMah));
+            StatsUtils::ConvertToPowerMah(audioOnEnergyNah), uid);
+        audioEnergyMap_.insert(std::pair<int32_t, int64_t>(uid, audioOnEnergyNah));
     }
 }
 
 double AudioEntity::GetEntityPowerMah(int32_t uidOrUserId)
 {
     double power = StatsUtils::DEFAULT_VALUE;
-    auto iter = audioPowerMap_.find(uidOrUserId);
-    if (iter != audioPowerMap_.end()) {
-        power = iter->second;
+    auto iter = audioEnergyMap_.find(uidOrUserId);
+    if (iter != audioEnergyMap_.end()) {
+        power = StatsUtils::ConvertToPowerMah(iter->second);
         STATS_HILOGD(COMP_SVC, "Get app audio power consumption: %{public}lfmAh for uid: %{public}d",
             power, uidOrUserId);
     } else {
@@ -88,9 +88,9 @@ double AudioEntity::GetStatsPowerMah(StatsUtils::StatsType statsType, int32_t ui
 {
     double power = StatsUtils::DEFAULT_VALUE;
     if (statsType == StatsUtils::STATS_TYPE_AUDIO_ON) {
-        auto audioOnIter = audioPowerMap_.find(uid);
-        if (audioOnIter != audioPowerMap_.end()) {
-            power = audioOnIter->second;
+        auto audioOnIter = audioEnergyMap_.find(uid);
+        if (audioOnIter != audioEnergyMap_.end()) {
+            power = StatsUtils::ConvertToPowerMah(audioOnIter->second);
             STATS_HILOGD(COMP_SVC, "Get audio on power consumption: %{public}lfmAh for uid: %{public}d",
                 power, uid);
         } else {
@@ -107,16 +107,7 @@ std::shared_ptr<StatsHelper::ActiveTimer> AudioEntity::GetOrCreateTimer(int32_t
     std::shared_ptr<StatsHelper::ActiveTimer> timer = nullptr;
     switch (statsType) {
         case StatsUtils::STATS_TYPE_AUDIO_ON: {
-            auto audioOnIter = audioTimerMap_.find(uid);
-            if (audioOnIter != audioTimerMap_.end()) {
-                STATS_HILOGD(COMP_SVC, "Get audio on timer for uid: %{public}d", uid);
-                timer = audioOnIter->second;
-                break;
-            }
-            STATS_HILOGD(COMP_SVC, "Create audio on timer for uid: %{public}d", uid);
-            std::shared_ptr<StatsHelper::ActiveTimer> audioTimer = std::make_shared<StatsHelper::ActiveTimer>();
-            audioTimerMap_.insert(std::pair<int32_t, std::shared_ptr<StatsHelper::ActiveTimer>>(uid, audioTimer));
-            timer = audioTimer;
+            timer = uidSlab_.GetOrCreateTimer(uid, BatteryStatsUidSlab::TIMER_AUDIO_ON);
             break;
         }
         default:
@@ -126,19 +117,20 @@ std::shared_ptr<StatsHelper::ActiveTimer> AudioEntity::GetOrCreateTimer(int32_t
     return timer;
 }
 
+size_t AudioEntity::RemoveUid(int32_t uid)
+{
+    return uidSlab_.ReleaseTimer(uid, BatteryStatsUidSlab::TIMER_AUDIO_ON) + audioEnergyMap_.erase(uid);
+}
+
 void AudioEntity::Reset()
 {
     // Reset app Audio on total power consumption
-    for (auto& iter : audioPowerMap_) {
+    for (auto& iter : audioEnergyMap_) {
         iter.second = StatsUtils::DEFAULT_VALUE;
     }
 
     // Reset Audio on timer
-    for (auto& iter : audioTimerMap_) {
-        if (iter.second) {
-            iter.second->Reset();
-        }
-    }
+    uidSlab_.ResetTimers(BatteryStatsUidSlab::TIMER_AUDIO_ON);
 }
 } // namespace PowerMgr
 } // namespace OHOS
\ No newline at end of file
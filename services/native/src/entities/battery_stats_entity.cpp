@@ -18,10 +18,17 @@
 
 namespace OHOS {
 namespace PowerMgr {
-double BatteryStatsEntity::totalPowerMah_ = StatsUtils::DEFAULT_VALUE;
-BatteryStatsInfoList BatteryStatsEntity::statsInfoList_;
+int64_t BatteryStatsEntity::totalEnergyNah_ = StatsUtils::DEFAULT_VALUE;
+BatteryStatsEntity::StatsInfoVector BatteryStatsEntity::statsInfoList_;
+BatteryStatsInfoPool BatteryStatsEntity::statsInfoPool_;
+BatteryStatsUidSlab BatteryStatsEntity::uidSlab_;
 
-void BatteryStatsEntity::AggregateUserPowerMah(int32_t userId, double power)
+int64_t BatteryStatsEntity::GetEntityEnergyNah(int32_t uidOrUserId)
+{
+    return StatsUtils::ConvertToEnergyNah(GetEntityPowerMah(uidOrUserId));
+}
+
+void BatteryStatsEntity::AggregateUserEnergyNah(int32_t userId, int64_t energyNah)
 {
     STATS_HILOGE(COMP_SVC, "No need to add app power to related user");
 }
@@ -44,10 +51,20 @@ int64_t BatteryStatsEntity::GetConsumptionCount(StatsUtils::StatsType statsType,
 }
 
 BatteryStatsInfoList BatteryStatsEntity::GetStatsInfoList()
+{
+    return BatteryStatsInfoList(statsInfoList_.begin(), statsInfoList_.end());
+}
+
+const BatteryStatsEntity::StatsInfoVector& BatteryStatsEntity::GetStatsInfos()
 {
     return statsInfoList_;
 }
 
+const BatteryStatsInfoPool& BatteryStatsEntity::GetStatsInfoPool()
+{
+    return statsInfoPool_;
+}
+
 void BatteryStatsEntity::UpdateStatsInfoList(std::shared_ptr<BatteryStatsInfo> info)
 {
     statsInfoList_.push_back(info);
@@ -65,6 +82,12 @@ int64_t BatteryStatsEntity::GetActiveTimeMs(StatsUtils::StatsType statsType, int
     return StatsUtils::DEFAULT_VALUE;
 }
 
+void BatteryStatsEntity::GetLevelTimesMs(StatsUtils::StatsType statsType, std::vector<int64_t>& levelTimesMs)
+{
+    STATS_HILOGE(COMP_SVC, "No need to get level times");
+    levelTimesMs.clear();
+}
+
 void BatteryStatsEntity::DumpInfo(std::string& result, int32_t uid)
 {
     STATS_HILOGE(COMP_SVC, "No need to dump");
@@ -75,6 +98,11 @@ void BatteryStatsEntity::UpdateUidMap(int32_t uid)
     STATS_HILOGE(COMP_SVC, "No need to update uid");
 }
 
+void BatteryStatsEntity::UpdateUidMap(const std::vector<int32_t>& uids)
+{
+    STATS_HILOGE(COMP_SVC, "No need to update uids");
+}
+
 std::vector<int32_t> BatteryStatsEntity::GetUids()
 {
     STATS_HILOGE(COMP_SVC, "No need to get uids");
@@ -93,6 +121,17 @@ void BatteryStatsEntity::UpdateCpuTime()
     STATS_HILOGE(COMP_SVC, "No need to update cpu time");
 }
 
+size_t BatteryStatsEntity::RemoveUid(int32_t uid)
+{
+    STATS_HILOGD(COMP_SVC, "No per uid data to remove");
+    return 0;
+}
+
+bool BatteryStatsEntity::IsUidActive(int32_t uid)
+{
+    return false;
+}
+
 double BatteryStatsEntity::GetStatsPowerMah(StatsUtils::StatsType statsType, int32_t uid)
 {
     STATS_HILOGE(COMP_SVC, "No need to get stats power, return 0");
@@ -134,13 +173,13 @@ BatteryStatsInfo::ConsumptionType BatteryStatsEntity::GetConsumptionType()
 
 double BatteryStatsEntity::GetTotalPowerMah()
 {
-    return totalPowerMah_;
+    return StatsUtils::ConvertToPowerMah(totalEnergyNah_);
 }
 
 void BatteryStatsEntity::ResetStatsEntity()
 {
     STATS_HILOGI(COMP_SVC, "Reset total consumption power and battery stats list");
-    totalPowerMah_ = StatsUtils::DEFAULT_VALUE;
+    totalEnergyNah_ = StatsUtils::DEFAULT_VALUE;
     statsInfoList_.clear();
 }
 } // namespace PowerMgr
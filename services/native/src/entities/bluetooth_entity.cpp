@@ -55,24 +55,23 @@ void BluetoothEntity::CalculateBtPower()
     auto bluetoothBrOnAverageMa =
         bss->GetBatteryStatsParser()->GetAveragePowerMa(StatsUtils::CURRENT_BLUETOOTH_BR_ON);
     auto bluetoothBrOnTimeMs = GetActiveTimeMs(StatsUtils::STATS_TYPE_BLUETOOTH_BR_ON);
-    auto bluetoothBrOnPowerMah = bluetoothBrOnAverageMa * bluetoothBrOnTimeMs / StatsUtils::MS_IN_HOUR;
-    bluetoothBrPowerMah_ += bluetoothBrOnPowerMah;
+    int64_t bluetoothBrOnEnergyNah = StatsUtils::ConvertToEnergyNah(bluetoothBrOnAverageMa, bluetoothBrOnTimeMs);
+    bluetoothBrEnergyNah_ += bluetoothBrOnEnergyNah;
 
     // Calculate Bluetooth BLE on power
     auto bluetoothBleOnAverageMa =
         bss->GetBatteryStatsParser()->GetAveragePowerMa(StatsUtils::CURRENT_BLUETOOTH_BLE_ON);
     auto bluetoothBleOnTimeMs = GetActiveTimeMs(StatsUtils::STATS_TYPE_BLUETOOTH_BLE_ON);
-    auto bluetoothBleOnPowerMah = bluetoothBleOnAverageMa * bluetoothBleOnTimeMs / StatsUtils::MS_IN_HOUR;
-    bluetoothBlePowerMah_ += bluetoothBleOnPowerMah;
+    int64_t bluetoothBleOnEnergyNah = StatsUtils::ConvertToEnergyNah(bluetoothBleOnAverageMa, bluetoothBleOnTimeMs);
+    bluetoothBleEnergyNah_ += bluetoothBleOnEnergyNah;
     
-    auto bluetoothUidPowerMah = GetBluetoothUidPower();
+    int64_t bluetoothUidEnergyNah = GetBluetoothUidEnergy();
 
-    bluetoothPowerMah_ = bluetoothBrOnPowerMah + bluetoothBleOnPowerMah + bluetoothUidPowerMah;
-    totalPowerMah_ += bluetoothPowerMah_;
+    bluetoothEnergyNah_ = bluetoothBrOnEnergyNah + bluetoothBleOnEnergyNah + bluetoothUidEnergyNah;
+    totalEnergyNah_ += bluetoothEnergyNah_;
 
-    std::shared_ptr<BatteryStatsInfo> statsInfo = std::make_shared<BatteryStatsInfo>();
-    statsInfo->SetConsumptioType(BatteryStatsInfo::CONSUMPTION_TYPE_BLUETOOTH);
-    statsInfo->SetPower(bluetoothPowerMah_);
+    std::shared_ptr<BatteryStatsInfo> statsInfo = statsInfoPool_.Acquire(BatteryStatsInfo::CONSUMPTION_TYPE_BLUETOOTH);
+    statsInfo->SetPower(StatsUtils::ConvertToPowerMah(bluetoothEnergyNah_));
     statsInfoList_.push_back(statsInfo);
 
     STATS_HILOGD(COMP_SVC, "Calculate bluetooth Br time: %{public}" PRId64 "ms, Br power average: %{public}lfma,"    \
@@ -81,12 +80,12 @@ void BluetoothEntity::CalculateBtPower()
         "uid power consumption: %{public}lfmAh, total power consumption: %{public}lfmAh",
         bluetoothBrOnTimeMs,
         bluetoothBrOnAverageMa,
-        bluetoothBrOnPowerMah,
+        StatsUtils::ConvertToPowerMah(bluetoothBrOnEnergyNah),
         bluetoothBleOnTimeMs,
         bluetoothBleOnAverageMa,
-        bluetoothBleOnPowerMah,
-        bluetoothUidPowerMah,
-        bluetoothPowerMah_);
+        StatsUtils::ConvertToPowerMah(bluetoothBleOnEnergyNah),
+        StatsUtils::ConvertToPowerMah(bluetoothUidEnergyNah),
+        StatsUtils::ConvertToPowerMah(bluetoothEnergyNah_));
 }
 
 void BluetoothEntity::CalculateBtPowerForApp(int32_t uid)
@@ -96,18 +95,19 @@ void BluetoothEntity::CalculateBtPowerForApp(int32_t uid)
     auto bluetoothBrScanAverageMa =
         bss->GetBatteryStatsParser()->GetAveragePowerMa(StatsUtils::CURRENT_BLUETOOTH_BR_SCAN);
     auto bluetoothBrScanTimeMs = GetActiveTimeMs(uid, StatsUtils::STATS_TYPE_BLUETOOTH_BR_SCAN);
-    auto bluetoothBrScanPowerMah = bluetoothBrScanTimeMs * bluetoothBrScanAverageMa / StatsUtils::MS_IN_HOUR;
-    UpdateAppBluetoothBlePower(POWER_TYPE_BR, uid, bluetoothBrScanPowerMah);
+    int64_t bluetoothBrScanEnergyNah = StatsUtils::ConvertToEnergyNah(bluetoothBrScanAverageMa, bluetoothBrScanTimeMs);
+    UpdateAppBluetoothBlePower(POWER_TYPE_BR, uid, bluetoothBrScanEnergyNah);
 
     // Calculate Bluetooth Ble scan power consumption
     auto bluetoothBleScanAverageMa =
         bss->GetBatteryStatsParser()->GetAveragePowerMa(StatsUtils::CURRENT_BLUETOOTH_BLE_SCAN);
     auto bluetoothBleScanTimeMs = GetActiveTimeMs(uid, StatsUtils::STATS_TYPE_BLUETOOTH_BLE_SCAN);
-    auto bluetoothBleScanPowerMah = bluetoothBleScanTimeMs * bluetoothBleScanAverageMa / StatsUtils::MS_IN_HOUR;
-    UpdateAppBluetoothBlePower(POWER_TYPE_BLE, uid, bluetoothBleScanPowerMah);
+    int64_t bluetoothBleScanEnergyNah =
+        StatsUtils::ConvertToEnergyNah(bluetoothBleScanAverageMa, bluetoothBleScanTimeMs);
+    UpdateAppBluetoothBlePower(POWER_TYPE_BLE, uid, bluetoothBleScanEnergyNah);
 
-    auto bluetoothUidPowerMah = bluetoothBrScanPowerMah + bluetoothBleScanPowerMah;
-    UpdateAppBluetoothBlePower(POWER_TYPE_ALL, uid, bluetoothUidPowerMah);
+    int64_t bluetoothUidEnergyNah = bluetoothBrScanEnergyNah + bluetoothBleScanEnergyNah;
+    UpdateAppBluetoothBlePower(POWER_TYPE_ALL, uid, bluetoothUidEnergyNah);
 
     STATS_HILOGD(COMP_SVC, "Calculate bluetooth Br scan time: %{public}" PRId64 "ms, "                         \
         "Br scan power average: %{public}lfma, Br scan power consumption: %{public}lfmAh "                     \
@@ -115,54 +115,54 @@ void BluetoothEntity::CalculateBtPowerForApp(int32_t uid)
         "Ble scan power consumption: %{public}lfmAh, total power consumption: %{public}lfmAh, uid:%{public}d",
         bluetoothBrScanTimeMs,
         bluetoothBrScanAverageMa,
-        bluetoothBrScanPowerMah,
+        StatsUtils::ConvertToPowerMah(bluetoothBrScanEnergyNah),
         bluetoothBleScanTimeMs,
         bluetoothBleScanAverageMa,
-        bluetoothBleScanPowerMah,
-        bluetoothUidPowerMah,
+        StatsUtils::ConvertToPowerMah(bluetoothBleScanEnergyNah),
+        StatsUtils::ConvertToPowerMah(bluetoothUidEnergyNah),
         uid);
 }
 
-void BluetoothEntity::UpdateAppBluetoothBlePower(PowerType type, int32_t uid, double powerMah)
+void BluetoothEntity::UpdateAppBluetoothBlePower(PowerType type, int32_t uid, int64_t energyNah)
 {
     switch (type) {
         case POWER_TYPE_BR: {
-            auto iter = appBluetoothBrPowerMap_.find(uid);
-            if (iter != appBluetoothBrPowerMap_.end()) {
-                iter->second = powerMah;
+            auto iter = appBluetoothBrEnergyMap_.find(uid);
+            if (iter != appBluetoothBrEnergyMap_.end()) {
+                iter->second = energyNah;
                 STATS_HILOGD(COMP_SVC, "Update app bluetooth Br power consumption: %{public}lfmAh for uid: %{public}d",
-                    powerMah, uid);
+                    StatsUtils::ConvertToPowerMah(energyNah), uid);
                 break;
             }
-            appBluetoothBrPowerMap_.insert(std::pair<int32_t, double>(uid, powerMah));
+            appBluetoothBrEnergyMap_.insert(std::pair<int32_t, int64_t>(uid, energyNah));
             STATS_HILOGD(COMP_SVC, "Create app bluetooth Br power consumption: %{public}lfmAh for uid: %{public}d",
-                powerMah, uid);
+                StatsUtils::ConvertToPowerMah(energyNah), uid);
             break;
         }
         case POWER_TYPE_BLE: {
-            auto iter = appBluetoothBlePowerMap_.find(uid);
-            if (iter != appBluetoothBlePowerMap_.end()) {
-                iter->second = powerMah;
+            auto iter = appBluetoothBleEnergyMap_.find(uid);
+            if (iter != appBluetoothBleEnergyMap_.end()) {
+                iter->second = energyNah;
                 STATS_HILOGD(COMP_SVC, "Update app bluetooth Ble power consumption: %{public}lfmAh for uid: %{public}d",
-                    powerMah, uid);
+                    StatsUtils::ConvertToPowerMah(energyNah), uid);
                 break;
             }
-            appBluetoothBlePowerMap_.insert(std::pair<int32_t, double>(uid, powerMah));
+            appBluetoothBleEnergyMap_.insert(std::pair<int32_t, int64_t>(uid, energyNah));
             STATS_HILOGD(COMP_SVC, "Create app bluetooth Ble power consumption: %{public}lfmAh for uid: %{public}d",
-                powerMah, uid);
+                StatsUtils::ConvertToPowerMah(energyNah), uid);
             break;
         }
         case POWER_TYPE_ALL: {
-            auto iter = appBluetoothPowerMap_.find(uid);
-            if (iter != appBluetoothPowerMap_.end()) {
-                iter->second = powerMah;
+            auto iter = appBluetoothEnergyMap_.find(uid);
+            if (iter != appBluetoothEnergyMap_.end()) {
+                iter->second = energyNah;
                 STATS_HILOGD(COMP_SVC, "Update app bluetooth power consumption: %{public}lfmAh for uid: %{public}d",
-                    powerMah, uid);
+                    StatsUtils::ConvertToPowerMah(energyNah), uid);
                 break;
             }
-            appBluetoothPowerMap_.insert(std::pair<int32_t, double>(uid, powerMah));
+            appBluetoothEnergyMap_.insert(std::pair<int32_t, int64_t>(uid, energyNah));
             STATS_HILOGD(COMP_SVC, "Create app bluetooth power consumption: %{public}lfmAh for uid: %{public}d",
-                powerMah, uid);
+                StatsUtils::ConvertToPowerMah(energyNah), uid);
             break;
         }
         default:
@@ -175,9 +175,9 @@ int64_t BluetoothEntity::GetActiveTimeMs(int32_t uid, StatsUtils::StatsType stat
     int64_t time = StatsUtils::DEFAULT_VALUE;
     switch (statsType) {
         case StatsUtils::STATS_TYPE_BLUETOOTH_BR_SCAN: {
-            auto brScanIter = appBluetoothBrScanTimerMap_.find(uid);
-            if (brScanIter != appBluetoothBrScanTimerMap_.end()) {
-                time = brScanIter->second->GetRunningTimeMs();
+            auto timer = uidSlab_.GetTimer(uid, BatteryStatsUidSlab::TIMER_BLUETOOTH_BR_SCAN);
+            if (timer != nullptr) {
+                time = timer->GetRunningTimeMs();
                 STATS_HILOGD(COMP_SVC, "Get blueooth Br scan time: %{public}" PRId64 "ms for uid: %{public}d",
                     time, uid);
                 break;
@@ -186,9 +186,9 @@ int64_t BluetoothEntity::GetActiveTimeMs(int32_t uid, StatsUtils::StatsType stat
             break;
         }
         case StatsUtils::STATS_TYPE_BLUETOOTH_BLE_SCAN: {
-            auto bleScanIter = appBluetoothBleScanTimerMap_.find(uid);
-            if (bleScanIter != appBluetoothBleScanTimerMap_.end()) {
-                time = bleScanIter->second->GetRunningTimeMs();
+            auto timer = uidSlab_.GetTimer(uid, BatteryStatsUidSlab::TIMER_BLUETOOTH_BLE_SCAN);
+            if (timer != nullptr) {
+                time = timer->GetRunningTimeMs();
                 STATS_HILOGD(COMP_SVC, "Get blueooth Ble scan time: %{public}" PRId64 "ms for uid: %{public}d",
                     time, uid);
                 break;
@@ -234,9 +234,9 @@ double BluetoothEntity::GetEntityPowerMah(int32_t uidOrUserId)
 {
     double power = StatsUtils::DEFAULT_VALUE;
     if (uidOrUserId > StatsUtils::INVALID_VALUE) {
-        auto iter = appBluetoothPowerMap_.find(uidOrUserId);
-        if (iter != appBluetoothPowerMap_.end()) {
-            power = iter->second;
+        auto iter = appBluetoothEnergyMap_.find(uidOrUserId);
+        if (iter != appBluetoothEnergyMap_.end()) {
+            power = StatsUtils::ConvertToPowerMah(iter->second);
             STATS_HILOGD(COMP_SVC, "Get app blueooth power consumption: %{public}lfmAh for uid: %{public}d",
                 power, uidOrUserId);
         } else {
@@ -244,7 +244,7 @@ double BluetoothEntity::GetEntityPowerMah(int32_t uidOrUserId)
                 "No app blueooth power consumption related to uid: %{public}d was found, return 0", uidOrUserId);
         }
     } else {
-        power = bluetoothPowerMah_;
+        power = StatsUtils::ConvertToPowerMah(bluetoothEnergyNah_);
         STATS_HILOGD(COMP_SVC, "Get blueooth power consumption: %{public}lfmAh", power);
     }
     return power;
@@ -255,19 +255,19 @@ double BluetoothEntity::GetStatsPowerMah(StatsUtils::StatsType statsType, int32_
     double power = StatsUtils::DEFAULT_VALUE;
     switch (statsType) {
         case StatsUtils::STATS_TYPE_BLUETOOTH_BR_ON: {
-            power = bluetoothBrPowerMah_;
+            power = StatsUtils::ConvertToPowerMah(bluetoothBrEnergyNah_);
             STATS_HILOGD(COMP_SVC, "Get blueooth Br on power consumption: %{public}lfmAh", power);
             break;
         }
         case StatsUtils::STATS_TYPE_BLUETOOTH_BLE_ON: {
-            power = bluetoothBlePowerMah_;
+            power = StatsUtils::ConvertToPowerMah(bluetoothBleEnergyNah_);
             STATS_HILOGD(COMP_SVC, "Get blueooth Ble on power consumption: %{public}lfmAh", power);
             break;
         }
         case StatsUtils::STATS_TYPE_BLUETOOTH_BR_SCAN: {
-            auto brIter = appBluetoothBrPowerMap_.find(uid);
-            if (brIter != appBluetoothBrPowerMap_.end()) {
-                power = brIter->second;
+            auto brIter = appBluetoothBrEnergyMap_.find(uid);
+            if (brIter != appBluetoothBrEnergyMap_.end()) {
+                power = StatsUtils::ConvertToPowerMah(brIter->second);
                 STATS_HILOGD(COMP_SVC, "Get blueooth Br scan power consumption: %{public}lfmAh for uid: %{public}d",
                     power, uid);
                 break;
@@ -277,9 +277,9 @@ double BluetoothEntity::GetStatsPowerMah(StatsUtils::StatsType statsType, int32_
             break;
         }
         case StatsUtils::STATS_TYPE_BLUETOOTH_BLE_SCAN: {
-            auto bleIter = appBluetoothBlePowerMap_.find(uid);
-            if (bleIter != appBluetoothBlePowerMap_.end()) {
-                power = bleIter->second;
+            auto bleIter = appBluetoothBleEnergyMap_.find(uid);
+            if (bleIter != appBluetoothBleEnergyMap_.end()) {
+                power = StatsUtils::ConvertToPowerMah(bleIter->second);
                 STATS_HILOGD(COMP_SVC, "Get blueooth Ble scan power consumption: %{public}lfmAh for uid: %{public}d",
                     power, uid);
                 break;
@@ -294,12 +294,22 @@ double BluetoothEntity::GetStatsPowerMah(StatsUtils::StatsType statsType, int32_
     return power;
 }
 
+size_t BluetoothEntity::RemoveUid(int32_t uid)
+{
+    size_t count = uidSlab_.ReleaseTimer(uid, BatteryStatsUidSlab::TIMER_BLUETOOTH_BR_SCAN);
+    count += uidSlab_.ReleaseTimer(uid, BatteryStatsUidSlab::TIMER_BLUETOOTH_BLE_SCAN);
+    count += appBluetoothBrEnergyMap_.erase(uid);
+    count += appBluetoothBleEnergyMap_.erase(uid);
+    count += appBluetoothEnergyMap_.erase(uid);
+    return count;
+}
+
 void BluetoothEntity::Reset()
 {
     // Reset Bluetooth on timer and power consumption
-    bluetoothBrPowerMah_ = StatsUtils::DEFAULT_VALUE;
-    bluetoothBlePowerMah_ = StatsUtils::DEFAULT_VALUE;
-    bluetoothPowerMah_ = StatsUtils::DEFAULT_VALUE;
+    bluetoothBrEnergyNah_ = StatsUtils::DEFAULT_VALUE;
+    bluetoothBleEnergyNah_ = StatsUtils::DEFAULT_VALUE;
+    bluetoothEnergyNah_ = StatsUtils::DEFAULT_VALUE;
     if (bluetoothBrOnTimer_) {
         bluetoothBrOnTimer_->Reset();
     }
@@ -309,30 +319,21 @@ void BluetoothEntity::Reset()
     }
 
     // Reset app Bluetooth scan power consumption
-    for (auto& iter : appBluetoothBrPowerMap_) {
+    for (auto& iter : appBluetoothBrEnergyMap_) {
         iter.second = StatsUtils::DEFAULT_VALUE;
     }
 
-    for (auto& iter : appBluetoothBlePowerMap_) {
+    for (auto& iter : appBluetoothBleEnergyMap_) {
         iter.second = StatsUtils::DEFAULT_VALUE;
     }
 
-    for (auto& iter : appBluetoothPowerMap_) {
+    for (auto& iter : appBluetoothEnergyMap_) {
         iter.second = StatsUtils::DEFAULT_VALUE;
     }
 
     // Reset Bluetooth scan timer
-    for (auto& iter : appBluetoothBrScanTimerMap_) {
-        if (iter.second) {
-            iter.second->Reset();
-        }
-    }
-
-    for (auto& iter : appBluetoothBleScanTimerMap_) {
-        if (iter.second) {
-            iter.second->Reset();
-        }
-    }
+    uidSlab_.ResetTimers(BatteryStatsUidSlab::TIMER_BLUETOOTH_BR_SCAN);
+    uidSlab_.ResetTimers(BatteryStatsUidSlab::TIMER_BLUETOOTH_BLE_SCAN);
 }
 
 std::shared_ptr<StatsHelper::ActiveTimer> BluetoothEntity::GetOrCreateTimer(int32_t uid,
@@ -341,31 +342,11 @@ std::shared_ptr<StatsHelper::ActiveTimer> BluetoothEntity::GetOrCreateTimer(int3
     std::shared_ptr<StatsHelper::ActiveTimer> timer = nullptr;
     switch (statsType) {
         case StatsUtils::STATS_TYPE_BLUETOOTH_BR_SCAN: {
-            auto brScanIter = appBluetoothBrScanTimerMap_.find(uid);
-            if (brScanIter != appBluetoothBrScanTimerMap_.end()) {
-                STATS_HILOGD(COMP_SVC, "Get blueooth Br scan timer for uid: %{public}d", uid);
-                timer = brScanIter->second;
-                break;
-            }
-            STATS_HILOGD(COMP_SVC, "Create bluetooth Br scan timer for uid: %{public}d", uid);
-            std::shared_ptr<StatsHelper::ActiveTimer> brScanTimer = std::make_shared<StatsHelper::ActiveTimer>();
-            appBluetoothBrScanTimerMap_.insert(
-                std::pair<int32_t, std::shared_ptr<StatsHelper::ActiveTimer>>(uid, brScanTimer));
-            timer = brScanTimer;
+            timer = uidSlab_.GetOrCreateTimer(uid, BatteryStatsUidSlab::TIMER_BLUETOOTH_BR_SCAN);
             break;
         }
         case StatsUtils::STATS_TYPE_BLUETOOTH_BLE_SCAN: {
-            auto bleScanIter = appBluetoothBleScanTimerMap_.find(uid);
-            if (bleScanIter != appBluetoothBleScanTimerMap_.end()) {
-                STATS_HILOGD(COMP_SVC, "Get blueooth Ble scan timer for uid: %{public}d", uid);
-                timer = bleScanIter->second;
-                break;
-            }
-            STATS_HILOGD(COMP_SVC, "Create bluetooth Ble scan timer for uid: %{public}d", uid);
-            std::shared_ptr<StatsHelper::ActiveTimer> bleScanTimer = std::make_shared<StatsHelper::ActiveTimer>();
-            appBluetoothBleScanTimerMap_.insert(
-                std::pair<int32_t, std::shared_ptr<StatsHelper::ActiveTimer>>(uid, bleScanTimer));
-            timer = bleScanTimer;
+            timer = uidSlab_.GetOrCreateTimer(uid, BatteryStatsUidSlab::TIMER_BLUETOOTH_BLE_SCAN);
             break;
         }
         default:
@@ -409,21 +390,21 @@ std::shared_ptr<StatsHelper::ActiveTimer> BluetoothEntity::GetOrCreateTimer(Stat
     return timer;
 }
 
-double BluetoothEntity::GetBluetoothUidPower()
+int64_t BluetoothEntity::GetBluetoothUidEnergy()
 {
-    double bluetoothUidPower = StatsUtils::DEFAULT_VALUE;
+    int64_t bluetoothUidEnergyNah = StatsUtils::DEFAULT_VALUE;
 #ifdef SYS_MGR_CLIENT_ENABLE
     auto bundleObj =
         DelayedSingleton<AppExecFwk::SysMrgClient>::GetInstance()->GetSystemAbility(BUNDLE_MGR_SERVICE_SYS_ABILITY_ID);
     if (bundleObj == nullptr) {
         STATS_HILOGW(COMP_SVC, "Failed to get bundle manager service, return 0");
-        return bluetoothUidPower;
+        return bluetoothUidEnergyNah;
     }
 
     sptr<AppExecFwk::IBundleMgr> bmgr = iface_cast<AppExecFwk::IBundleMgr>(bundleObj);
     if (bmgr == nullptr) {
         STATS_HILOGW(COMP_SVC, "Failed to get bundle manager proxy, return 0");
-        return bluetoothUidPower;
+        return bluetoothUidEnergyNah;
     }
 
     std::string bundleName = "com.ohos.bluetooth";
@@ -435,11 +416,11 @@ double BluetoothEntity::GetBluetoothUidPower()
     auto core = bss->GetBatteryStatsCore();
     auto uidEntity = core->GetEntity(BatteryStatsInfo::CONSUMPTION_TYPE_APP);
     if (uidEntity != nullptr) {
-        bluetoothUidPower = uidEntity->GetEntityPowerMah(bluetoothUid);
+        bluetoothUidEnergyNah = uidEntity->GetEntityEnergyNah(bluetoothUid);
     }
-    STATS_HILOGD(COMP_SVC, "Get bluetooth uid power consumption: %{public}lfmAh", bluetoothUidPower);
+    STATS_HILOGD(COMP_SVC, "Get bluetooth uid energy consumption: %{public}" PRId64 "nAh", bluetoothUidEnergyNah);
 #endif
-    return bluetoothUidPower;
+    return bluetoothUidEnergyNah;
 }
 
 void BluetoothEntity::DumpInfo(std::string& result, int32_t uid)
@@ -21,6 +21,7 @@
 namespace OHOS {
 namespace PowerMgr {
 namespace {
+constexpr uint32_t TIMER_KEY_DEVICE_SHIFT = 32;
 }
 
 CameraEntity::CameraEntity()
@@ -28,18 +29,87 @@ CameraEntity::CameraEntity()
     consumptionType_ = BatteryStatsInfo::CONSUMPTION_TYPE_CAMERA;
 }
 
+CameraEntity::TimerKey CameraEntity::MakeTimerKey(uint32_t deviceIndex, int32_t uid)
+{
+    return (static_cast<TimerKey>(deviceIndex) << TIMER_KEY_DEVICE_SHIFT) | static_cast<uint32_t>(uid);
+}
+
+uint16_t CameraEntity::InternDeviceId(const std::string& deviceId)
+{
+    auto iter = deviceIndexMap_.find(deviceId);
+    if (iter != deviceIndexMap_.end()) {
+        return iter->second;
+    }
+    std::string internedId = deviceId;
+    if (deviceIds_.size() >= MAX_DEVICE_NUM) {
+        STATS_HILOGW(COMP_SVC, "Too many camera devices, count camera id: %{private}s as overflow", deviceId.c_str());
+        iter = deviceIndexMap_.find(OVERFLOW_DEVICE_ID);
+        if (iter != deviceIndexMap_.end()) {
+            return iter->second;
+        }
+        internedId = OVERFLOW_DEVICE_ID;
+    }
+    uint16_t deviceIndex = static_cast<uint16_t>(deviceIds_.size());
+    deviceIds_.push_back(internedId);
+    deviceIndexMap_.emplace(internedId, deviceIndex);
+    STATS_HILOGD(COMP_SVC, "Intern camera id: %{private}s as device: %{public}u", internedId.c_str(), deviceIndex);
+    return deviceIndex;
+}
+
+bool CameraEntity::FindDeviceIndex(const std::string& deviceId, uint16_t& deviceIndex)
+{
+    auto iter = deviceIndexMap_.find(deviceId);
+    if (iter == deviceIndexMap_.end()) {
+        return false;
+    }
+    deviceIndex = iter->second;
+    return true;
+}
+
+std::vector<std::string> CameraEntity::GetDeviceIds()
+{
+    return deviceIds_;
+}
+
+int64_t CameraEntity::GetDeviceActiveTimeMs(uint16_t deviceIndex, int32_t uid, int64_t nowMs)
+{
+    if (uid != StatsUtils::INVALID_VALUE) {
+        auto iter = cameraTimerMap_.find(MakeTimerKey(deviceIndex, uid));
+        return iter != cameraTimerMap_.end() ? iter->second.GetRunningTimeMs(nowMs) : StatsUtils::DEFAULT_VALUE;
+    }
+    int64_t activeTimeMs = StatsUtils::DEFAULT_VALUE;
+    auto endIter = cameraTimerMap_.lower_bound(MakeTimerKey(deviceIndex + 1, 0));
+    for (auto iter = cameraTimerMap_.lower_bound(MakeTimerKey(deviceIndex, 0)); iter != endIter; ++iter) {
+        activeTimeMs += iter->second.GetRunningTimeMs(nowMs);
+    }
+    return activeTimeMs;
+}
+
+int64_t CameraEntity::GetDeviceActiveTimeMs(const std::string& deviceId, int32_t uid)
+{
+    uint16_t deviceIndex = INVALID_DEVICE_INDEX;
+    if (!FindDeviceIndex(deviceId, deviceIndex)) {
+        STATS_HILOGD(COMP_SVC, "Didn't find camera id: %{private}s", deviceId.c_str());
+        return StatsUtils::DEFAULT_VALUE;
+    }
+    return GetDeviceActiveTimeMs(deviceIndex, uid, StatsHelper::GetComputeTimeMs());
+}
+
+double CameraEntity::GetDevicePowerMah(const std::string& deviceId, int32_t uid)
+{
+    auto cameraOnAverageMa =
+        BatteryStatsService::GetInstance()->GetBatteryStatsParser()->GetAveragePowerMa(StatsUtils::CURRENT_CAMERA_ON);
+    return StatsUtils::ConvertToPowerMah(
+        StatsUtils::ConvertToEnergyNah(cameraOnAverageMa, GetDeviceActiveTimeMs(deviceId, uid)));
+}
+
 int64_t CameraEntity::GetActiveTimeMs(int32_t uid, StatsUtils::StatsType statsType, int16_t level)
 {
     int64_t activeTimeMs = StatsUtils::DEFAULT_VALUE;
-    if (statsType == StatsUtils::STATS_TYPE_CAMERA_ON) {
-        for (auto& cameraIter : cameraTimerMap_) {
-            auto uidIter = cameraIter.second.find(uid);
-            if (uidIter != cameraIter.second.end()) {
-                activeTimeMs += uidIter->second->GetRunningTimeMs();
-            } else {
-                STATS_HILOGD(COMP_SVC, "Didn't find related timer for uid: %{public}d in camera id: %{private}s",
-                    uid, cameraIter.first.c_str());
-            }
+    if (statsType == StatsUtils::STATS_TYPE_CAMERA_ON && uid != StatsUtils::INVALID_VALUE) {
+        int64_t nowMs = StatsHelper::GetComputeTimeMs();
+        for (size_t deviceIndex = 0; deviceIndex < deviceIds_.size(); deviceIndex++) {
+            activeTimeMs += GetDeviceActiveTimeMs(static_cast<uint16_t>(deviceIndex), uid, nowMs);
         }
     }
     return activeTimeMs;
@@ -50,25 +120,25 @@ void CameraEntity::Calculate(int32_t uid)
     auto bss = BatteryStatsService::GetInstance();
     auto cameraOnAverageMa = bss->GetBatteryStatsParser()->GetAveragePowerMa(StatsUtils::CURRENT_CAMERA_ON);
     auto cameraOnTimeMs = GetActiveTimeMs(uid, StatsUtils::STATS_TYPE_CAMERA_ON);
-    auto cameraOnPowerMah = cameraOnAverageMa * cameraOnTimeMs / StatsUtils::MS_IN_HOUR;
-    auto iter = cameraPowerMap_.find(uid);
-    if (iter != cameraPowerMap_.end()) {
+    int64_t cameraOnEnergyNah = StatsUtils::ConvertToEnergyNah(cameraOnAverageMa, cameraOnTimeMs);
+    auto iter = cameraEnergyMap_.find(uid);
+    if (iter != cameraEnergyMap_.end()) {
         STATS_HILOGD(COMP_SVC, "Update camera on power consumption: %{public}lfmAh for uid: %{public}d",
             cameraOnAverageMa, uid);
-        iter->second = cameraOnPowerMah;
+        iter->second = cameraOnEnergyNah;
     } else {
         STATS_HILOGD(COMP_SVC, "Create camera on power consumption: %{public}lfmAh for uid: %{public}d",
             cameraOnAverageMa, uid);
-        cameraPowerMap_.insert(std::pair<int32_t, double>(uid, cameraOnPowerMah));
+        cameraEnergyMap_.insert(std::pair<int32_t, int64_t>(uid, cameraOnEnergyNah));
     }
 }
 
 double CameraEntity::GetEntityPowerMah(int32_t uidOrUserId)
 {
     double power = StatsUtils::DEFAULT_VALUE;
-    auto iter = cameraPowerMap_.find(uidOrUserId);
-    if (iter != cameraPowerMap_.end()) {
-        power = iter->second;
+    auto iter = cameraEnergyMap_.find(uidOrUserId);
+    if (iter != cameraEnergyMap_.end()) {
+        power = StatsUtils::ConvertToPowerMah(iter->second);
         STATS_HILOGD(COMP_SVC, "Get app camera power consumption: %{public}lfmAh for uid: %{public}d",
             power, uidOrUserId);
     } else {
@@ -82,9 +152,9 @@ double CameraEntity::GetStatsPowerMah(StatsUtils::StatsType statsType, int32_t u
 {
     double power = StatsUtils::DEFAULT_VALUE;
     if (statsType == StatsUtils::STATS_TYPE_CAMERA_ON) {
-        auto cameraOnIter = cameraPowerMap_.find(uid);
-        if (cameraOnIter != cameraPowerMap_.end()) {
-            power = cameraOnIter->second;
+        auto cameraOnIter = cameraEnergyMap_.find(uid);
+        if (cameraOnIter != cameraEnergyMap_.end()) {
+            power = StatsUtils::ConvertToPowerMah(cameraOnIter->second);
             STATS_HILOGD(COMP_SVC, "Get camera on power consumption: %{public}lfmAh for uid: %{public}d",
                 power, uid);
         } else {
@@ -95,46 +165,89 @@ double CameraEntity::GetStatsPowerMah(StatsUtils::StatsType statsType, int32_t u
     return power;
 }
 
+std::shared_ptr<StatsHelper::ActiveTimer> CameraEntity::GetOrCreateDeviceTimer(uint16_t deviceIndex, int32_t uid)
+{
+    if (deviceIndex >= deviceIds_.size() || uid <= StatsUtils::INVALID_VALUE) {
+        STATS_HILOGD(COMP_SVC, "Illegal camera device: %{public}u or uid: %{public}d", deviceIndex, uid);
+        return nullptr;
+    }
+    auto& timer = cameraTimerMap_.try_emplace(MakeTimerKey(deviceIndex, uid)).first->second;
+    // The timer is owned by the entity, the returned pointer only aliases it
+    return std::shared_ptr<StatsHelper::ActiveTimer>(std::shared_ptr<void>(), &timer);
+}
+
 std::shared_ptr<StatsHelper::ActiveTimer> CameraEntity::GetOrCreateTimer(const std::string& deviceId, int32_t uid,
     StatsUtils::StatsType statsType, int16_t level)
 {
-    std::shared_ptr<StatsHelper::ActiveTimer> cmrTimer = nullptr;
     if (statsType != StatsUtils::STATS_TYPE_CAMERA_ON) {
-        return cmrTimer;
+        return nullptr;
+    }
+    return GetOrCreateDeviceTimer(InternDeviceId(deviceId), uid);
+}
+
+size_t CameraEntity::RemoveUid(int32_t uid)
+{
+    size_t count = cameraEnergyMap_.erase(uid);
+    // Device ids stay interned, they name hardware rather than apps
+    int64_t nowMs = StatsHelper::GetComputeTimeMs();
+    for (size_t deviceIndex = 0; deviceIndex < deviceIds_.size(); deviceIndex++) {
+        auto iter = cameraTimerMap_.find(MakeTimerKey(deviceIndex, uid));
+        if (iter == cameraTimerMap_.end()) {
+            continue;
+        }
+        if (iter->second.IsRunning()) {
+            iter->second.Reset();
+            iter->second.StartRunning(nowMs);
+            continue;
+        }
+        cameraTimerMap_.erase(iter);
+        count++;
+    }
+    return count;
+}
+
+bool CameraEntity::IsUidActive(int32_t uid)
+{
+    for (size_t deviceIndex = 0; deviceIndex < deviceIds_.size(); deviceIndex++) {
+        auto iter = cameraTimerMap_.find(MakeTimerKey(deviceIndex, uid));
+        if (iter != cameraTimerMap_.end() && iter->second.IsRunning()) {
+            return true;
+        }
     }
+    return false;
+}
 
-    auto cameraIter = cameraTimerMap_.find(deviceId);
-    if (cameraIter != cameraTimerMap_.end()) {
-        auto uidIter = cameraIter->second.find(uid);
-        if (uidIter != cameraIter->second.end()) {
-            return uidIter->second;
+void CameraEntity::DumpInfo(std::string& result, int32_t uid)
+{
+    int64_t nowMs = StatsHelper::GetComputeTimeMs();
+    auto cameraOnAverageMa =
+        BatteryStatsService::GetInstance()->GetBatteryStatsParser()->GetAveragePowerMa(StatsUtils::CURRENT_CAMERA_ON);
+    for (size_t deviceIndex = 0; deviceIndex < deviceIds_.size(); deviceIndex++) {
+        int64_t time = GetDeviceActiveTimeMs(static_cast<uint16_t>(deviceIndex), uid, nowMs);
+        if (time == StatsUtils::DEFAULT_VALUE) {
+            continue;
         }
-        cmrTimer = std::make_shared<StatsHelper::ActiveTimer>();
-        cameraIter->second.insert(std::pair<int32_t, std::shared_ptr<StatsHelper::ActiveTimer>>(uid, cmrTimer));
-        return cmrTimer;
+        result.append("Camera ")
+            .append(deviceIds_[deviceIndex])
+            .append(" on time: ")
+            .append(ToString(time))
+            .append("ms, power: ")
+            .append(ToString(StatsUtils::ConvertToPowerMah(StatsUtils::ConvertToEnergyNah(cameraOnAverageMa, time))))
+            .append("mAh")
+            .append("\n");
     }
-    cmrTimer = std::make_shared<StatsHelper::ActiveTimer>();
-    std::map<int32_t, std::shared_ptr<StatsHelper::ActiveTimer>> uidTimerMap;
-    uidTimerMap.insert(std::pair<int32_t, std::shared_ptr<StatsHelper::ActiveTimer>>(uid, cmrTimer));
-    cameraTimerMap_.insert(
-        std::pair<std::string, std::map<int32_t, std::shared_ptr<StatsHelper::ActiveTimer>>>(deviceId, uidTimerMap));
-    return cmrTimer;
 }
 
 void CameraEntity::Reset()
 {
     // Reset app Camera on total power consumption
-    for (auto& iter : cameraPowerMap_) {
+    for (auto& iter : cameraEnergyMap_) {
         iter.second = StatsUtils::DEFAULT_VALUE;
     }
 
     // Reset Camera on timer
-    for (auto& cameraIter : cameraTimerMap_) {
-        for (auto& uidIter : cameraIter.second) {
-            if (uidIter.second) {
-                uidIter.second->Reset();
-            }
-        }
+    for (auto& iter : cameraTimerMap_) {
+        iter.second.Reset();
     }
 }
 } // namespace PowerMgr
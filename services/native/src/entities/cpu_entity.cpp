@@ -60,7 +60,7 @@ void CpuEntity::UpdateCpuTime()
 
 void CpuEntity::Calculate(int32_t uid)
 {
-    double cpuTotalPowerMah = StatsUtils::DEFAULT_VALUE;
+    int64_t cpuTotalEnergyNah = StatsUtils::DEFAULT_VALUE;
     // Get cpu time related with uid
     std::vector<int64_t> cpuTimeVec = cpuReader_->GetUidCpuTimeMs(uid);
     int64_t cpuTimeMs = StatsUtils::DEFAULT_VALUE;
@@ -79,73 +79,73 @@ void CpuEntity::Calculate(int32_t uid)
     }
 
     // Calculate cpu active power
-    cpuTotalPowerMah += CalculateCpuActivePower(uid);
+    cpuTotalEnergyNah += CalculateCpuActiveEnergy(uid);
 
     // Calculate cpu cluster power
-    cpuTotalPowerMah += CalculateCpuClusterPower(uid);
+    cpuTotalEnergyNah += CalculateCpuClusterEnergy(uid);
 
     // Calculate cpu speed power
-    cpuTotalPowerMah += CalculateCpuSpeedPower(uid);
+    cpuTotalEnergyNah += CalculateCpuSpeedEnergy(uid);
 
-    auto cpuTotalIter = cpuTotalPowerMap_.find(uid);
-    if (cpuTotalIter != cpuTotalPowerMap_.end()) {
+    auto cpuTotalIter = cpuTotalEnergyMap_.find(uid);
+    if (cpuTotalIter != cpuTotalEnergyMap_.end()) {
         STATS_HILOGD(COMP_SVC, "Update cpu speed power consumption: %{public}lfmAh for uid: %{public}d",
-            cpuTotalPowerMah, uid);
-        cpuTotalIter->second = cpuTotalPowerMah;
+            StatsUtils::ConvertToPowerMah(cpuTotalEnergyNah), uid);
+        cpuTotalIter->second = cpuTotalEnergyNah;
     } else {
         STATS_HILOGD(COMP_SVC, "Create cpu speed power consumption: %{public}lfmAh for uid: %{public}d",
-            cpuTotalPowerMah, uid);
-        cpuTotalPowerMap_.insert(std::pair<int32_t, double>(uid, cpuTotalPowerMah));
+            StatsUtils::ConvertToPowerMah(cpuTotalEnergyNah), uid);
+        cpuTotalEnergyMap_.insert(std::pair<int32_t, int64_t>(uid, cpuTotalEnergyNah));
     }
 }
 
-double CpuEntity::CalculateCpuActivePower(int32_t uid)
+int64_t CpuEntity::CalculateCpuActiveEnergy(int32_t uid)
 {
     auto bss = BatteryStatsService::GetInstance();
     double cpuActiveAverageMa =
         bss->GetBatteryStatsParser()->GetAveragePowerMa(StatsUtils::CURRENT_CPU_ACTIVE);
     int64_t cpuActiveTimeMs = cpuReader_->GetUidCpuActiveTimeMs(uid);
-    double cpuActivePower = cpuActiveAverageMa * cpuActiveTimeMs / StatsUtils::MS_IN_HOUR;
+    int64_t cpuActiveEnergyNah = StatsUtils::ConvertToEnergyNah(cpuActiveAverageMa, cpuActiveTimeMs);
 
-    auto cpuActiveIter = cpuActivePowerMap_.find(uid);
-    if (cpuActiveIter != cpuActivePowerMap_.end()) {
+    auto cpuActiveIter = cpuActiveEnergyMap_.find(uid);
+    if (cpuActiveIter != cpuActiveEnergyMap_.end()) {
         STATS_HILOGD(COMP_SVC, "Update cpu active power consumption: %{public}lfmAh for uid: %{public}d",
-            cpuActivePower, uid);
-        cpuActiveIter->second = cpuActivePower;
+            StatsUtils::ConvertToPowerMah(cpuActiveEnergyNah), uid);
+        cpuActiveIter->second = cpuActiveEnergyNah;
     } else {
         STATS_HILOGD(COMP_SVC, "Create cpu active power consumption: %{public}lfmAh for uid: %{public}d",
-            cpuActivePower, uid);
-        cpuActivePowerMap_.insert(std::pair<int32_t, double>(uid, cpuActivePower));
+            StatsUtils::ConvertToPowerMah(cpuActiveEnergyNah), uid);
+        cpuActiveEnergyMap_.insert(std::pair<int32_t, int64_t>(uid, cpuActiveEnergyNah));
     }
-    return cpuActivePower;
+    return cpuActiveEnergyNah;
 }
 
-double CpuEntity::CalculateCpuClusterPower(int32_t uid)
+int64_t CpuEntity::CalculateCpuClusterEnergy(int32_t uid)
 {
-    double cpuClusterPower = StatsUtils::DEFAULT_VALUE;
+    int64_t cpuClusterEnergyNah = StatsUtils::DEFAULT_VALUE;
     auto bss = BatteryStatsService::GetInstance();
     for (uint16_t i = 0; i < bss->GetBatteryStatsParser()->GetClusterNum(); i++) {
         double cpuClusterAverageMa =
             bss->GetBatteryStatsParser()->GetAveragePowerMa(StatsUtils::CURRENT_CPU_CLUSTER, i);
         int64_t cpuClusterTimeMs = cpuReader_->GetUidCpuClusterTimeMs(uid, i);
-        cpuClusterPower += cpuClusterAverageMa * cpuClusterTimeMs / StatsUtils::MS_IN_HOUR;
+        cpuClusterEnergyNah += StatsUtils::ConvertToEnergyNah(cpuClusterAverageMa, cpuClusterTimeMs);
     }
-    auto cpuClusterIter = cpuClusterPowerMap_.find(uid);
-    if (cpuClusterIter != cpuClusterPowerMap_.end()) {
+    auto cpuClusterIter = cpuClusterEnergyMap_.find(uid);
+    if (cpuClusterIter != cpuClusterEnergyMap_.end()) {
         STATS_HILOGD(COMP_SVC, "Update cpu cluster power consumption: %{public}lfmAh for uid: %{public}d",
-            cpuClusterPower, uid);
-        cpuClusterIter->second = cpuClusterPower;
+            StatsUtils::ConvertToPowerMah(cpuClusterEnergyNah), uid);
+        cpuClusterIter->second = cpuClusterEnergyNah;
     } else {
         STATS_HILOGD(COMP_SVC, "Create cpu cluster power consumption: %{public}lfmAh for uid: %{public}d",
-            cpuClusterPower, uid);
-        cpuClusterPowerMap_.insert(std::pair<int32_t, double>(uid, cpuClusterPower));
+            StatsUtils::ConvertToPowerMah(cpuClusterEnergyNah), uid);
+        cpuClusterEnergyMap_.insert(std::pair<int32_t, int64_t>(uid, cpuClusterEnergyNah));
     }
-    return cpuClusterPower;
+    return cpuClusterEnergyNah;
 }
 
-double CpuEntity::CalculateCpuSpeedPower(int32_t uid)
+int64_t CpuEntity::CalculateCpuSpeedEnergy(int32_t uid)
 {
-    double cpuSpeedPower = StatsUtils::DEFAULT_VALUE;
+    int64_t cpuSpeedEnergyNah = StatsUtils::DEFAULT_VALUE;
     auto bss = BatteryStatsService::GetInstance();
     for (uint16_t i = 0; i < bss->GetBatteryStatsParser()->GetClusterNum(); i++) {
         for (uint16_t j = 0; j < bss->GetBatteryStatsParser()->GetSpeedNum(i); j++) {
@@ -153,28 +153,28 @@ double CpuEntity::CalculateCpuSpeedPower(int32_t uid)
             std::string statType = StatsUtils::CURRENT_CPU_SPEED + std::to_string(i);
             double cpuSpeedAverageMa = bss->GetBatteryStatsParser()->GetAveragePowerMa(statType, j);
             int64_t cpuSpeedTimeMs = cpuReader_->GetUidCpuFreqTimeMs(uid, i, j);
-            cpuSpeedPower += cpuSpeedAverageMa * cpuSpeedTimeMs / StatsUtils::MS_IN_HOUR;
+            cpuSpeedEnergyNah += StatsUtils::ConvertToEnergyNah(cpuSpeedAverageMa, cpuSpeedTimeMs);
         }
     }
-    auto cpuSpeedIter = cpuSpeedPowerMap_.find(uid);
-    if (cpuSpeedIter != cpuSpeedPowerMap_.end()) {
+    auto cpuSpeedIter = cpuSpeedEnergyMap_.find(uid);
+    if (cpuSpeedIter != cpuSpeedEnergyMap_.end()) {
         STATS_HILOGD(COMP_SVC, "Update cpu speed power consumption: %{public}lfmAh for uid: %{public}d",
-            cpuSpeedPower, uid);
-        cpuSpeedIter->second = cpuSpeedPower;
+            StatsUtils::ConvertToPowerMah(cpuSpeedEnergyNah), uid);
+        cpuSpeedIter->second = cpuSpeedEnergyNah;
     } else {
         STATS_HILOGD(COMP_SVC, "Create cpu speed power consumption: %{public}lfmAh for uid: %{public}d",
-            cpuSpeedPower, uid);
-        cpuSpeedPowerMap_.insert(std::pair<int32_t, double>(uid, cpuSpeedPower));
+            StatsUtils::ConvertToPowerMah(cpuSpeedEnergyNah), uid);
+        cpuSpeedEnergyMap_.insert(std::pair<int32_t, int64_t>(uid, cpuSpeedEnergyNah));
     }
-    return cpuSpeedPower;
+    return cpuSpeedEnergyNah;
 }
 
 double CpuEntity::GetEntityPowerMah(int32_t uidOrUserId)
 {
     double power = StatsUtils::DEFAULT_VALUE;
-    auto iter = cpuTotalPowerMap_.find(uidOrUserId);
-    if (iter != cpuTotalPowerMap_.end()) {
-        power = iter->second;
+    auto iter = cpuTotalEnergyMap_.find(uidOrUserId);
+    if (iter != cpuTotalEnergyMap_.end()) {
+        power = StatsUtils::ConvertToPowerMah(iter->second);
         STATS_HILOGD(COMP_SVC, "Get app cpu total power consumption: %{public}lfmAh for uid: %{public}d",
             power, uidOrUserId);
     } else {
@@ -189,9 +189,9 @@ double CpuEntity::GetStatsPowerMah(StatsUtils::StatsType statsType, int32_t uid)
     double power = StatsUtils::DEFAULT_VALUE;
 
     if (statsType == StatsUtils::STATS_TYPE_CPU_ACTIVE) {
-        auto cpuActiveIter = cpuActivePowerMap_.find(uid);
-        if (cpuActiveIter != cpuActivePowerMap_.end()) {
-            power = cpuActiveIter->second;
+        auto cpuActiveIter = cpuActiveEnergyMap_.find(uid);
+        if (cpuActiveIter != cpuActiveEnergyMap_.end()) {
+            power = StatsUtils::ConvertToPowerMah(cpuActiveIter->second);
             STATS_HILOGD(COMP_SVC, "Get cpu active power consumption: %{public}lfmAh for uid: %{public}d",
                 power, uid);
         } else {
@@ -199,9 +199,9 @@ double CpuEntity::GetStatsPowerMah(StatsUtils::StatsType statsType, int32_t uid)
                 "No cpu active power consumption related to uid: %{public}d was found, return 0", uid);
         }
     } else if (statsType == StatsUtils::STATS_TYPE_CPU_CLUSTER) {
-        auto cpuClusterIter = cpuClusterPowerMap_.find(uid);
-        if (cpuClusterIter != cpuClusterPowerMap_.end()) {
-            power = cpuClusterIter->second;
+        auto cpuClusterIter = cpuClusterEnergyMap_.find(uid);
+        if (cpuClusterIter != cpuClusterEnergyMap_.end()) {
+            power = StatsUtils::ConvertToPowerMah(cpuClusterIter->second);
             STATS_HILOGD(COMP_SVC, "Get cpu cluster power consumption: %{public}lfmAh for uid: %{public}d",
                 power, uid);
         } else {
@@ -209,9 +209,9 @@ double CpuEntity::GetStatsPowerMah(StatsUtils::StatsType statsType, int32_t uid)
                 "No cpu cluster power consumption related to uid: %{public}d was found, return 0", uid);
         }
     } else if (statsType == StatsUtils::STATS_TYPE_CPU_SPEED) {
-        auto cpuSpeedIter = cpuSpeedPowerMap_.find(uid);
-        if (cpuSpeedIter != cpuSpeedPowerMap_.end()) {
-            power = cpuSpeedIter->second;
+        auto cpuSpeedIter = cpuSpeedEnergyMap_.find(uid);
+        if (cpuSpeedIter != cpuSpeedEnergyMap_.end()) {
+            power = StatsUtils::ConvertToPowerMah(cpuSpeedIter->second);
             STATS_HILOGD(COMP_SVC, "Get cpu speed power consumption: %{public}lfmAh for uid: %{public}d",
                 power, uid);
         } else {
@@ -222,6 +222,19 @@ double CpuEntity::GetStatsPowerMah(StatsUtils::StatsType statsType, int32_t uid)
     return power;
 }
 
+size_t CpuEntity::RemoveUid(int32_t uid)
+{
+    size_t count = cpuTimeMap_.erase(uid);
+    count += cpuTotalEnergyMap_.erase(uid);
+    count += cpuActiveEnergyMap_.erase(uid);
+    count += cpuClusterEnergyMap_.erase(uid);
+    count += cpuSpeedEnergyMap_.erase(uid);
+    if (cpuReader_) {
+        count += cpuReader_->RemoveUid(uid);
+    }
+    return count;
+}
+
 void CpuEntity::Reset()
 {
     // Reset app Cpu time
@@ -230,22 +243,22 @@ void CpuEntity::Reset()
     }
 
     // Reset app Cpu total power consumption
-    for (auto& iter : cpuTotalPowerMap_) {
+    for (auto& iter : cpuTotalEnergyMap_) {
         iter.second = StatsUtils::DEFAULT_VALUE;
     }
 
     // Reset app Cpu active power consumption
-    for (auto& iter : cpuActivePowerMap_) {
+    for (auto& iter : cpuActiveEnergyMap_) {
         iter.second = StatsUtils::DEFAULT_VALUE;
     }
 
     // Reset app Cpu cluster power consumption
-    for (auto& iter : cpuClusterPowerMap_) {
+    for (auto& iter : cpuClusterEnergyMap_) {
         iter.second = StatsUtils::DEFAULT_VALUE;
     }
 
     // Reset app Cpu speed power consumption
-    for (auto& iter : cpuSpeedPowerMap_) {
+    for (auto& iter : cpuSpeedEnergyMap_) {
         iter.second = StatsUtils::DEFAULT_VALUE;
     }
 }
@@ -37,9 +37,9 @@ int64_t FlashlightEntity::GetActiveTimeMs(int32_t uid, StatsUtils::StatsType sta
         return activeTimeMs;
     }
 
-    auto iter = flashlightTimerMap_.find(uid);
-    if (iter != flashlightTimerMap_.end()) {
-        activeTimeMs = iter->second->GetRunningTimeMs();
+    auto timer = uidSlab_.GetTimer(uid, BatteryStatsUidSlab::TIMER_FLASHLIGHT_ON);
+    if (timer != nullptr) {
+        activeTimeMs = timer->GetRunningTimeMs();
         STATS_HILOGD(COMP_SVC, "Get flashlight on time: %{public}" PRId64 "ms for uid: %{public}d", activeTimeMs, uid);
         return activeTimeMs;
     }
@@ -53,25 +53,25 @@ void FlashlightEntity::Calculate(int32_t uid)
     auto flashlightOnAverageMa =
         bss->GetBatteryStatsParser()->GetAveragePowerMa(StatsUtils::CURRENT_FLASHLIGHT_ON);
     auto flashlightOnTimeMs = GetActiveTimeMs(uid, StatsUtils::STATS_TYPE_FLASHLIGHT_ON);
-    auto flashlightOnPowerMah = flashlightOnAverageMa * flashlightOnTimeMs / StatsUtils::MS_IN_HOUR;
-    auto iter = flashlightPowerMap_.find(uid);
-    if (iter != flashlightPowerMap_.end()) {
+    int64_t flashlightOnEnergyNah = StatsUtils::ConvertToEnergyNah(flashlightOnAverageMa, flashlightOnTimeMs);
+    auto iter = flashlightEnergyMap_.find(uid);
+    if (iter != flashlightEnergyMap_.end()) {
         STATS_HILOGD(COMP_SVC, "Update flashlight on power consumption: %{public}lfmAh for uid: %{public}d",
             flashlightOnAverageMa, uid);
-        iter->second = flashlightOnPowerMah;
+        iter->second = flashlightOnEnergyNah;
     } else {
         STATS_HILOGD(COMP_SVC, "Create flashlight on power consumption: %{public}lfmAh for uid: %{public}d",
             flashlightOnAverageMa, uid);
-        flashlightPowerMap_.insert(std::pair<int32_t, double>(uid, flashlightOnPowerMah));
+        flashlightEnergyMap_.insert(std::pair<int32_t, int64_t>(uid, flashlightOnEnergyNah));
     }
 }
 
 double FlashlightEntity::GetEntityPowerMah(int32_t uidOrUserId)
 {
     double power = StatsUtils::DEFAULT_VALUE;
-    auto iter = flashlightPowerMap_.find(uidOrUserId);
-    if (iter != flashlightPowerMap_.end()) {
-        power = iter->second;
+    auto iter = flashlightEnergyMap_.find(uidOrUserId);
+    if (iter != flashlightEnergyMap_.end()) {
+        power = StatsUtils::ConvertToPowerMah(iter->second);
         STATS_HILOGD(COMP_SVC, "Get app flashlight power consumption: %{public}lfmAh for uid: %{public}d",
             power, uidOrUserId);
     } else {
@@ -85,9 +85,9 @@ double FlashlightEntity::GetStatsPowerMah(StatsUtils::StatsType statsType, int32
 {
     double power = StatsUtils::DEFAULT_VALUE;
     if (statsType == StatsUtils::STATS_TYPE_FLASHLIGHT_ON) {
-        auto flashlightOnIter = flashlightPowerMap_.find(uid);
-        if (flashlightOnIter != flashlightPowerMap_.end()) {
-            power = flashlightOnIter->second;
+        auto flashlightOnIter = flashlightEnergyMap_.find(uid);
+        if (flashlightOnIter != flashlightEnergyMap_.end()) {
+            power = StatsUtils::ConvertToPowerMah(flashlightOnIter->second);
             STATS_HILOGD(COMP_SVC,
                 "Get flashlight on power consumption: %{public}lfmAh for uid: %{public}d", power, uid);
         } else {
@@ -105,30 +105,23 @@ std::shared_ptr<StatsHelper::ActiveTimer> FlashlightEntity::GetOrCreateTimer(int
         return nullptr;
     }
 
-    auto flashlightOnIter = flashlightTimerMap_.find(uid);
-    if (flashlightOnIter != flashlightTimerMap_.end()) {
-        STATS_HILOGD(COMP_SVC, "Get flashlight on timer for uid: %{public}d", uid);
-        return flashlightOnIter->second;
-    }
-    STATS_HILOGD(COMP_SVC, "Create flashlight on timer for uid: %{public}d", uid);
-    std::shared_ptr<StatsHelper::ActiveTimer> flashTimer = std::make_shared<StatsHelper::ActiveTimer>();
-    flashlightTimerMap_.insert(std::pair<int32_t, std::shared_ptr<StatsHelper::ActiveTimer>>(uid, flashTimer));
-    return flashTimer;
+    return uidSlab_.GetOrCreateTimer(uid, BatteryStatsUidSlab::TIMER_FLASHLIGHT_ON);
+}
+
+size_t FlashlightEntity::RemoveUid(int32_t uid)
+{
+    return uidSlab_.ReleaseTimer(uid, BatteryStatsUidSlab::TIMER_FLASHLIGHT_ON) + flashlightEnergyMap_.erase(uid);
 }
 
 void FlashlightEntity::Reset()
 {
     // Reset app Flashlight on total power consumption
-    for (auto& iter : flashlightPowerMap_) {
+    for (auto& iter : flashlightEnergyMap_) {
         iter.second = StatsUtils::DEFAULT_VALUE;
     }
 
     // Reset Flashlight on timer
-    for (auto& iter : flashlightTimerMap_) {
-        if (iter.second) {
-            iter.second->Reset();
-        }
-    }
+    uidSlab_.ResetTimers(BatteryStatsUidSlab::TIMER_FLASHLIGHT_ON);
 }
 } // namespace PowerMgr
 } // namespace OHOS
\ No newline at end of file
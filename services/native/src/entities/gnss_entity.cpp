@@ -37,9 +37,9 @@ int64_t GnssEntity::GetActiveTimeMs(int32_t uid, StatsUtils::StatsType statsType
         return activeTimeMs;
     }
 
-    auto iter = gnssTimerMap_.find(uid);
-    if (iter != gnssTimerMap_.end()) {
-        activeTimeMs = iter->second->GetRunningTimeMs();
+    auto timer = uidSlab_.GetTimer(uid, BatteryStatsUidSlab::TIMER_GNSS_ON);
+    if (timer != nullptr) {
+        activeTimeMs = timer->GetRunningTimeMs();
         STATS_HILOGD(COMP_SVC, "Get gnss on time: %{public}" PRId64 "ms for uid: %{public}d", activeTimeMs, uid);
         return activeTimeMs;
     }
@@ -52,25 +52,25 @@ void GnssEntity::Calculate(int32_t uid)
     auto bss = BatteryStatsService::GetInstance();
     auto gnssOnAverageMa = bss->GetBatteryStatsParser()->GetAveragePowerMa(StatsUtils::CURRENT_GNSS_ON);
     auto gnssOnTimeMs = GetActiveTimeMs(uid, StatsUtils::STATS_TYPE_GNSS_ON);
-    auto gnssOnPowerMah = gnssOnAverageMa * gnssOnTimeMs / StatsUtils::MS_IN_HOUR;
-    auto iter = gnssPowerMap_.find(uid);
-    if (iter != gnssPowerMap_.end()) {
+    int64_t gnssOnEnergyNah = StatsUtils::ConvertToEnergyNah(gnssOnAverageMa, gnssOnTimeMs);
+    auto iter = gnssEnergyMap_.find(uid);
+    if (iter != gnssEnergyMap_.end()) {
         STATS_HILOGD(COMP_SVC, "Update gnss on power consumption: %{public}lfmAh for uid: %{public}d",
             gnssOnAverageMa, uid);
-        iter->second = gnssOnPowerMah;
+        iter->second = gnssOnEnergyNah;
     } else {
         STATS_HILOGD(COMP_SVC, "Create gnss on power consumption: %{public}lfmAh for uid: %{public}d",
             gnssOnAverageMa, uid);
-        gnssPowerMap_.insert(std::pair<int32_t, double>(uid, gnssOnPowerMah));
+        gnssEnergyMap_.insert(std::pair<int32_t, int64_t>(uid, gnssOnEnergyNah));
     }
 }
 
 double GnssEntity::GetEntityPowerMah(int32_t uidOrUserId)
 {
     double power = StatsUtils::DEFAULT_VALUE;
-    auto iter = gnssPowerMap_.find(uidOrUserId);
-    if (iter != gnssPowerMap_.end()) {
-        power = iter->second;
+    auto iter = gnssEnergyMap_.find(uidOrUserId);
+    if (iter != gnssEnergyMap_.end()) {
+        power = StatsUtils::ConvertToPowerMah(iter->second);
         STATS_HILOGD(COMP_SVC, "Get app gnss power consumption: %{public}lfmAh for uid: %{public}d",
             power, uidOrUserId);
     } else {
@@ -84,9 +84,9 @@ double GnssEntity::GetStatsPowerMah(StatsUtils::StatsType statsType, int32_t uid
 {
     double power = StatsUtils::DEFAULT_VALUE;
     if (statsType == StatsUtils::STATS_TYPE_GNSS_ON) {
-        auto gnssOnIter = gnssPowerMap_.find(uid);
-        if (gnssOnIter != gnssPowerMap_.end()) {
-            power = gnssOnIter->second;
+        auto gnssOnIter = gnssEnergyMap_.find(uid);
+        if (gnssOnIter != gnssEnergyMap_.end()) {
+            power = StatsUtils::ConvertToPowerMah(gnssOnIter->second);
             STATS_HILOGD(COMP_SVC, "Get gnss on power consumption: %{public}lfmAh for uid: %{public}d",
                 power, uid);
         } else {
@@ -104,30 +104,23 @@ std::shared_ptr<StatsHelper::ActiveTimer> GnssEntity::GetOrCreateTimer(int32_t u
         return nullptr;
     }
 
-    auto gnssOnIter = gnssTimerMap_.find(uid);
-    if (gnssOnIter != gnssTimerMap_.end()) {
-        STATS_HILOGD(COMP_SVC, "Get gnss on timer for uid: %{public}d", uid);
-        return gnssOnIter->second;
-    }
-    STATS_HILOGD(COMP_SVC, "Create gnss on timer for uid: %{public}d", uid);
-    std::shared_ptr<StatsHelper::ActiveTimer> gnssTimer = std::make_shared<StatsHelper::ActiveTimer>();
-    gnssTimerMap_.insert(std::pair<int32_t, std::shared_ptr<StatsHelper::ActiveTimer>>(uid, gnssTimer));
-    return gnssTimer;
+    return uidSlab_.GetOrCreateTimer(uid, BatteryStatsUidSlab::TIMER_GNSS_ON);
+}
+
+size_t GnssEntity::RemoveUid(int32_t uid)
+{
+    return uidSlab_.ReleaseTimer(uid, BatteryStatsUidSlab::TIMER_GNSS_ON) + gnssEnergyMap_.erase(uid);
 }
 
 void GnssEntity::Reset()
 {
     // Reset app Gnss on total power consumption
-    for (auto& iter : gnssPowerMap_) {
+    for (auto& iter : gnssEnergyMap_) {
         iter.second = StatsUtils::DEFAULT_VALUE;
     }
 
     // Reset Gnss on timer
-    for (auto& iter : gnssTimerMap_) {
-        if (iter.second) {
-            iter.second->Reset();
-        }
-    }
+    uidSlab_.ResetTimers(BatteryStatsUidSlab::TIMER_GNSS_ON);
 }
 } // namespace PowerMgr
 } // namespace OHOS
\ No newline at end of file
@@ -15,6 +15,8 @@
 
 #include "entities/idle_entity.h"
 
+#include <cinttypes>
+
 #include "battery_stats_service.h"
 #include "stats_log.h"
 
@@ -37,7 +39,7 @@ int64_t IdleEntity::GetActiveTimeMs(StatsUtils::StatsType statsType, int16_t lev
             activeTimeMs = StatsHelper::GetOnBatteryUpTimeMs();
             break;
         case StatsUtils::STATS_TYPE_CPU_SUSPEND:
-            activeTimeMs = StatsHelper::GetOnBatteryBootTimeMs();
+            activeTimeMs = StatsHelper::GetComputeTimeMs();
             break;
         default:
             break;
@@ -47,55 +49,53 @@ int64_t IdleEntity::GetActiveTimeMs(StatsUtils::StatsType statsType, int16_t lev
 
 void IdleEntity::Calculate(int32_t uid)
 {
-    auto cpuSuspendPower = CalculateCpuSuspendPower();
-    auto cpuIdlePower = CalculateCpuIdlePower();
-    idleTotalPowerMah_ = cpuSuspendPower + cpuIdlePower;
-    totalPowerMah_ += idleTotalPowerMah_;
-    std::shared_ptr<BatteryStatsInfo> statsInfo = std::make_shared<BatteryStatsInfo>();
-    statsInfo->SetConsumptioType(BatteryStatsInfo::CONSUMPTION_TYPE_IDLE);
-    statsInfo->SetPower(idleTotalPowerMah_);
+    int64_t cpuSuspendEnergy = CalculateCpuSuspendEnergy();
+    int64_t cpuIdleEnergy = CalculateCpuIdleEnergy();
+    idleTotalEnergyNah_ = cpuSuspendEnergy + cpuIdleEnergy;
+    totalEnergyNah_ += idleTotalEnergyNah_;
+    std::shared_ptr<BatteryStatsInfo> statsInfo = statsInfoPool_.Acquire(BatteryStatsInfo::CONSUMPTION_TYPE_IDLE);
+    statsInfo->SetPower(StatsUtils::ConvertToPowerMah(idleTotalEnergyNah_));
     statsInfoList_.push_back(statsInfo);
 
-    STATS_HILOGD(COMP_SVC, "Calculate idle total power consumption: %{public}lfmAh", idleTotalPowerMah_);
+    STATS_HILOGD(COMP_SVC, "Calculate idle total energy consumption: %{public}" PRId64 "nAh",
+        idleTotalEnergyNah_);
 }
 
-double IdleEntity::CalculateCpuSuspendPower()
+int64_t IdleEntity::CalculateCpuSuspendEnergy()
 {
     auto bss = BatteryStatsService::GetInstance();
     auto cpuSuspendAverageMa =
         bss->GetBatteryStatsParser()->GetAveragePowerMa(StatsUtils::CURRENT_CPU_SUSPEND);
     auto bootOnBatteryTimeMs = GetActiveTimeMs(StatsUtils::STATS_TYPE_CPU_SUSPEND);
-    auto cpuSuspendPowerMah = cpuSuspendAverageMa * bootOnBatteryTimeMs / StatsUtils::MS_IN_HOUR;
-    cpuSuspendPowerMah_ = cpuSuspendPowerMah;
-    STATS_HILOGD(COMP_SVC, "Calculate cpu suspend power consumption: %{public}lfmAh", cpuSuspendPowerMah);
-    return cpuSuspendPowerMah_;
+    cpuSuspendEnergyNah_ = StatsUtils::ConvertToEnergyNah(cpuSuspendAverageMa, bootOnBatteryTimeMs);
+    STATS_HILOGD(COMP_SVC, "Calculate cpu suspend energy consumption: %{public}" PRId64 "nAh", cpuSuspendEnergyNah_);
+    return cpuSuspendEnergyNah_;
 }
 
-double IdleEntity::CalculateCpuIdlePower()
+int64_t IdleEntity::CalculateCpuIdleEnergy()
 {
     auto bss = BatteryStatsService::GetInstance();
     auto cpuIdleAverageMa =
         bss->GetBatteryStatsParser()->GetAveragePowerMa(StatsUtils::CURRENT_CPU_IDLE);
     auto upOnBatteryTimeMs = GetActiveTimeMs(StatsUtils::STATS_TYPE_PHONE_IDLE);
-    auto cpuIdlePowerMah = cpuIdleAverageMa * upOnBatteryTimeMs / StatsUtils::MS_IN_HOUR;
-    cpuIdlePowerMah_ = cpuIdlePowerMah;
-    STATS_HILOGD(COMP_SVC, "Calculate cpu idle power consumption: %{public}lfmAh", cpuIdlePowerMah);
-    return cpuIdlePowerMah_;
+    cpuIdleEnergyNah_ = StatsUtils::ConvertToEnergyNah(cpuIdleAverageMa, upOnBatteryTimeMs);
+    STATS_HILOGD(COMP_SVC, "Calculate cpu idle energy consumption: %{public}" PRId64 "nAh", cpuIdleEnergyNah_);
+    return cpuIdleEnergyNah_;
 }
 
 double IdleEntity::GetEntityPowerMah(int32_t uidOrUserId)
 {
-    return idleTotalPowerMah_;
+    return StatsUtils::ConvertToPowerMah(idleTotalEnergyNah_);
 }
 
 double IdleEntity::GetStatsPowerMah(StatsUtils::StatsType statsType, int32_t uid)
 {
     double power = StatsUtils::DEFAULT_VALUE;
     if (statsType == StatsUtils::STATS_TYPE_PHONE_IDLE) {
-        power = cpuIdlePowerMah_;
+        power = StatsUtils::ConvertToPowerMah(cpuIdleEnergyNah_);
         STATS_HILOGD(COMP_SVC, "Get cpu idle power consumption: %{public}lfmAh", power);
     } else if (statsType == StatsUtils::STATS_TYPE_CPU_SUSPEND) {
-        power = cpuSuspendPowerMah_;
+        power = StatsUtils::ConvertToPowerMah(cpuSuspendEnergyNah_);
         STATS_HILOGD(COMP_SVC, "Get cpu suspend power consumption: %{public}lfmAh", power);
     }
     return power;
@@ -104,13 +104,13 @@ double IdleEntity::GetStatsPowerMah(StatsUtils::StatsType statsType, int32_t uid
 void IdleEntity::Reset()
 {
     // Reset Idle total power consumption
-    idleTotalPowerMah_ = StatsUtils::DEFAULT_VALUE;
+    idleTotalEnergyNah_ = StatsUtils::DEFAULT_VALUE;
 
     // Reset cpu idle power consumption
-    cpuIdlePowerMah_ = StatsUtils::DEFAULT_VALUE;
+    cpuIdleEnergyNah_ = StatsUtils::DEFAULT_VALUE;
 
     // Reset cpu suspend power consumption
-    cpuSuspendPowerMah_ = StatsUtils::DEFAULT_VALUE;
+    cpuSuspendEnergyNah_ = StatsUtils::DEFAULT_VALUE;
 }
 
 void IdleEntity::DumpInfo(std::string& result, int32_t uid)
@@ -36,9 +36,8 @@ int64_t PhoneEntity::GetActiveTimeMs(StatsUtils::StatsType statsType, int16_t le
     switch (statsType) {
         case StatsUtils::STATS_TYPE_PHONE_ACTIVE: {
             if (level != StatsUtils::INVALID_VALUE) {
-                auto iter = phoneOnTimerMap_.find(level);
-                if (iter != phoneOnTimerMap_.end() && iter->second != nullptr) {
-                    activeTimeMs = iter->second->GetRunningTimeMs();
+                if (level >= 0 && static_cast<size_t>(level) < SIGNAL_LEVEL_NUM) {
+                    activeTimeMs = phoneOnTimers_[level].GetRunningTimeMs();
                     STATS_HILOGD(COMP_SVC, "Get phone on time: %{public}" PRId64 "ms of signal level: %{public}d",
                         activeTimeMs, level);
                     break;
@@ -52,9 +51,8 @@ int64_t PhoneEntity::GetActiveTimeMs(StatsUtils::StatsType statsType, int16_t le
         }
         case StatsUtils::STATS_TYPE_PHONE_DATA: {
             if (level != StatsUtils::INVALID_VALUE) {
-                auto iter = phoneDataTimerMap_.find(level);
-                if (iter != phoneDataTimerMap_.end() && iter->second != nullptr) {
-                    activeTimeMs = iter->second->GetRunningTimeMs();
+                if (level >= 0 && static_cast<size_t>(level) < SIGNAL_LEVEL_NUM) {
+                    activeTimeMs = phoneDataTimers_[level].GetRunningTimeMs();
                     STATS_HILOGD(COMP_SVC, "Get phone data time: %{public}" PRId64 "ms of signal level: %{public}d",
                         activeTimeMs, level);
                     break;
@@ -72,67 +70,90 @@ int64_t PhoneEntity::GetActiveTimeMs(StatsUtils::StatsType statsType, int16_t le
     return activeTimeMs;
 }
 
-int64_t PhoneEntity::GetTotalTimeMs(StatsUtils::StatsType statsType)
+PhoneEntity::LevelTimers* PhoneEntity::GetLevelTimers(StatsUtils::StatsType statsType)
 {
-    int64_t totalTimeMs = StatsUtils::DEFAULT_VALUE;
     switch (statsType) {
-        case StatsUtils::STATS_TYPE_PHONE_ACTIVE: {
-            for (auto timerIter : phoneOnTimerMap_) {
-                totalTimeMs += timerIter.second->GetRunningTimeMs();
-            }
-            break;
-        }
-        case StatsUtils::STATS_TYPE_PHONE_DATA: {
-            for (auto timerIter : phoneDataTimerMap_) {
-                totalTimeMs += timerIter.second->GetRunningTimeMs();
-            }
-            break;
-        }
+        case StatsUtils::STATS_TYPE_PHONE_ACTIVE:
+            return &phoneOnTimers_;
+        case StatsUtils::STATS_TYPE_PHONE_DATA:
+            return &phoneDataTimers_;
         default:
-            break;
+            return nullptr;
+    }
+}
+
+int64_t PhoneEntity::GetTotalTimeMs(StatsUtils::StatsType statsType)
+{
+    int64_t totalTimeMs = StatsUtils::DEFAULT_VALUE;
+    auto timers = GetLevelTimers(statsType);
+    if (timers == nullptr) {
+        return totalTimeMs;
+    }
+    int64_t nowMs = StatsHelper::GetComputeTimeMs();
+    for (auto& timer : *timers) {
+        totalTimeMs += timer.GetRunningTimeMs(nowMs);
     }
     return totalTimeMs;
 }
 
-void PhoneEntity::Calculate(int32_t uid)
+void PhoneEntity::GetLevelTimesMs(StatsUtils::StatsType statsType, std::vector<int64_t>& levelTimesMs)
 {
-    auto bss = BatteryStatsService::GetInstance();
-    // Calculate phone on power
-    double phoneOnPowerMah = StatsUtils::DEFAULT_VALUE;
-    for (int32_t i = 0; i < StatsUtils::RADIO_SIGNAL_BIN; i++) {
-        auto phoneOnAverageMa =
-            bss->GetBatteryStatsParser()->GetAveragePowerMa(StatsUtils::CURRENT_RADIO_ON, i);
-        auto phoneOnLevelTimeMs = GetActiveTimeMs(StatsUtils::STATS_TYPE_PHONE_ACTIVE, i);
-        double phoneOnLevelPowerMah = phoneOnAverageMa * phoneOnLevelTimeMs / StatsUtils::MS_IN_HOUR;
-        phoneOnPowerMah += phoneOnLevelPowerMah;
+    levelTimesMs.clear();
+    auto timers = GetLevelTimers(statsType);
+    if (timers == nullptr) {
+        return;
+    }
+    int64_t nowMs = StatsHelper::GetComputeTimeMs();
+    levelTimesMs.reserve(StatsUtils::RADIO_SIGNAL_BIN);
+    for (size_t level = 0; level < StatsUtils::RADIO_SIGNAL_BIN; level++) {
+        levelTimesMs.push_back((*timers)[level].GetRunningTimeMs(nowMs));
     }
+}
 
-    // Calculate phone data power
-    double phoneDataPowerMah = StatsUtils::DEFAULT_VALUE;
-    for (int32_t i = 0; i < StatsUtils::RADIO_SIGNAL_BIN; i++) {
-        auto phoneDataAverageMa =
-            bss->GetBatteryStatsParser()->GetAveragePowerMa(StatsUtils::CURRENT_RADIO_DATA, i);
-        auto phoneDataLevelTimeMs = GetActiveTimeMs(StatsUtils::STATS_TYPE_PHONE_DATA, i);
-        double phoneDataLevelPowerMah = phoneDataAverageMa * phoneDataLevelTimeMs / StatsUtils::MS_IN_HOUR;
-        phoneDataPowerMah += phoneDataLevelPowerMah;
+void PhoneEntity::LoadAverageMa()
+{
+    // The power profile is loaded before any entity is computed and does not change afterwards
+    auto parser = BatteryStatsService::GetInstance()->GetBatteryStatsParser();
+    for (uint16_t level = 0; level < StatsUtils::RADIO_SIGNAL_BIN; level++) {
+        phoneOnAverageMa_[level] = parser->GetAveragePowerMa(StatsUtils::CURRENT_RADIO_ON, level);
+        phoneDataAverageMa_[level] = parser->GetAveragePowerMa(StatsUtils::CURRENT_RADIO_DATA, level);
     }
-    phonePowerMah_ = phoneOnPowerMah + phoneDataPowerMah;
-    totalPowerMah_ += phonePowerMah_;
-    std::shared_ptr<BatteryStatsInfo> statsInfo = std::make_shared<BatteryStatsInfo>();
-    statsInfo->SetConsumptioType(BatteryStatsInfo::CONSUMPTION_TYPE_PHONE);
-    statsInfo->SetPower(phonePowerMah_);
+    isAverageMaLoaded_ = true;
+}
+
+int64_t PhoneEntity::CalculateLevelEnergyNah(LevelTimers& timers, const LevelAverageMa& averageMa, int64_t nowMs)
+{
+    int64_t energyNah = StatsUtils::DEFAULT_VALUE;
+    for (size_t level = 0; level < SIGNAL_LEVEL_NUM; level++) {
+        energyNah += StatsUtils::ConvertToEnergyNah(averageMa[level], timers[level].GetRunningTimeMs(nowMs));
+    }
+    return energyNah;
+}
+
+void PhoneEntity::Calculate(int32_t uid)
+{
+    if (!isAverageMaLoaded_) {
+        LoadAverageMa();
+    }
+    int64_t nowMs = StatsHelper::GetComputeTimeMs();
+    int64_t phoneOnEnergyNah = CalculateLevelEnergyNah(phoneOnTimers_, phoneOnAverageMa_, nowMs);
+    int64_t phoneDataEnergyNah = CalculateLevelEnergyNah(phoneDataTimers_, phoneDataAverageMa_, nowMs);
+    phoneEnergyNah_ = phoneOnEnergyNah + phoneDataEnergyNah;
+    totalEnergyNah_ += phoneEnergyNah_;
+    std::shared_ptr<BatteryStatsInfo> statsInfo = statsInfoPool_.Acquire(BatteryStatsInfo::CONSUMPTION_TYPE_PHONE);
+    statsInfo->SetPower(StatsUtils::ConvertToPowerMah(phoneEnergyNah_));
     statsInfoList_.push_back(statsInfo);
-    STATS_HILOGD(COMP_SVC, "Calculate phone active power consumption: %{public}lfmAh", phonePowerMah_);
+    STATS_HILOGD(COMP_SVC, "Calculate phone active energy consumption: %{public}" PRId64 "nAh", phoneEnergyNah_);
 }
 
 double PhoneEntity::GetEntityPowerMah(int32_t uidOrUserId)
 {
-    return phonePowerMah_;
+    return StatsUtils::ConvertToPowerMah(phoneEnergyNah_);
 }
 
 double PhoneEntity::GetStatsPowerMah(StatsUtils::StatsType statsType, int32_t uid)
 {
-    return phonePowerMah_;
+    return StatsUtils::ConvertToPowerMah(phoneEnergyNah_);
 }
 
 std::shared_ptr<StatsHelper::ActiveTimer> PhoneEntity::GetOrCreateTimer(StatsUtils::StatsType statsType, int16_t level)
@@ -143,59 +164,30 @@ std::shared_ptr<StatsHelper::ActiveTimer> PhoneEntity::GetOrCreateTimer(StatsUti
         return timer;
     }
 
-    switch (statsType) {
-        case StatsUtils::STATS_TYPE_PHONE_ACTIVE: {
-            auto onIter = phoneOnTimerMap_.find(level);
-            if (onIter != phoneOnTimerMap_.end()) {
-                STATS_HILOGD(COMP_SVC, "Get phone on timer for level: %{public}d", level);
-                timer = onIter->second;
-                break;
-            }
-            STATS_HILOGD(COMP_SVC, "Create phone on timer for level: %{public}d", level);
-            std::shared_ptr<StatsHelper::ActiveTimer> phoneOnTimer = std::make_shared<StatsHelper::ActiveTimer>();
-            phoneOnTimerMap_.insert(
-                std::pair<int32_t, std::shared_ptr<StatsHelper::ActiveTimer>>(level, phoneOnTimer));
-            timer = phoneOnTimer;
-            break;
-        }
-        case StatsUtils::STATS_TYPE_PHONE_DATA: {
-            auto dataIter = phoneDataTimerMap_.find(level);
-            if (dataIter != phoneDataTimerMap_.end()) {
-                STATS_HILOGD(COMP_SVC, "Get phone data timer for level: %{public}d", level);
-                timer = dataIter->second;
-                break;
-            }
-            STATS_HILOGD(COMP_SVC, "Create phone data timer for level: %{public}d", level);
-            std::shared_ptr<StatsHelper::ActiveTimer> phoneDataTimer = std::make_shared<StatsHelper::ActiveTimer>();
-            phoneDataTimerMap_.insert(
-                std::pair<int32_t, std::shared_ptr<StatsHelper::ActiveTimer>>(level, phoneDataTimer));
-            timer = phoneDataTimer;
-            break;
-        }
-        default:
-            STATS_HILOGW(COMP_SVC, "Create phone timer failed");
-            break;
+    auto timers = GetLevelTimers(statsType);
+    if (timers == nullptr) {
+        STATS_HILOGW(COMP_SVC, "Create phone timer failed");
+        return timer;
     }
+    STATS_HILOGD(COMP_SVC, "Get phone timer for level: %{public}d", level);
+    // The timer is owned by the entity, the returned pointer only aliases it
+    timer = std::shared_ptr<StatsHelper::ActiveTimer>(std::shared_ptr<void>(), &(*timers)[level]);
     return timer;
 }
 
 void PhoneEntity::Reset()
 {
     // Reset app Phone total power consumption
-    phonePowerMah_ = StatsUtils::DEFAULT_VALUE;
+    phoneEnergyNah_ = StatsUtils::DEFAULT_VALUE;
 
     // Reset Phone on timer
-    for (auto& iter : phoneOnTimerMap_) {
-        if (iter.second) {
-            iter.second->Reset();
-        }
+    for (auto& timer : phoneOnTimers_) {
+        timer.Reset();
     }
 
     // Reset Phone data timer
-    for (auto& iter : phoneDataTimerMap_) {
-        if (iter.second) {
-            iter.second->Reset();
-        }
+    for (auto& timer : phoneDataTimers_) {
+        timer.Reset();
     }
 }
 
@@ -44,9 +44,8 @@ int64_t ScreenEntity::GetActiveTimeMs(StatsUtils::StatsType statsType, int16_t l
         }
         case StatsUtils::STATS_TYPE_SCREEN_BRIGHTNESS: {
             if (level != StatsUtils::INVALID_VALUE) {
-                auto iter = screenBrightnessTimerMap_.find(level);
-                if (iter != screenBrightnessTimerMap_.end() && iter->second != nullptr) {
-                    activeTimeMs = iter->second->GetRunningTimeMs();
+                if (level >= 0 && static_cast<size_t>(level) < BRIGHTNESS_LEVEL_NUM) {
+                    activeTimeMs = brightnessTimers_[level].GetRunningTimeMs();
                     STATS_HILOGD(COMP_SVC,
                         "Get screen brightness time: %{public}" PRId64 "ms of brightness level: %{public}d",
                         activeTimeMs, level);
@@ -67,49 +66,72 @@ int64_t ScreenEntity::GetActiveTimeMs(StatsUtils::StatsType statsType, int16_t l
 
 int64_t ScreenEntity::GetBrightnessTotalTimeMs()
 {
+    int64_t nowMs = StatsHelper::GetComputeTimeMs();
     int64_t totalTimeMs = StatsUtils::DEFAULT_VALUE;
-    for (auto timerIter : screenBrightnessTimerMap_) {
-        totalTimeMs += timerIter.second->GetRunningTimeMs();
+    for (auto& timer : brightnessTimers_) {
+        totalTimeMs += timer.GetRunningTimeMs(nowMs);
     }
     return totalTimeMs;
 }
 
+void ScreenEntity::GetLevelTimesMs(StatsUtils::StatsType statsType, std::vector<int64_t>& levelTimesMs)
+{
+    levelTimesMs.clear();
+    if (statsType != StatsUtils::STATS_TYPE_SCREEN_BRIGHTNESS) {
+        return;
+    }
+    int64_t nowMs = StatsHelper::GetComputeTimeMs();
+    levelTimesMs.reserve(BRIGHTNESS_LEVEL_NUM);
+    for (auto& timer : brightnessTimers_) {
+        levelTimesMs.push_back(timer.GetRunningTimeMs(nowMs));
+    }
+}
+
+void ScreenEntity::LoadAverageMa()
+{
+    // The power profile is loaded before any entity is computed and does not change afterwards
+    auto brightnessAverageMa = BatteryStatsService::GetInstance()->GetBatteryStatsParser()->GetAveragePowerMa(
+        StatsUtils::CURRENT_SCREEN_BRIGHTNESS);
+    for (size_t level = 0; level < BRIGHTNESS_LEVEL_NUM; level++) {
+        brightnessAverageMa_[level] = brightnessAverageMa * level;
+    }
+    isAverageMaLoaded_ = true;
+}
+
 void ScreenEntity::Calculate(int32_t uid)
 {
     auto bss = BatteryStatsService::GetInstance();
     auto screenOnAverageMa =
         bss->GetBatteryStatsParser()->GetAveragePowerMa(StatsUtils::CURRENT_SCREEN_ON);
     auto screenOnTimeMs = GetActiveTimeMs(StatsUtils::STATS_TYPE_SCREEN_ON);
-    double screenOnPowerMah = screenOnAverageMa * screenOnTimeMs;
-
-    auto brightnessAverageMa =
-        bss->GetBatteryStatsParser()->GetAveragePowerMa(StatsUtils::CURRENT_SCREEN_BRIGHTNESS);
-    double brightnessPowerMah = StatsUtils::DEFAULT_VALUE;
-    for (auto& iter : screenBrightnessTimerMap_) {
-        if (iter.second != nullptr) {
-            auto averageMa = brightnessAverageMa * iter.first;
-            auto timeMs = GetActiveTimeMs(StatsUtils::STATS_TYPE_SCREEN_BRIGHTNESS, iter.first);
-            brightnessPowerMah += averageMa * timeMs;
-        }
+    int64_t screenOnEnergyNah = StatsUtils::ConvertToEnergyNah(screenOnAverageMa, screenOnTimeMs);
+
+    if (!isAverageMaLoaded_) {
+        LoadAverageMa();
+    }
+    int64_t nowMs = StatsHelper::GetComputeTimeMs();
+    int64_t brightnessEnergyNah = StatsUtils::DEFAULT_VALUE;
+    for (size_t level = 0; level < BRIGHTNESS_LEVEL_NUM; level++) {
+        brightnessEnergyNah += StatsUtils::ConvertToEnergyNah(brightnessAverageMa_[level],
+            brightnessTimers_[level].GetRunningTimeMs(nowMs));
     }
 
-    screenPowerMah_ = (screenOnPowerMah + brightnessPowerMah) / StatsUtils::MS_IN_HOUR;
-    totalPowerMah_ += screenPowerMah_;
-    std::shared_ptr<BatteryStatsInfo> statsInfo = std::make_shared<BatteryStatsInfo>();
-    statsInfo->SetConsumptioType(BatteryStatsInfo::CONSUMPTION_TYPE_SCREEN);
-    statsInfo->SetPower(screenPowerMah_);
+    screenEnergyNah_ = screenOnEnergyNah + brightnessEnergyNah;
+    totalEnergyNah_ += screenEnergyNah_;
+    std::shared_ptr<BatteryStatsInfo> statsInfo = statsInfoPool_.Acquire(BatteryStatsInfo::CONSUMPTION_TYPE_SCREEN);
+    statsInfo->SetPower(StatsUtils::ConvertToPowerMah(screenEnergyNah_));
     statsInfoList_.push_back(statsInfo);
-    STATS_HILOGD(COMP_SVC, "Calculate screen active power consumption: %{public}lfmAh", screenPowerMah_);
+    STATS_HILOGD(COMP_SVC, "Calculate screen active energy consumption: %{public}" PRId64 "nAh", screenEnergyNah_);
 }
 
 double ScreenEntity::GetEntityPowerMah(int32_t uidOrUserId)
 {
-    return screenPowerMah_;
+    return StatsUtils::ConvertToPowerMah(screenEnergyNah_);
 }
 
 double ScreenEntity::GetStatsPowerMah(StatsUtils::StatsType statsType, int32_t uid)
 {
-    return screenPowerMah_;
+    return StatsUtils::ConvertToPowerMah(screenEnergyNah_);
 }
 
 std::shared_ptr<StatsHelper::ActiveTimer> ScreenEntity::GetOrCreateTimer(StatsUtils::StatsType statsType, int16_t level)
@@ -132,17 +154,9 @@ std::shared_ptr<StatsHelper::ActiveTimer> ScreenEntity::GetOrCreateTimer(StatsUt
                 STATS_HILOGD(COMP_SVC, "Illegal brightness");
                 break;
             }
-            auto iter = screenBrightnessTimerMap_.find(level);
-            if (iter != screenBrightnessTimerMap_.end() && iter->second != nullptr) {
-                STATS_HILOGD(COMP_SVC, "Get screen brightness timer of brightness level: %{public}d", level);
-                timer = iter->second;
-                break;
-            }
-            STATS_HILOGD(COMP_SVC, "Create screen brightness timer of brightness level: %{public}d", level);
-            std::shared_ptr<StatsHelper::ActiveTimer> brightnessTimer = std::make_shared<StatsHelper::ActiveTimer>();
-            screenBrightnessTimerMap_.insert(
-                std::pair<int32_t, std::shared_ptr<StatsHelper::ActiveTimer>>(level, brightnessTimer));
-            timer = brightnessTimer;
+            STATS_HILOGD(COMP_SVC, "Get screen brightness timer of brightness level: %{public}d", level);
+            // The timer is owned by the entity, the returned pointer only aliases it
+            timer = std::shared_ptr<StatsHelper::ActiveTimer>(std::shared_ptr<void>(), &brightnessTimers_[level]);
             break;
         }
         default:
@@ -155,7 +169,7 @@ std::shared_ptr<StatsHelper::ActiveTimer> ScreenEntity::GetOrCreateTimer(StatsUt
 void ScreenEntity::Reset()
 {
     // Reset app Screen total power consumption
-    screenPowerMah_ = StatsUtils::DEFAULT_VALUE;
+    screenEnergyNah_ = StatsUtils::DEFAULT_VALUE;
 
     // Reset Screen on timer
     if (screenOnTimer_ != nullptr) {
@@ -163,10 +177,8 @@ void ScreenEntity::Reset()
     }
 
     // Reset Screen brightness timer
-    for (auto& iter : screenBrightnessTimerMap_) {
-        if (iter.second != nullptr) {
-            iter.second->Reset();
-        }
+    for (auto& timer : brightnessTimers_) {
+        timer.Reset();
     }
 }
 
@@ -35,9 +35,9 @@ int64_t SensorEntity::GetActiveTimeMs(int32_t uid, StatsUtils::StatsType statsTy
     int64_t activeTimeMs = StatsUtils::DEFAULT_VALUE;
     switch (statsType) {
         case StatsUtils::STATS_TYPE_SENSOR_GRAVITY_ON: {
-            auto gravityIter = gravityTimerMap_.find(uid);
-            if (gravityIter != gravityTimerMap_.end()) {
-                activeTimeMs = gravityIter->second->GetRunningTimeMs();
+            auto timer = uidSlab_.GetTimer(uid, BatteryStatsUidSlab::TIMER_SENSOR_GRAVITY_ON);
+            if (timer != nullptr) {
+                activeTimeMs = timer->GetRunningTimeMs();
                 STATS_HILOGD(COMP_SVC, "Get gravity on time: %{public}" PRId64 "ms for uid: %{public}d",
                     activeTimeMs, uid);
                 break;
@@ -46,9 +46,9 @@ int64_t SensorEntity::GetActiveTimeMs(int32_t uid, StatsUtils::StatsType statsTy
             break;
         }
         case StatsUtils::STATS_TYPE_SENSOR_PROXIMITY_ON: {
-            auto proximityIter = proximityTimerMap_.find(uid);
-            if (proximityIter != proximityTimerMap_.end()) {
-                activeTimeMs = proximityIter->second->GetRunningTimeMs();
+            auto timer = uidSlab_.GetTimer(uid, BatteryStatsUidSlab::TIMER_SENSOR_PROXIMITY_ON);
+            if (timer != nullptr) {
+                activeTimeMs = timer->GetRunningTimeMs();
                 STATS_HILOGD(COMP_SVC, "Get proximity on time: %{public}" PRId64 "ms for uid: %{public}d",
                     activeTimeMs, uid);
                 break;
@@ -62,70 +62,70 @@ int64_t SensorEntity::GetActiveTimeMs(int32_t uid, StatsUtils::StatsType statsTy
     return activeTimeMs;
 }
 
-double SensorEntity::CalculateGravity(int32_t uid)
+int64_t SensorEntity::CalculateGravity(int32_t uid)
 {
     auto bss = BatteryStatsService::GetInstance();
     auto gravityOnAverageMa =
         bss->GetBatteryStatsParser()->GetAveragePowerMa(StatsUtils::CURRENT_SENSOR_GRAVITY);
     auto gravityOnTimeMs = GetActiveTimeMs(uid, StatsUtils::STATS_TYPE_SENSOR_GRAVITY_ON);
-    auto gravityOnPowerMah = gravityOnAverageMa * gravityOnTimeMs / StatsUtils::MS_IN_HOUR;
-    auto gravityIter = gravityPowerMap_.find(uid);
-    if (gravityIter != gravityPowerMap_.end()) {
+    int64_t gravityOnEnergyNah = StatsUtils::ConvertToEnergyNah(gravityOnAverageMa, gravityOnTimeMs);
+    auto gravityIter = gravityEnergyMap_.find(uid);
+    if (gravityIter != gravityEnergyMap_.end()) {
         STATS_HILOGD(COMP_SVC, "Update gravity on power consumption: %{public}lfmAh for uid: %{public}d",
             gravityOnAverageMa, uid);
-        gravityIter->second = gravityOnPowerMah;
+        gravityIter->second = gravityOnEnergyNah;
     } else {
         STATS_HILOGD(COMP_SVC, "Create gravity on power consumption: %{public}lfmAh for uid: %{public}d",
             gravityOnAverageMa, uid);
-        gravityPowerMap_.insert(std::pair<int32_t, double>(uid, gravityOnPowerMah));
+        gravityEnergyMap_.insert(std::pair<int32_t, int64_t>(uid, gravityOnEnergyNah));
     }
-    return gravityOnPowerMah;
+    return gravityOnEnergyNah;
 }
 
-double SensorEntity::CalculateProximity(int32_t uid)
+int64_t SensorEntity::CalculateProximity(int32_t uid)
 {
     auto bss = BatteryStatsService::GetInstance();
     auto proximityOnAverageMa =
         bss->GetBatteryStatsParser()->GetAveragePowerMa(StatsUtils::CURRENT_SENSOR_PROXIMITY);
     auto proximityOnTimeMs = GetActiveTimeMs(uid, StatsUtils::STATS_TYPE_SENSOR_PROXIMITY_ON);
-    auto proximityOnPowerMah = proximityOnAverageMa * proximityOnTimeMs / StatsUtils::MS_IN_HOUR;
-    auto proximityIter = proximityPowerMap_.find(uid);
-    if (proximityIter != proximityPowerMap_.end()) {
+    int64_t proximityOnEnergyNah = StatsUtils::ConvertToEnergyNah(proximityOnAverageMa, proximityOnTimeMs);
+    auto proximityIter = proximityEnergyMap_.find(uid);
+    if (proximityIter != proximityEnergyMap_.end()) {
         STATS_HILOGD(COMP_SVC, "Update proximity on power consumption: %{public}lfmAh for uid: %{public}d",
             proximityOnAverageMa, uid);
-        proximityIter->second = proximityOnPowerMah;
+        proximityIter->second = proximityOnEnergyNah;
     } else {
         STATS_HILOGD(COMP_SVC, "Create proximity on power consumption: %{public}lfmAh for uid: %{public}d",
             proximityOnAverageMa, uid);
-        proximityPowerMap_.insert(std::pair<int32_t, double>(uid, proximityOnPowerMah));
+        proximityEnergyMap_.insert(std::pair<int32_t, int64_t>(uid, proximityOnEnergyNah));
     }
-    return proximityOnPowerMah;
+    return proximityOnEnergyNah;
 }
 
 void SensorEntity::Calculate(int32_t uid)
 {
-    auto gravityOnPowerMah = CalculateGravity(uid);
-    auto proximityOnPowerMah = CalculateProximity(uid);
+    auto gravityOnEnergyNah = CalculateGravity(uid);
+    auto proximityOnEnergyNah = CalculateProximity(uid);
 
-    double sensorTotalPowerMah = gravityOnPowerMah + proximityOnPowerMah;
-    auto sensorIter = sensorTotalPowerMap_.find(uid);
-    if (sensorIter != sensorTotalPowerMap_.end()) {
+    int64_t sensorTotalEnergyNah = gravityOnEnergyNah + proximityOnEnergyNah;
+    auto sensorIter = sensorTotalEnergyMap_.find(uid);
+    if (sensorIter != sensorTotalEnergyMap_.end()) {
         STATS_HILOGD(COMP_SVC, "Update sensor total power consumption: %{public}lfmAh for uid: %{public}d",
-            sensorTotalPowerMah, uid);
-        sensorIter->second = sensorTotalPowerMah;
+            StatsUtils::ConvertToPowerMah(sensorTotalEnergyNah), uid);
+        sensorIter->second = sensorTotalEnergyNah;
     } else {
         STATS_HILOGD(COMP_SVC, "Create sensor total power consumption: %{public}lfmAh for uid: %{public}d",
-            sensorTotalPowerMah, uid);
-        sensorTotalPowerMap_.insert(std::pair<int32_t, double>(uid, sensorTotalPowerMah));
+            StatsUtils::ConvertToPowerMah(sensorTotalEnergyNah), uid);
+        sensorTotalEnergyMap_.insert(std::pair<int32_t, int64_t>(uid, sensorTotalEnergyNah));
     }
 }
 
 double SensorEntity::GetEntityPowerMah(int32_t uidOrUserId)
 {
     double power = StatsUtils::DEFAULT_VALUE;
-    auto iter = sensorTotalPowerMap_.find(uidOrUserId);
-    if (iter != sensorTotalPowerMap_.end()) {
-        power = iter->second;
+    auto iter = sensorTotalEnergyMap_.find(uidOrUserId);
+    if (iter != sensorTotalEnergyMap_.end()) {
+        power = StatsUtils::ConvertToPowerMah(iter->second);
         STATS_HILOGD(COMP_SVC, "Get app sensor power consumption: %{public}lfmAh for uid: %{public}d",
             power, uidOrUserId);
     } else {
@@ -139,9 +139,9 @@ double SensorEntity::GetStatsPowerMah(StatsUtils::StatsType statsType, int32_t u
 {
     double power = StatsUtils::DEFAULT_VALUE;
     if (statsType == StatsUtils::STATS_TYPE_SENSOR_GRAVITY_ON) {
-        auto gravityOnIter = gravityPowerMap_.find(uid);
-        if (gravityOnIter != gravityPowerMap_.end()) {
-            power = gravityOnIter->second;
+        auto gravityOnIter = gravityEnergyMap_.find(uid);
+        if (gravityOnIter != gravityEnergyMap_.end()) {
+            power = StatsUtils::ConvertToPowerMah(gravityOnIter->second);
             STATS_HILOGD(COMP_SVC, "Get gravity on power consumption: %{public}lfmAh for uid: %{public}d",
                 power, uid);
         } else {
@@ -149,9 +149,9 @@ double SensorEntity::GetStatsPowerMah(StatsUtils::StatsType statsType, int32_t u
                 "No gravity on power consumption related to uid: %{public}d was found, return 0", uid);
         }
     } else if (statsType == StatsUtils::STATS_TYPE_SENSOR_PROXIMITY_ON) {
-        auto proximityOnIter = proximityPowerMap_.find(uid);
-        if (proximityOnIter != proximityPowerMap_.end()) {
-            power = proximityOnIter->second;
+        auto proximityOnIter = proximityEnergyMap_.find(uid);
+        if (proximityOnIter != proximityEnergyMap_.end()) {
+            power = StatsUtils::ConvertToPowerMah(proximityOnIter->second);
             STATS_HILOGD(COMP_SVC, "Get proximity on power consumption: %{public}lfmAh for uid: %{public}d",
                 power, uid);
         } else {
@@ -168,31 +168,11 @@ std::shared_ptr<StatsHelper::ActiveTimer> SensorEntity::GetOrCreateTimer(int32_t
     std::shared_ptr<StatsHelper::ActiveTimer> timer = nullptr;
     switch (statsType) {
         case StatsUtils::STATS_TYPE_SENSOR_GRAVITY_ON: {
-            auto gravityOnIter = gravityTimerMap_.find(uid);
-            if (gravityOnIter != gravityTimerMap_.end()) {
-                STATS_HILOGD(COMP_SVC, "Get gravity on timer for uid: %{public}d", uid);
-                timer = gravityOnIter->second;
-                break;
-            }
-            STATS_HILOGD(COMP_SVC, "Create gravity on timer for uid: %{public}d", uid);
-            std::shared_ptr<StatsHelper::ActiveTimer> gravityTimer = std::make_shared<StatsHelper::ActiveTimer>();
-            gravityTimerMap_.insert(
-                std::pair<int32_t, std::shared_ptr<StatsHelper::ActiveTimer>>(uid, gravityTimer));
-            timer = gravityTimer;
+            timer = uidSlab_.GetOrCreateTimer(uid, BatteryStatsUidSlab::TIMER_SENSOR_GRAVITY_ON);
             break;
         }
         case StatsUtils::STATS_TYPE_SENSOR_PROXIMITY_ON: {
-            auto proximityOnIter = proximityTimerMap_.find(uid);
-            if (proximityOnIter != proximityTimerMap_.end()) {
-                STATS_HILOGD(COMP_SVC, "Get proximity on timer for uid: %{public}d", uid);
-                timer = proximityOnIter->second;
-                break;
-            }
-            STATS_HILOGD(COMP_SVC, "Create proximity on timer for uid: %{public}d", uid);
-            std::shared_ptr<StatsHelper::ActiveTimer> proximityTimer = std::make_shared<StatsHelper::ActiveTimer>();
-            proximityTimerMap_.insert(
-                std::pair<int32_t, std::shared_ptr<StatsHelper::ActiveTimer>>(uid, proximityTimer));
-            timer = proximityTimer;
+            timer = uidSlab_.GetOrCreateTimer(uid, BatteryStatsUidSlab::TIMER_SENSOR_PROXIMITY_ON);
             break;
         }
         default:
@@ -202,36 +182,38 @@ std::shared_ptr<StatsHelper::ActiveTimer> SensorEntity::GetOrCreateTimer(int32_t
     return timer;
 }
 
+size_t SensorEntity::RemoveUid(int32_t uid)
+{
+    size_t count = uidSlab_.ReleaseTimer(uid, BatteryStatsUidSlab::TIMER_SENSOR_GRAVITY_ON);
+    count += uidSlab_.ReleaseTimer(uid, BatteryStatsUidSlab::TIMER_SENSOR_PROXIMITY_ON);
+    count += sensorTotalEnergyMap_.erase(uid);
+    count += gravityEnergyMap_.erase(uid);
+    count += proximityEnergyMap_.erase(uid);
+    return count;
+}
+
 void SensorEntity::Reset()
 {
     // Reset app sensor total power consumption
-    for (auto& iter : sensorTotalPowerMap_) {
+    for (auto& iter : sensorTotalEnergyMap_) {
         iter.second = StatsUtils::DEFAULT_VALUE;
     }
 
     // Reset app gravity on total power consumption
-    for (auto& iter : gravityPowerMap_) {
+    for (auto& iter : gravityEnergyMap_) {
         iter.second = StatsUtils::DEFAULT_VALUE;
     }
 
     // Reset app proximity on total power consumption
-    for (auto& iter : proximityPowerMap_) {
+    for (auto& iter : proximityEnergyMap_) {
         iter.second = StatsUtils::DEFAULT_VALUE;
     }
 
     // Reset gravity on timer
-    for (auto& iter : gravityTimerMap_) {
-        if (iter.second) {
-            iter.second->Reset();
-        }
-    }
+    uidSlab_.ResetTimers(BatteryStatsUidSlab::TIMER_SENSOR_GRAVITY_ON);
 
     // Reset proximity on timer
-    for (auto& iter : proximityTimerMap_) {
-        if (iter.second) {
-            iter.second->Reset();
-        }
-    }
+    uidSlab_.ResetTimers(BatteryStatsUidSlab::TIMER_SENSOR_PROXIMITY_ON);
 }
 } // namespace PowerMgr
 } // namespace OHOS
\ No newline at end of file
@@ -15,21 +15,25 @@
 
 #include "entities/uid_entity.h"
 
-#ifdef SYS_MGR_CLIENT_ENABLE
-#include <bundle_constants.h>
-#include <bundle_mgr_interface.h>
-#include <ipc_skeleton.h>
-#include <system_ability_definition.h>
-#include <sys_mgr_client.h>
-#endif
-
-#include <ohos_account_kits_impl.h>
+#include <cinttypes>
+
 #include "battery_stats_service.h"
 #include "stats_log.h"
 
 namespace OHOS {
 namespace PowerMgr {
 namespace {
+const BatteryStatsInfo::ConsumptionType PER_UID_TYPES[] = {
+    BatteryStatsInfo::CONSUMPTION_TYPE_BLUETOOTH,
+    BatteryStatsInfo::CONSUMPTION_TYPE_CAMERA,
+    BatteryStatsInfo::CONSUMPTION_TYPE_FLASHLIGHT,
+    BatteryStatsInfo::CONSUMPTION_TYPE_AUDIO,
+    BatteryStatsInfo::CONSUMPTION_TYPE_SENSOR,
+    BatteryStatsInfo::CONSUMPTION_TYPE_GNSS,
+    BatteryStatsInfo::CONSUMPTION_TYPE_CPU,
+    BatteryStatsInfo::CONSUMPTION_TYPE_WAKELOCK,
+    BatteryStatsInfo::CONSUMPTION_TYPE_ALARM,
+};
 }
 
 UidEntity::UidEntity()
@@ -41,12 +45,22 @@ void UidEntity::UpdateUidMap(int32_t uid)
 {
     std::lock_guard<std::mutex> lock(uidEntityMutex_);
     if (uid > StatsUtils::INVALID_VALUE) {
-        auto iter = uidPowerMap_.find(uid);
-        if (iter != uidPowerMap_.end()) {
+        auto iter = uidEnergyMap_.find(uid);
+        if (iter != uidEnergyMap_.end()) {
             STATS_HILOGD(COMP_SVC, "Uid has already been added, ignore");
         } else {
             STATS_HILOGD(COMP_SVC, "Update %{public}d to uid power map", uid);
-            uidPowerMap_.insert(std::pair<int32_t, double>(uid, StatsUtils::DEFAULT_VALUE));
+            uidEnergyMap_.insert(std::pair<int32_t, int64_t>(uid, StatsUtils::DEFAULT_VALUE));
+        }
+    }
+}
+
+void UidEntity::UpdateUidMap(const std::vector<int32_t>& uids)
+{
+    std::lock_guard<std::mutex> lock(uidEntityMutex_);
+    for (auto uid : uids) {
+        if (uid > StatsUtils::INVALID_VALUE) {
+            uidEnergyMap_.emplace(uid, StatsUtils::DEFAULT_VALUE);
         }
     }
 }
@@ -55,29 +69,30 @@ std::vector<int32_t> UidEntity::GetUids()
 {
     std::lock_guard<std::mutex> lock(uidEntityMutex_);
     std::vector<int32_t> uids;
-    std::transform(uidPowerMap_.begin(), uidPowerMap_.end(), std::back_inserter(uids), [](const auto& item) {
+    std::transform(uidEnergyMap_.begin(), uidEnergyMap_.end(), std::back_inserter(uids), [](const auto& item) {
         return item.first;
     });
     return uids;
 }
 
-double UidEntity::CalculateForConnectivity(int32_t uid)
+int64_t UidEntity::CalculateForConnectivity(int32_t uid)
 {
-    double power = StatsUtils::DEFAULT_VALUE;
+    int64_t energyNah = StatsUtils::DEFAULT_VALUE;
     auto bss = BatteryStatsService::GetInstance();
     auto core = bss->GetBatteryStatsCore();
     auto bluetoothEntity = core->GetEntity(BatteryStatsInfo::CONSUMPTION_TYPE_BLUETOOTH);
 
     // Calculate bluetooth power consumption
     bluetoothEntity->Calculate(uid);
-    power += bluetoothEntity->GetEntityPowerMah(uid);
-    STATS_HILOGD(COMP_SVC, "Connectivity power consumption: %{public}lfmAh for uid: %{public}d", power, uid);
-    return power;
+    energyNah += bluetoothEntity->GetEntityEnergyNah(uid);
+    STATS_HILOGD(COMP_SVC, "Connectivity energy consumption: %{public}" PRId64 "nAh for uid: %{public}d",
+        energyNah, uid);
+    return energyNah;
 }
 
-double UidEntity::CalculateForCommon(int32_t uid)
+int64_t UidEntity::CalculateForCommon(int32_t uid)
 {
-    double power = StatsUtils::DEFAULT_VALUE;
+    int64_t energyNah = StatsUtils::DEFAULT_VALUE;
     auto bss = BatteryStatsService::GetInstance();
     auto core = bss->GetBatteryStatsCore();
     auto cameraEntity = core->GetEntity(BatteryStatsInfo::CONSUMPTION_TYPE_CAMERA);
@@ -91,31 +106,31 @@ double UidEntity::CalculateForCommon(int32_t uid)
 
     // Calculate camera power consumption
     cameraEntity->Calculate(uid);
-    power += cameraEntity->GetEntityPowerMah(uid);
+    energyNah += cameraEntity->GetEntityEnergyNah(uid);
     // Calculate flashlight power consumption
     flashlightEntity->Calculate(uid);
-    power += flashlightEntity->GetEntityPowerMah(uid);
+    energyNah += flashlightEntity->GetEntityEnergyNah(uid);
     // Calculate audio power consumption
     audioEntity->Calculate(uid);
-    power += audioEntity->GetEntityPowerMah(uid);
+    energyNah += audioEntity->GetEntityEnergyNah(uid);
     // Calculate sensor power consumption
     sensorEntity->Calculate(uid);
-    power += sensorEntity->GetEntityPowerMah(uid);
+    energyNah += sensorEntity->GetEntityEnergyNah(uid);
     // Calculate gnss power consumption
     gnssEntity->Calculate(uid);
-    power += gnssEntity->GetEntityPowerMah(uid);
+    energyNah += gnssEntity->GetEntityEnergyNah(uid);
     // Calculate cpu power consumption
     cpuEntity->Calculate(uid);
-    power += cpuEntity->GetEntityPowerMah(uid);
+    energyNah += cpuEntity->GetEntityEnergyNah(uid);
     // Calculate cpu power consumption
     wakelockEntity->Calculate(uid);
-    power += wakelockEntity->GetEntityPowerMah(uid);
+    energyNah += wakelockEntity->GetEntityEnergyNah(uid);
     // Calculate alarm power consumption
     alarmEntity->Calculate(uid);
-    power += alarmEntity->GetEntityPowerMah(uid);
+    energyNah += alarmEntity->GetEntityEnergyNah(uid);
 
-    STATS_HILOGD(COMP_SVC, "Common power consumption: %{public}lfmAh for uid: %{public}d", power, uid);
-    return power;
+    STATS_HILOGD(COMP_SVC, "Common energy consumption: %{public}" PRId64 "nAh for uid: %{public}d", energyNah, uid);
+    return energyNah;
 }
 
 void UidEntity::Calculate(int32_t uid)
@@ -124,27 +139,101 @@ void UidEntity::Calculate(int32_t uid)
     std::lock_guard<std::mutex> lock(uidEntityMutex_);
     auto core = bss->GetBatteryStatsCore();
     auto userEntity = core->GetEntity(BatteryStatsInfo::CONSUMPTION_TYPE_USER);
-    for (auto& iter : uidPowerMap_) {
-        double power = StatsUtils::DEFAULT_VALUE;
-        power += CalculateForConnectivity(iter.first);
-        power += CalculateForCommon(iter.first);
-        iter.second = power;
-        totalPowerMah_ += power;
-        AddtoStatsList(iter.first, power);
-        int32_t uid = iter.first;
-        int32_t userId = AccountSA::OhosAccountKits::GetInstance().GetDeviceAccountIdByUID(uid);
+    std::vector<int32_t> idleUids;
+    int64_t nowMs = StatsHelper::GetBootTimeMs();
+    for (auto& iter : uidEnergyMap_) {
+        int64_t energyNah = StatsUtils::DEFAULT_VALUE;
+        energyNah += CalculateForConnectivity(iter.first);
+        energyNah += CalculateForCommon(iter.first);
+        iter.second = energyNah;
+        totalEnergyNah_ += energyNah;
+        AddtoStatsList(iter.first, energyNah);
+        int32_t appUid = iter.first;
+        int32_t userId = core->GetUserId(appUid);
         if (userEntity != nullptr) {
-            userEntity->AggregateUserPowerMah(userId, power);
+            userEntity->AggregateUserEnergyNah(userId, energyNah);
+        }
+        if (energyNah > StatsUtils::DEFAULT_VALUE || IsUidActive(appUid)) {
+            idleSinceMap_.erase(appUid);
+            continue;
         }
+        auto idleSince = idleSinceMap_.try_emplace(appUid, nowMs).first->second;
+        if (nowMs - idleSince >= idleCompactMs_) {
+            idleUids.push_back(appUid);
+        }
+    }
+    // Events are applied under the core lock as this pass is, so none can reach the rows while they are freed
+    for (int32_t idleUid : idleUids) {
+        RemoveUidLocked(idleUid, StatsUtils::DEFAULT_VALUE);
+        core->RemoveCoalescedUid(idleUid);
     }
+    AggregateRemovedPower();
 }
 
-void UidEntity::AddtoStatsList(int32_t uid, double power)
+void UidEntity::AggregateRemovedPower()
 {
-    std::shared_ptr<BatteryStatsInfo> statsInfo = std::make_shared<BatteryStatsInfo>();
-    statsInfo->SetConsumptioType(BatteryStatsInfo::CONSUMPTION_TYPE_APP);
+    // Removed apps only count in the totals, they are not listed as a consumer of their own
+    auto core = BatteryStatsService::GetInstance()->GetBatteryStatsCore();
+    auto userEntity = core->GetEntity(BatteryStatsInfo::CONSUMPTION_TYPE_USER);
+    for (const auto& [userId, energyNah] : removedEnergyMap_) {
+        totalEnergyNah_ += energyNah;
+        if (userEntity != nullptr) {
+            userEntity->AggregateUserEnergyNah(userId, energyNah);
+        }
+    }
+}
+
+size_t UidEntity::RemoveUid(int32_t uid)
+{
+    std::lock_guard<std::mutex> lock(uidEntityMutex_);
+    int64_t energyNah = StatsUtils::DEFAULT_VALUE;
+    energyNah += CalculateForConnectivity(uid);
+    energyNah += CalculateForCommon(uid);
+    size_t count = RemoveUidLocked(uid, energyNah);
+    STATS_HILOGI(COMP_SVC, "Remove uid: %{public}d, energy: %{public}" PRId64 "nAh, rows: %{public}zu",
+        uid, energyNah, count);
+    return count;
+}
+
+size_t UidEntity::RemoveUidLocked(int32_t uid, int64_t energyNah)
+{
+    auto core = BatteryStatsService::GetInstance()->GetBatteryStatsCore();
+    size_t count = uidEnergyMap_.erase(uid);
+    idleSinceMap_.erase(uid);
+    if (energyNah > StatsUtils::DEFAULT_VALUE) {
+        removedEnergyMap_[core->GetUserId(uid)] += energyNah;
+    }
+    for (auto type : PER_UID_TYPES) {
+        auto entity = core->GetEntity(type);
+        if (entity != nullptr) {
+            count += entity->RemoveUid(uid);
+        }
+    }
+    compactedUidCount_++;
+    freedRowCount_ += count;
+    return count;
+}
+
+bool UidEntity::IsUidActive(int32_t uid)
+{
+    if (uidSlab_.IsRowActive(uid)) {
+        return true;
+    }
+    auto core = BatteryStatsService::GetInstance()->GetBatteryStatsCore();
+    for (auto type : PER_UID_TYPES) {
+        auto entity = core->GetEntity(type);
+        if (entity != nullptr && entity->IsUidActive(uid)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void UidEntity::AddtoStatsList(int32_t uid, int64_t energyNah)
+{
+    std::shared_ptr<BatteryStatsInfo> statsInfo = statsInfoPool_.Acquire(BatteryStatsInfo::CONSUMPTION_TYPE_APP);
     statsInfo->SetUid(uid);
-    statsInfo->SetPower(power);
+    statsInfo->SetPower(StatsUtils::ConvertToPowerMah(energyNah));
     statsInfoList_.push_back(statsInfo);
 }
 
@@ -152,9 +241,9 @@ double UidEntity::GetEntityPowerMah(int32_t uidOrUserId)
 {
     std::lock_guard<std::mutex> lock(uidEntityMutex_);
     double power = StatsUtils::DEFAULT_VALUE;
-    auto iter = uidPowerMap_.find(uidOrUserId);
-    if (iter != uidPowerMap_.end()) {
-        power = iter->second;
+    auto iter = uidEnergyMap_.find(uidOrUserId);
+    if (iter != uidEnergyMap_.end()) {
+        power = StatsUtils::ConvertToPowerMah(iter->second);
         STATS_HILOGD(COMP_SVC, "Get app uid power consumption: %{public}lfmAh for uid: %{public}d",
             power, uidOrUserId);
     } else {
@@ -255,9 +344,38 @@ void UidEntity::Reset()
 {
     std::lock_guard<std::mutex> lock(uidEntityMutex_);
     // Reset app Uid total power consumption
-    for (auto& iter : uidPowerMap_) {
+    for (auto& iter : uidEnergyMap_) {
         iter.second = StatsUtils::DEFAULT_VALUE;
     }
+    idleSinceMap_.clear();
+    removedEnergyMap_.clear();
+}
+
+void UidEntity::DumpLifecycle(std::string& result)
+{
+    std::lock_guard<std::mutex> lock(uidEntityMutex_);
+    int64_t removedEnergyNah = StatsUtils::DEFAULT_VALUE;
+    for (const auto& item : removedEnergyMap_) {
+        removedEnergyNah += item.second;
+    }
+    uint64_t rowsPerUid = compactedUidCount_ > 0 ? freedRowCount_ / compactedUidCount_ : 0;
+    result.append("App uid lifecycle dump:\n")
+        .append("Live uids: ")
+        .append(ToString(uidEnergyMap_.size()))
+        .append(", idle uids: ")
+        .append(ToString(idleSinceMap_.size()))
+        .append(", compacted uids: ")
+        .append(ToString(compactedUidCount_))
+        .append(", freed rows: ")
+        .append(ToString(freedRowCount_))
+        .append(" (")
+        .append(ToString(rowsPerUid))
+        .append(" per uid), slab rows: ")
+        .append(ToString(uidSlab_.GetRowNum()))
+        .append("\n")
+        .append("Removed apps power: ")
+        .append(ToString(StatsUtils::ConvertToPowerMah(removedEnergyNah)))
+        .append("mAh\n");
 }
 
 void UidEntity::DumpForBluetooth(int32_t uid, std::string& result)
@@ -331,46 +449,45 @@ void UidEntity::DumpForCommon(int32_t uid, std::string& result)
 }
 
 void UidEntity::DumpInfo(std::string& result, int32_t uid)
+{
+    // Only the uid list is taken under the lock, missing bundle names are resolved in one batch
+    std::vector<int32_t> uids;
+    if (uid == StatsUtils::INVALID_VALUE) {
+        uids = GetUids();
+    } else {
+        uids.push_back(uid);
+    }
+    auto bundleCache = BatteryStatsService::GetInstance()->GetBatteryStatsBundleCache();
+    if (bundleCache != nullptr) {
+        bundleCache->Prefetch(uids);
+    }
+    for (int32_t item : uids) {
+        DumpForUid(item, result);
+    }
+}
+
+void UidEntity::DumpForUid(int32_t uid, std::string& result)
 {
     auto bss = BatteryStatsService::GetInstance();
-    std::lock_guard<std::mutex> lock(uidEntityMutex_);
     auto core = bss->GetBatteryStatsCore();
-    for (auto& iter : uidPowerMap_) {
-        std::string bundleName = "NULL";
-#ifdef SYS_MGR_CLIENT_ENABLE
-        auto bundleObj =
-            DelayedSingleton<AppExecFwk::SysMrgClient>::GetInstance()
-                ->GetSystemAbility(BUNDLE_MGR_SERVICE_SYS_ABILITY_ID);
-        if (bundleObj == nullptr) {
-            STATS_HILOGE(COMP_SVC, "Failed to get bundle manager service");
-        } else {
-            sptr<AppExecFwk::IBundleMgr> bmgr = iface_cast<AppExecFwk::IBundleMgr>(bundleObj);
-            if (bmgr == nullptr) {
-                STATS_HILOGE(COMP_SVC, "Failed to get bundle manager proxy");
-            } else {
-                std::string identity = IPCSkeleton::ResetCallingIdentity();
-                ErrCode res = bmgr->GetNameForUid(iter.first, bundleName);
-                IPCSkeleton::SetCallingIdentity(identity);
-                if (res != ERR_OK) {
-                    STATS_HILOGE(COMP_SVC, "Failed to get bundle name for uid=%{public}d, ErrCode=%{public}d",
-                        iter.first, static_cast<int32_t>(res));
-                }
-            }
-        }
-#endif
-        result.append("\n")
-            .append(ToString(iter.first))
-            .append("(Bundle name: ")
-            .append(bundleName)
-            .append(")")
-            .append(":")
-            .append("\n");
-        DumpForBluetooth(iter.first, result);
-        DumpForCommon(iter.first, result);
-        auto cpuEntity = core->GetEntity(BatteryStatsInfo::CONSUMPTION_TYPE_CPU);
-        if (cpuEntity) {
-            cpuEntity->DumpInfo(result, iter.first);
-        }
+    auto bundleCache = bss->GetBatteryStatsBundleCache();
+    std::string bundleName = bundleCache != nullptr ? bundleCache->PeekBundleName(uid) : "NULL";
+    result.append("\n")
+        .append(ToString(uid))
+        .append("(Bundle name: ")
+        .append(bundleName)
+        .append(")")
+        .append(":")
+        .append("\n");
+    DumpForBluetooth(uid, result);
+    DumpForCommon(uid, result);
+    auto cpuEntity = core->GetEntity(BatteryStatsInfo::CONSUMPTION_TYPE_CPU);
+    if (cpuEntity) {
+        cpuEntity->DumpInfo(result, uid);
+    }
+    auto cameraEntity = core->GetEntity(BatteryStatsInfo::CONSUMPTION_TYPE_CAMERA);
+    if (cameraEntity) {
+        cameraEntity->DumpInfo(result, uid);
     }
 }
 } // namespace PowerMgr
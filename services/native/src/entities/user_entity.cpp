@@ -15,7 +15,8 @@
 
 #include "entities/user_entity.h"
 
-#include "ohos_account_kits_impl.h"
+#include <cinttypes>
+
 #include "stats_log.h"
 
 #include "battery_stats_parser.h"
@@ -34,9 +35,9 @@ UserEntity::UserEntity()
 double UserEntity::GetEntityPowerMah(int32_t uidOrUserId)
 {
     double power = StatsUtils::DEFAULT_VALUE;
-    auto iter = userPowerMap_.find(uidOrUserId);
-    if (iter != userPowerMap_.end()) {
-        power = iter->second;
+    auto iter = userEnergyMap_.find(uidOrUserId);
+    if (iter != userEnergyMap_.end()) {
+        power = StatsUtils::ConvertToPowerMah(iter->second);
         STATS_HILOGD(COMP_SVC, "Get user power consumption: %{public}lfmAh for user id: %{public}d",
             power, uidOrUserId);
     } else {
@@ -46,27 +47,26 @@ double UserEntity::GetEntityPowerMah(int32_t uidOrUserId)
     return power;
 }
 
-void UserEntity::AggregateUserPowerMah(int32_t userId, double power)
+void UserEntity::AggregateUserEnergyNah(int32_t userId, int64_t energyNah)
 {
-    auto iter = userPowerMap_.find(userId);
-    if (iter != userPowerMap_.end()) {
-        iter->second += power;
-        STATS_HILOGD(COMP_SVC, "Add user power consumption: %{public}lfmAh for user id: %{public}d",
-            power, userId);
+    auto iter = userEnergyMap_.find(userId);
+    if (iter != userEnergyMap_.end()) {
+        iter->second += energyNah;
+        STATS_HILOGD(COMP_SVC, "Add user energy consumption: %{public}" PRId64 "nAh for user id: %{public}d",
+            energyNah, userId);
     } else {
-        STATS_HILOGD(COMP_SVC, "Create user power consumption: %{public}lfmAh for user id: %{public}d",
-            power, userId);
-        userPowerMap_.insert(std::pair<int32_t, double>(userId, power));
+        STATS_HILOGD(COMP_SVC, "Create user energy consumption: %{public}" PRId64 "nAh for user id: %{public}d",
+            energyNah, userId);
+        userEnergyMap_.insert(std::pair<int32_t, int64_t>(userId, energyNah));
     }
 }
 
 void UserEntity::Calculate(int32_t uid)
 {
-    for (auto& iter : userPowerMap_) {
-        std::shared_ptr<BatteryStatsInfo> statsInfo = std::make_shared<BatteryStatsInfo>();
-        statsInfo->SetConsumptioType(BatteryStatsInfo::CONSUMPTION_TYPE_USER);
+    for (auto& iter : userEnergyMap_) {
+        std::shared_ptr<BatteryStatsInfo> statsInfo = statsInfoPool_.Acquire(BatteryStatsInfo::CONSUMPTION_TYPE_USER);
         statsInfo->SetUserId(iter.first);
-        statsInfo->SetPower(iter.second);
+        statsInfo->SetPower(StatsUtils::ConvertToPowerMah(iter.second));
         statsInfoList_.push_back(statsInfo);
     }
 }
@@ -74,7 +74,7 @@ void UserEntity::Calculate(int32_t uid)
 void UserEntity::Reset()
 {
     // Reset app user total power consumption
-    for (auto& iter : userPowerMap_) {
+    for (auto& iter : userEnergyMap_) {
         iter.second = StatsUtils::DEFAULT_VALUE;
     }
 }
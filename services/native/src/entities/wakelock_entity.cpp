@@ -37,9 +37,9 @@ int64_t WakelockEntity::GetActiveTimeMs(int32_t uid, StatsUtils::StatsType stats
         return activeTimeMs;
     }
 
-    auto iter = wakelockTimerMap_.find(uid);
-    if (iter != wakelockTimerMap_.end()) {
-        activeTimeMs = iter->second->GetRunningTimeMs();
+    auto timer = uidSlab_.GetTimer(uid, BatteryStatsUidSlab::TIMER_WAKELOCK_HOLD);
+    if (timer != nullptr) {
+        activeTimeMs = timer->GetRunningTimeMs();
         STATS_HILOGD(COMP_SVC, "Get wakelock on time: %{public}" PRId64 "ms for uid: %{public}d", activeTimeMs, uid);
         return activeTimeMs;
     }
@@ -53,25 +53,25 @@ void WakelockEntity::Calculate(int32_t uid)
     auto wakelockOnAverageMa =
         bss->GetBatteryStatsParser()->GetAveragePowerMa(StatsUtils::CURRENT_CPU_AWAKE);
     auto wakelockOnTimeMs = GetActiveTimeMs(uid, StatsUtils::STATS_TYPE_WAKELOCK_HOLD);
-    auto wakelockOnPowerMah = wakelockOnAverageMa * wakelockOnTimeMs / StatsUtils::MS_IN_HOUR;
-    auto iter = wakelockPowerMap_.find(uid);
-    if (iter != wakelockPowerMap_.end()) {
+    int64_t wakelockOnEnergyNah = StatsUtils::ConvertToEnergyNah(wakelockOnAverageMa, wakelockOnTimeMs);
+    auto iter = wakelockEnergyMap_.find(uid);
+    if (iter != wakelockEnergyMap_.end()) {
         STATS_HILOGD(COMP_SVC, "Update wakelock on power consumption: %{public}lfmAh for uid: %{public}d",
-            wakelockOnPowerMah, uid);
-        iter->second = wakelockOnPowerMah;
+            StatsUtils::ConvertToPowerMah(wakelockOnEnergyNah), uid);
+        iter->second = wakelockOnEnergyNah;
     } else {
         STATS_HILOGD(COMP_SVC, "Create wakelock on power consumption: %{public}lfmAh for uid: %{public}d",
-            wakelockOnPowerMah, uid);
-        wakelockPowerMap_.insert(std::pair<int32_t, double>(uid, wakelockOnPowerMah));
+            StatsUtils::ConvertToPowerMah(wakelockOnEnergyNah), uid);
+        wakelockEnergyMap_.insert(std::pair<int32_t, int64_t>(uid, wakelockOnEnergyNah));
     }
 }
 
 double WakelockEntity::GetEntityPowerMah(int32_t uidOrUserId)
 {
     double power = StatsUtils::DEFAULT_VALUE;
-    auto iter = wakelockPowerMap_.find(uidOrUserId);
-    if (iter != wakelockPowerMap_.end()) {
-        power = iter->second;
+    auto iter = wakelockEnergyMap_.find(uidOrUserId);
+    if (iter != wakelockEnergyMap_.end()) {
+        power = StatsUtils::ConvertToPowerMah(iter->second);
         STATS_HILOGD(COMP_SVC, "Get app wakelock power consumption: %{public}lfmAh for uid: %{public}d",
             power, uidOrUserId);
     } else {
@@ -85,9 +85,9 @@ double WakelockEntity::GetStatsPowerMah(StatsUtils::StatsType statsType, int32_t
 {
     double power = StatsUtils::DEFAULT_VALUE;
     if (statsType == StatsUtils::STATS_TYPE_WAKELOCK_HOLD) {
-        auto wakelockOnIter = wakelockPowerMap_.find(uid);
-        if (wakelockOnIter != wakelockPowerMap_.end()) {
-            power = wakelockOnIter->second;
+        auto wakelockOnIter = wakelockEnergyMap_.find(uid);
+        if (wakelockOnIter != wakelockEnergyMap_.end()) {
+            power = StatsUtils::ConvertToPowerMah(wakelockOnIter->second);
             STATS_HILOGD(COMP_SVC, "Get wakelock on power consumption: %{public}lfmAh for uid: %{public}d",
                 power, uid);
         } else {
@@ -105,31 +105,24 @@ std::shared_ptr<StatsHelper::ActiveTimer> WakelockEntity::GetOrCreateTimer(int32
         return nullptr;
     }
 
-    auto wakelockOnIter = wakelockTimerMap_.find(uid);
-    if (wakelockOnIter != wakelockTimerMap_.end()) {
-        STATS_HILOGD(COMP_SVC, "Get wakelock on timer for uid: %{public}d", uid);
-        return wakelockOnIter->second;
-    }
-    STATS_HILOGD(COMP_SVC, "Create wakelock on timer for uid: %{public}d", uid);
-    std::shared_ptr<StatsHelper::ActiveTimer> holdTimer = std::make_shared<StatsHelper::ActiveTimer>();
-    wakelockTimerMap_.insert(std::pair<int32_t, std::shared_ptr<StatsHelper::ActiveTimer>>(uid, holdTimer));
-    return holdTimer;
+    return uidSlab_.GetOrCreateTimer(uid, BatteryStatsUidSlab::TIMER_WAKELOCK_HOLD);
+}
+
+size_t WakelockEntity::RemoveUid(int32_t uid)
+{
+    return uidSlab_.ReleaseTimer(uid, BatteryStatsUidSlab::TIMER_WAKELOCK_HOLD) + wakelockEnergyMap_.erase(uid);
 }
 
 void WakelockEntity::Reset()
 {
     // Reset app Wakelock on total power consumption
-    for (auto& iter : wakelockPowerMap_) {
+    for (auto& iter : wakelockEnergyMap_) {
         iter.second = StatsUtils::DEFAULT_VALUE;
     }
 
     STATS_HILOGI(COMP_SVC, "Reset Wakelock on timer.");
     // Reset Wakelock on timer
-    for (auto& iter : wakelockTimerMap_) {
-        if (iter.second) {
-            iter.second->Reset();
-        }
-    }
+    uidSlab_.ResetTimers(BatteryStatsUidSlab::TIMER_WAKELOCK_HOLD);
 }
 } // namespace PowerMgr
 } // namespace OHOS
\ No newline at end of file
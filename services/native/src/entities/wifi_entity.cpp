@@ -36,20 +36,19 @@ void WifiEntity::Calculate(int32_t uid)
     // Calculate Wifi on power
     auto wifiOnAverageMa = bss->GetBatteryStatsParser()->GetAveragePowerMa(StatsUtils::CURRENT_WIFI_ON);
     auto wifiOnTimeMs = GetActiveTimeMs(StatsUtils::STATS_TYPE_WIFI_ON);
-    auto wifiOnPowerMah = wifiOnAverageMa * wifiOnTimeMs / StatsUtils::MS_IN_HOUR;
+    int64_t wifiOnEnergyNah = StatsUtils::ConvertToEnergyNah(wifiOnAverageMa, wifiOnTimeMs);
 
     // Calculate Wifi scan power
     auto wifiScanAverageMa = bss->GetBatteryStatsParser()->GetAveragePowerMa(StatsUtils::CURRENT_WIFI_SCAN);
     auto wifiScanCount = GetConsumptionCount(StatsUtils::STATS_TYPE_WIFI_SCAN);
-    auto wifiScanPowerMah = wifiScanAverageMa * wifiScanCount;
+    int64_t wifiScanEnergyNah = StatsUtils::ConvertToEnergyNah(wifiScanAverageMa * wifiScanCount);
 
-    wifiPowerMah_ = wifiOnPowerMah + wifiScanPowerMah;
-    totalPowerMah_ += wifiPowerMah_;
-    std::shared_ptr<BatteryStatsInfo> statsInfo = std::make_shared<BatteryStatsInfo>();
-    statsInfo->SetConsumptioType(BatteryStatsInfo::CONSUMPTION_TYPE_WIFI);
-    statsInfo->SetPower(wifiPowerMah_);
+    wifiEnergyNah_ = wifiOnEnergyNah + wifiScanEnergyNah;
+    totalEnergyNah_ += wifiEnergyNah_;
+    std::shared_ptr<BatteryStatsInfo> statsInfo = statsInfoPool_.Acquire(BatteryStatsInfo::CONSUMPTION_TYPE_WIFI);
+    statsInfo->SetPower(StatsUtils::ConvertToPowerMah(wifiEnergyNah_));
     statsInfoList_.push_back(statsInfo);
-    STATS_HILOGD(COMP_SVC, "Calculate wifi power consumption: %{public}lfmAh", wifiPowerMah_);
+    STATS_HILOGD(COMP_SVC, "Calculate wifi energy consumption: %{public}" PRId64 "nAh", wifiEnergyNah_);
 }
 
 int64_t WifiEntity::GetActiveTimeMs(StatsUtils::StatsType statsType, int16_t level)
@@ -69,12 +68,12 @@ int64_t WifiEntity::GetActiveTimeMs(StatsUtils::StatsType statsType, int16_t lev
 
 double WifiEntity::GetEntityPowerMah(int32_t uidOrUserId)
 {
-    return wifiPowerMah_;
+    return StatsUtils::ConvertToPowerMah(wifiEnergyNah_);
 }
 
 double WifiEntity::GetStatsPowerMah(StatsUtils::StatsType statsType, int32_t uid)
 {
-    return wifiPowerMah_;
+    return StatsUtils::ConvertToPowerMah(wifiEnergyNah_);
 }
 
 int64_t WifiEntity::GetConsumptionCount(StatsUtils::StatsType statsType, int32_t uid)
@@ -123,7 +122,7 @@ std::shared_ptr<StatsHelper::Counter> WifiEntity::GetOrCreateCounter(StatsUtils:
 void WifiEntity::Reset()
 {
     // Reset Wifi power consumption
-    wifiPowerMah_ = StatsUtils::DEFAULT_VALUE;
+    wifiEnergyNah_ = StatsUtils::DEFAULT_VALUE;
 
     // Reset Wifi on timer
     if (wifiOnTimer_) {
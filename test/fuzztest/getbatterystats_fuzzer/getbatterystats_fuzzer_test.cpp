@@ -32,5 +32,7 @@ extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
     /* Run your code on data */
     g_serviceTest.TestStatsServiceStub(
         static_cast<uint32_t>(IBatteryStatsIpcCode::COMMAND_GET_BATTERY_STATS_IPC), data, size);
+    g_serviceTest.TestStatsServiceStub(
+        static_cast<uint32_t>(IBatteryStatsIpcCode::COMMAND_GET_BATTERY_STATS_PACKED_IPC), data, size);
     return 0;
 }
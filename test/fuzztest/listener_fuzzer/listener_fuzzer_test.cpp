@@ -154,8 +154,10 @@ private:
         }
 
         size_t copyLen = std::min(DEBUG_INFO_MAX_LENGTH, size - offset);
-        std::string debugInfo(reinterpret_cast<const char*>(&data[offset]), copyLen);
-        core->UpdateDebugInfo(debugInfo);
+        StatsUtils::StatsData debugData;
+        debugData.type = StatsUtils::STATS_TYPE_THERMAL;
+        debugData.eventDebugInfo.assign(reinterpret_cast<const char*>(&data[offset]), copyLen);
+        core->UpdateDebugInfo(debugData);
 
         std::string dumpResult;
         core->GetDebugInfo(dumpResult);
@@ -118,8 +118,10 @@ public:
         // Fuzz debug info
         if (offset + DEBUG_INFO_INPUT_BYTES <= size) {
             size_t copyLen = std::min(DEBUG_INFO_MAX_LENGTH, size - offset);
-            std::string debugInfo(reinterpret_cast<const char*>(&data[offset]), copyLen);
-            core->UpdateDebugInfo(debugInfo);
+            StatsUtils::StatsData debugData;
+            debugData.type = StatsUtils::STATS_TYPE_THERMAL;
+            debugData.eventDebugInfo.assign(reinterpret_cast<const char*>(&data[offset]), copyLen);
+            core->UpdateDebugInfo(debugData);
 
             std::string getDebugResult;
             core->GetDebugInfo(getDebugResult);
@@ -41,6 +41,11 @@ public:
     int32_t GetTotalDataBytesIpc(int32_t statsType, int32_t uid, uint64_t& totalDataBytes);
     int32_t ResetIpc();
     int32_t ShellDumpIpc(const std::vector<std::string>& args, uint32_t argc, std::string& dumpShell);
+    int32_t GetAppStatsBatchIpc(const std::vector<int32_t>& uids, uint32_t fieldMask,
+        std::vector<double>& appStatsMah, std::vector<double>& appStatsPercent,
+        ParcelableBatteryStatsList& breakdown, int32_t& tempError);
+    int32_t GetTopConsumersIpc(uint32_t topNum, int32_t type, uint64_t epoch,
+        ParcelableBatteryStatsList& topConsumers, uint64_t& currentEpoch, int32_t& tempError);
 
 private:
     static constexpr OHOS::HiviewDFX::HiLogLabel LABEL = {LOG_CORE, 0xD000F00, "StatsTest"};
@@ -18,6 +18,8 @@
 #ifdef HAS_BATTERYSTATS_CALL_MANAGER_PART
 #include <call_manager_inner_type.h>
 #endif
+#include <chrono>
+#include <cinttypes>
 #include <hisysevent.h>
 
 #include "battery_stats_client.h"
@@ -424,6 +426,101 @@ HWTEST_F (StatsPowerMgrTest, BatteryStatsInfo_002, TestSize.Level0)
     STATS_HILOGI(LABEL_TEST, "BatteryStatsInfo_002 end");
 }
 
+/**
+ * @tc.name: BatteryStatsInfo_003
+ * @tc.desc: test class ParcelableBatteryStatsList packed and legacy layouts
+ * @tc.type: FUNC
+ */
+HWTEST_F (StatsPowerMgrTest, BatteryStatsInfo_003, TestSize.Level0)
+{
+    STATS_HILOGI(LABEL_TEST, "BatteryStatsInfo_003 start");
+    int32_t userId = 100;
+    double userPowerMah = 12.5;
+    ParcelableBatteryStatsList statsList;
+    auto userInfo = std::make_shared<BatteryStatsInfo>();
+    userInfo->SetUserId(userId);
+    userInfo->SetConsumptioType(BatteryStatsInfo::CONSUMPTION_TYPE_USER);
+    userInfo->SetPower(userPowerMah);
+    statsList.statsList_.push_back(userInfo);
+    statsList.statsList_.push_back(nullptr);
+
+    // Lists are written in the legacy layout unless the IPC asks for the packed one
+    Parcel defaultParcel;
+    EXPECT_TRUE(statsList.Marshalling(defaultParcel));
+    EXPECT_EQ(1, defaultParcel.ReadInt32());
+    defaultParcel.RewindRead(0);
+    std::unique_ptr<ParcelableBatteryStatsList> defaultList(ParcelableBatteryStatsList::Unmarshalling(defaultParcel));
+    ASSERT_NE(nullptr, defaultList);
+    ASSERT_EQ(1, defaultList->statsList_.size());
+    EXPECT_EQ(BatteryStatsInfo::CONSUMPTION_TYPE_USER, defaultList->statsList_.front()->GetConsumptionType());
+    EXPECT_DOUBLE_EQ(userPowerMah, defaultList->statsList_.front()->GetPower());
+
+    statsList.isPacked_ = true;
+    Parcel packedParcel;
+    EXPECT_TRUE(statsList.Marshalling(packedParcel));
+    std::unique_ptr<ParcelableBatteryStatsList> packedList(ParcelableBatteryStatsList::Unmarshalling(packedParcel));
+    ASSERT_NE(nullptr, packedList);
+    ASSERT_EQ(1, packedList->statsList_.size());
+    auto packedInfo = packedList->statsList_.front();
+    EXPECT_EQ(userId, packedInfo->GetUserId());
+    EXPECT_EQ(BatteryStatsInfo::CONSUMPTION_TYPE_USER, packedInfo->GetConsumptionType());
+    EXPECT_DOUBLE_EQ(userPowerMah, packedInfo->GetPower());
+
+    int32_t uid = 10010;
+    double appPowerMah = 3.25;
+    Parcel legacyParcel;
+    legacyParcel.WriteInt32(1);
+    legacyParcel.WriteInt32(uid);
+    legacyParcel.WriteInt32(static_cast<int32_t>(BatteryStatsInfo::CONSUMPTION_TYPE_APP));
+    legacyParcel.WriteDouble(appPowerMah);
+    std::unique_ptr<ParcelableBatteryStatsList> legacyList(ParcelableBatteryStatsList::Unmarshalling(legacyParcel));
+    ASSERT_NE(nullptr, legacyList);
+    ASSERT_EQ(1, legacyList->statsList_.size());
+    EXPECT_EQ(uid, legacyList->statsList_.front()->GetUid());
+    EXPECT_DOUBLE_EQ(appPowerMah, legacyList->statsList_.front()->GetPower());
+    STATS_HILOGI(LABEL_TEST, "BatteryStatsInfo_003 end");
+}
+
+/**
+ * @tc.name: BatteryStatsInfo_004
+ * @tc.desc: test ParcelableBatteryStatsList marshalling cost with 2000 entries
+ * @tc.type: PERF
+ */
+HWTEST_F (StatsPowerMgrTest, BatteryStatsInfo_004, TestSize.Level0)
+{
+    STATS_HILOGI(LABEL_TEST, "BatteryStatsInfo_004 start");
+    constexpr int32_t entryNum = 2000;
+    constexpr int32_t roundNum = 100;
+    constexpr int32_t baseUid = 10000;
+    ParcelableBatteryStatsList statsList;
+    for (int32_t i = 0; i < entryNum; ++i) {
+        auto statsInfo = std::make_shared<BatteryStatsInfo>();
+        statsInfo->SetUid(baseUid + i);
+        statsInfo->SetConsumptioType(BatteryStatsInfo::CONSUMPTION_TYPE_APP);
+        statsInfo->SetPower(static_cast<double>(i));
+        statsList.statsList_.push_back(statsInfo);
+    }
+    statsList.isPacked_ = true;
+
+    int64_t marshallingUs = 0;
+    int64_t unmarshallingUs = 0;
+    for (int32_t i = 0; i < roundNum; ++i) {
+        Parcel parcel;
+        auto startTime = std::chrono::steady_clock::now();
+        ASSERT_TRUE(statsList.Marshalling(parcel));
+        auto marshalledTime = std::chrono::steady_clock::now();
+        std::unique_ptr<ParcelableBatteryStatsList> result(ParcelableBatteryStatsList::Unmarshalling(parcel));
+        auto endTime = std::chrono::steady_clock::now();
+        ASSERT_NE(nullptr, result);
+        ASSERT_EQ(entryNum, result->statsList_.size());
+        marshallingUs += std::chrono::duration_cast<std::chrono::microseconds>(marshalledTime - startTime).count();
+        unmarshallingUs += std::chrono::duration_cast<std::chrono::microseconds>(endTime - marshalledTime).count();
+    }
+    STATS_HILOGI(LABEL_TEST, "Parcel %{public}d entries, marshalling: %{public}" PRId64
+        "us, unmarshalling: %{public}" PRId64 "us", entryNum, marshallingUs / roundNum, unmarshallingUs / roundNum);
+    STATS_HILOGI(LABEL_TEST, "BatteryStatsInfo_004 end");
+}
+
 /**
  * @tc.name: BatteryStatsParser_001
  * @tc.desc: test class BatteryStatsParser function
@@ -467,4 +564,133 @@ HWTEST_F (StatsPowerMgrTest, BatteryStatsRadio_001, TestSize.Level0)
     EXPECT_TRUE(actualPower >= StatsUtils::DEFAULT_VALUE && actualPercent >= StatsUtils::DEFAULT_VALUE);
     STATS_HILOGI(LABEL_TEST, "BatteryStatsRadio_001 end");
 }
+
+/**
+ * @tc.name: BatteryStatsRecords_001
+ * @tc.desc: test class BatteryStatsRecordView function
+ * @tc.type: FUNC
+ */
+HWTEST_F (StatsPowerMgrTest, BatteryStatsRecords_001, TestSize.Level0)
+{
+    STATS_HILOGI(LABEL_TEST, "BatteryStatsRecords_001 start");
+    BatteryStatsInfoList statsInfoList;
+    std::shared_ptr<BatteryStatsInfo> appInfo = std::make_shared<BatteryStatsInfo>();
+    appInfo->SetUid(10003);
+    appInfo->SetConsumptioType(BatteryStatsInfo::CONSUMPTION_TYPE_APP);
+    appInfo->SetPower(12.5);
+    statsInfoList.push_back(appInfo);
+    std::shared_ptr<BatteryStatsInfo> userInfo = std::make_shared<BatteryStatsInfo>();
+    userInfo->SetUserId(100);
+    userInfo->SetConsumptioType(BatteryStatsInfo::CONSUMPTION_TYPE_USER);
+    userInfo->SetPower(30.0);
+    statsInfoList.push_back(userInfo);
+
+    BatteryStatsRecordView recordView;
+    EXPECT_FALSE(recordView.Attach(nullptr));
+    EXPECT_EQ(0, recordView.GetSize());
+    ASSERT_TRUE(recordView.Attach(BatteryStatsRecordView::Pack(statsInfoList)));
+    ASSERT_EQ(statsInfoList.size(), recordView.GetSize());
+    EXPECT_EQ(10003, recordView[0].uid);
+    EXPECT_EQ(BatteryStatsInfo::CONSUMPTION_TYPE_APP, recordView[0].type);
+    EXPECT_EQ(12.5, recordView[0].powerMah);
+    EXPECT_EQ(100, recordView[1].userId);
+    EXPECT_EQ(BatteryStatsInfo::CONSUMPTION_TYPE_USER, recordView[1].type);
+    EXPECT_EQ(30.0, recordView[1].powerMah);
+
+    BatteryStatsRecordsHeader header = { STATS_RECORDS_MAGIC, STATS_RECORDS_VERSION,
+        static_cast<uint16_t>(sizeof(BatteryStatsRecord)), 1, 0 };
+    sptr<Ashmem> truncated = Ashmem::CreateAshmem("BatteryStatsRecordsTest", sizeof(header));
+    ASSERT_NE(truncated, nullptr);
+    ASSERT_TRUE(truncated->MapReadAndWriteAshmem());
+    ASSERT_TRUE(truncated->WriteToAshmem(&header, sizeof(header), 0));
+    EXPECT_FALSE(recordView.Attach(truncated));
+    EXPECT_EQ(0, recordView.GetSize());
+    STATS_HILOGI(LABEL_TEST, "BatteryStatsRecords_001 end");
+}
+
+/**
+ * @tc.name: BatteryStatsRecords_002
+ * @tc.desc: test class BatteryStatsClient function GetBatteryStatsRecords
+ * @tc.type: FUNC
+ */
+HWTEST_F (StatsPowerMgrTest, BatteryStatsRecords_002, TestSize.Level0)
+{
+    STATS_HILOGI(LABEL_TEST, "BatteryStatsRecords_002 start");
+    auto& statsClient = BatteryStatsClient::GetInstance();
+    statsClient.Reset();
+
+    BatteryStatsRecordView recordView = statsClient.GetBatteryStatsRecords();
+    BatteryStatsInfoList statsInfoList = statsClient.GetBatteryStats();
+    ASSERT_EQ(statsInfoList.size(), recordView.GetSize());
+    size_t index = 0;
+    for (const auto& statsInfo : statsInfoList) {
+        EXPECT_EQ(statsInfo->GetUid(), recordView[index].uid);
+        EXPECT_EQ(statsInfo->GetConsumptionType(), recordView[index].type);
+        index++;
+    }
+    STATS_HILOGI(LABEL_TEST, "BatteryStatsRecords_002 end");
+}
+
+/**
+ * @tc.name: BatteryStatsRecords_003
+ * @tc.desc: test class BatteryStatsEpochCounter publish and load
+ * @tc.type: FUNC
+ */
+HWTEST_F (StatsPowerMgrTest, BatteryStatsRecords_003, TestSize.Level0)
+{
+    STATS_HILOGI(LABEL_TEST, "BatteryStatsRecords_003 start");
+    BatteryStatsEpochCounter writer;
+    ASSERT_TRUE(writer.Create());
+    writer.Publish(1);
+
+    BatteryStatsEpochCounter reader;
+    EXPECT_EQ(0, reader.Load());
+    ASSERT_TRUE(reader.Attach(writer.GetAshmem()));
+    EXPECT_EQ(1, reader.Load());
+    writer.Publish(2);
+    EXPECT_EQ(2, reader.Load());
+    reader.Detach();
+    EXPECT_FALSE(reader.IsAttached());
+    EXPECT_EQ(0, reader.Load());
+    EXPECT_FALSE(reader.Attach(nullptr));
+    STATS_HILOGI(LABEL_TEST, "BatteryStatsRecords_003 end");
+}
+
+/**
+ * @tc.name: BatteryStatsCache_001
+ * @tc.desc: test class BatteryStatsClient function SetCacheMaxStaleMs and GetCacheInfo
+ * @tc.type: FUNC
+ */
+HWTEST_F (StatsPowerMgrTest, BatteryStatsCache_001, TestSize.Level0)
+{
+    STATS_HILOGI(LABEL_TEST, "BatteryStatsCache_001 start");
+    auto& statsClient = BatteryStatsClient::GetInstance();
+    statsClient.Reset();
+    int32_t uid = 10003;
+    int64_t maxStaleMs = 60000;
+    statsClient.SetCacheMaxStaleMs(maxStaleMs);
+
+    BatteryStatsCacheInfo initInfo = statsClient.GetCacheInfo();
+    double firstMah = statsClient.GetAppStatsMah(uid);
+    double secondMah = statsClient.GetAppStatsMah(uid);
+    EXPECT_DOUBLE_EQ(firstMah, secondMah);
+    EXPECT_EQ(StatsError::ERR_OK, statsClient.GetLastError());
+    BatteryStatsCacheInfo cacheInfo = statsClient.GetCacheInfo();
+    EXPECT_EQ(initInfo.missCount + 1, cacheInfo.missCount);
+    EXPECT_EQ(initInfo.hitCount + 1, cacheInfo.hitCount);
+
+    // Any other uncached query runs a compute pass and invalidates the entry
+    statsClient.GetPartStatsMah(BatteryStatsInfo::CONSUMPTION_TYPE_SCREEN);
+    statsClient.GetAppStatsMah(uid);
+    cacheInfo = statsClient.GetCacheInfo();
+    EXPECT_EQ(initInfo.missCount + 3, cacheInfo.missCount);
+    EXPECT_EQ(initInfo.hitCount + 1, cacheInfo.hitCount);
+
+    statsClient.SetCacheMaxStaleMs(0);
+    statsClient.GetAppStatsMah(uid);
+    cacheInfo = statsClient.GetCacheInfo();
+    EXPECT_EQ(initInfo.missCount + 3, cacheInfo.missCount);
+    EXPECT_EQ(initInfo.hitCount + 1, cacheInfo.hitCount);
+    STATS_HILOGI(LABEL_TEST, "BatteryStatsCache_001 end");
+}
 }
\ No newline at end of file
@@ -39,6 +39,7 @@
 #include <vector>
 #include <atomic>
 #include <chrono>
+#include <cinttypes>
 #include <random>
 #include <memory>
 
@@ -270,4 +271,72 @@ HWTEST_F (StatsServiceThreadTest, StatsServiceThreadTest_001, TestSize.Level0)
 
     STATS_HILOGI(LABEL_TEST, "StatsServiceThreadTest_001 end");
 }
+
+/**
+ * @tc.name: StatsServiceThreadTest_002
+ * @tc.desc: test concurrent GetAppStatsMah calls share compute passes, measure per-call latency and pass count
+ * @tc.type: FUNC
+ */
+HWTEST_F (StatsServiceThreadTest, StatsServiceThreadTest_002, TestSize.Level0)
+{
+    STATS_HILOGI(LABEL_TEST, "StatsServiceThreadTest_002 start");
+
+    g_batteryStatsService = OHOS::PowerMgr::BatteryStatsService::GetInstance();
+    ASSERT_NE(g_batteryStatsService, nullptr) << "g_batteryStatsService instance is null";
+
+    g_batteryStatsService->OnStart();
+    auto statsCore = g_batteryStatsService->GetBatteryStatsCore();
+    ASSERT_NE(statsCore, nullptr) << "statsCore instance is null";
+
+    const int32_t totalWorkers = 16;
+    const int32_t callsPerWorker = 50;
+    const int32_t totalCalls = totalWorkers * callsPerWorker;
+    const int32_t baseUid = 10000;
+    // No event arrives during the run, so within the window every call after the first pass reuses it
+    const int64_t freshnessMs = 60000;
+    std::atomic<int64_t> totalLatencyUs {0};
+    std::atomic<int64_t> maxLatencyUs {0};
+    statsCore->SetComputeFreshnessMs(freshnessMs);
+    uint64_t passCountBefore = statsCore->GetComputePassCount();
+    uint64_t reusedCountBefore = statsCore->GetComputeReusedCount();
+
+    std::vector<std::thread> workers;
+    workers.reserve(totalWorkers);
+    for (int i = 0; i < totalWorkers; ++i) {
+        workers.emplace_back([&](int32_t workerId) {
+            for (int j = 0; j < callsPerWorker; ++j) {
+                auto startTime = std::chrono::steady_clock::now();
+                g_batteryStatsService->GetAppStatsMah(baseUid + workerId);
+                int64_t latencyUs = std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - startTime).count();
+                totalLatencyUs += latencyUs;
+                int64_t lastMax = maxLatencyUs.load();
+                while (latencyUs > lastMax && !maxLatencyUs.compare_exchange_weak(lastMax, latencyUs)) {
+                    continue;
+                }
+            }
+        }, i);
+    }
+
+    for (auto& t : workers) {
+        if (t.joinable()) {
+            t.join();
+        }
+    }
+
+    uint64_t passCount = statsCore->GetComputePassCount() - passCountBefore;
+    uint64_t reusedCount = statsCore->GetComputeReusedCount() - reusedCountBefore;
+    statsCore->SetComputeFreshnessMs(0);
+    STATS_HILOGI(LABEL_TEST, "Concurrent GetAppStatsMah, calls: %{public}d, compute passes: %{public}" PRIu64
+        ", reused: %{public}" PRIu64 ", avg latency: %{public}" PRId64 "us, max latency: %{public}" PRId64 "us",
+        totalCalls, passCount, reusedCount, totalLatencyUs.load() / totalCalls, maxLatencyUs.load());
+    // Every call either runs a pass or reuses one, callers queued behind a pass must share it
+    EXPECT_EQ(passCount + reusedCount, static_cast<uint64_t>(totalCalls));
+    EXPECT_GT(reusedCount, 0);
+    EXPECT_LT(passCount, static_cast<uint64_t>(totalCalls));
+
+    g_batteryStatsService->OnStop();
+
+    STATS_HILOGI(LABEL_TEST, "StatsServiceThreadTest_002 end");
+}
 } // namespace
\ No newline at end of file
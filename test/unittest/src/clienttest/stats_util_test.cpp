@@ -14,6 +14,11 @@
  */
 
 #include "stats_util_test.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
 #include "stats_log.h"
 
 #include "battery_stats_parser.h"
@@ -357,6 +362,79 @@ HWTEST_F (StatsUtilTest, StatsHelper_006, TestSize.Level0)
     STATS_HILOGI(LABEL_TEST, "StatsHelper_006 end");
 }
 
+/**
+ * @tc.name: StatsHelper_007
+ * @tc.desc: test ComputeTimeScope pins the time of timer reads
+ * @tc.type: FUNC
+ */
+HWTEST_F (StatsUtilTest, StatsHelper_007, TestSize.Level0)
+{
+    STATS_HILOGI(LABEL_TEST, "StatsHelper_007 start");
+    StatsHelper::ActiveTimer firstTimer;
+    StatsHelper::ActiveTimer secondTimer;
+    firstTimer.StartRunning();
+    secondTimer.StartRunning();
+    usleep(TIMER_DURATION_MS * US_PER_MS);
+    {
+        StatsHelper::ComputeTimeScope timeScope;
+        int64_t pinnedTimeMs = StatsHelper::GetComputeTimeMs();
+        int64_t firstTimeMs = firstTimer.GetRunningTimeMs();
+        {
+            StatsHelper::ComputeTimeScope nestedScope;
+            EXPECT_EQ(StatsHelper::GetComputeTimeMs(), pinnedTimeMs);
+        }
+        usleep(TIMER_DURATION_MS * US_PER_MS);
+        EXPECT_EQ(StatsHelper::GetComputeTimeMs(), pinnedTimeMs);
+        EXPECT_EQ(firstTimer.GetRunningTimeMs(), firstTimeMs);
+        EXPECT_LE(abs(secondTimer.GetRunningTimeMs() - firstTimeMs), DEVIATION_TIMER_THRESHOLD);
+    }
+    int64_t devTimeMs = abs(firstTimer.GetRunningTimeMs() - TIMER_DURATION_MS * 2);
+    EXPECT_LE(devTimeMs, DEVIATION_TIMER_THRESHOLD);
+    STATS_HILOGI(LABEL_TEST, "StatsHelper_007 end");
+}
+
+/**
+ * @tc.name: StatsHelper_008
+ * @tc.desc: test ActiveTimer and Counter lose no update under concurrent writers
+ * @tc.type: FUNC
+ */
+HWTEST_F (StatsUtilTest, StatsHelper_008, TestSize.Level0)
+{
+    STATS_HILOGI(LABEL_TEST, "StatsHelper_008 start");
+    constexpr int32_t threadCount = 8;
+    constexpr int32_t loopCount = 10000;
+    constexpr int64_t stopTimeMs = 10;
+    StatsHelper::ActiveTimer addTimer;
+    StatsHelper::ActiveTimer raceTimer;
+    StatsHelper::Counter counter;
+    std::atomic<int64_t> startCount {0};
+    std::atomic<int64_t> stopCount {0};
+    std::vector<std::thread> workers;
+    for (int32_t i = 0; i < threadCount; i++) {
+        workers.emplace_back([&]() {
+            for (int32_t j = 0; j < loopCount; j++) {
+                addTimer.AddRunningTimeMs(1);
+                counter.AddCount(1);
+                if (raceTimer.StartRunning(StatsUtils::DEFAULT_VALUE)) {
+                    startCount++;
+                }
+                if (raceTimer.StopRunning(stopTimeMs)) {
+                    stopCount++;
+                }
+                addTimer.GetRunningTimeMs();
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    EXPECT_EQ(addTimer.GetRunningTimeMs(), threadCount * loopCount);
+    EXPECT_EQ(counter.GetCount(), threadCount * loopCount);
+    EXPECT_EQ(startCount.load(), stopCount.load());
+    EXPECT_EQ(raceTimer.GetRunningTimeMs(), stopCount.load() * stopTimeMs);
+    STATS_HILOGI(LABEL_TEST, "StatsHelper_008 end");
+}
+
 /**
  * @tc.name: StatsParserTest_001
  * @tc.desc: test Init
@@ -410,4 +410,147 @@ HWTEST_F (StatsServiceAudioTest, StatsServiceAudioTest_008, TestSize.Level0)
     EXPECT_EQ(expectedPower, actualPower);
     STATS_HILOGI(LABEL_TEST, "StatsServiceAudioTest_008 end");
 }
+
+/**
+ * @tc.name: StatsServiceAudioTest_009
+ * @tc.desc: test GetAppStatsBatch function(Audio)
+ * @tc.type: FUNC
+ */
+HWTEST_F (StatsServiceAudioTest, StatsServiceAudioTest_009, TestSize.Level0)
+{
+    STATS_HILOGI(LABEL_TEST, "StatsServiceAudioTest_009 start");
+    ASSERT_NE(g_statsServiceProxy, nullptr);
+    auto statsService = BatteryStatsService::GetInstance();
+    g_statsServiceProxy->ResetIpc();
+
+    std::vector<int32_t> uids = {10003, 10004};
+    int32_t pid = 3458;
+    int32_t stateRunning = 2;
+    int32_t stateStopped = 3;
+    for (auto uid : uids) {
+        StatsWriteHiSysEvent(statsService,
+            HiSysEvent::Domain::AUDIO, StatsHiSysEvent::STREAM_CHANGE, HiSysEvent::EventType::BEHAVIOR, "PID", pid,
+            "UID", uid, "STATE", stateRunning);
+    }
+    usleep(SERVICE_POWER_CONSUMPTION_DURATION_US);
+    for (auto uid : uids) {
+        StatsWriteHiSysEvent(statsService,
+            HiSysEvent::Domain::AUDIO, StatsHiSysEvent::STREAM_CHANGE, HiSysEvent::EventType::BEHAVIOR, "PID", pid,
+            "UID", uid, "STATE", stateStopped);
+    }
+
+    int32_t tempError;
+    std::vector<double> appStatsMah;
+    std::vector<double> appStatsPercent;
+    ParcelableBatteryStatsList breakdown;
+    g_statsServiceProxy->GetAppStatsBatchIpc(uids, APP_STATS_FIELD_ALL, appStatsMah, appStatsPercent, breakdown,
+        tempError);
+    EXPECT_EQ(tempError, static_cast<int32_t>(StatsError::ERR_OK));
+    ASSERT_EQ(appStatsMah.size(), uids.size());
+    ASSERT_EQ(appStatsPercent.size(), uids.size());
+    for (size_t i = 0; i < uids.size(); i++) {
+        double powerMah;
+        g_statsServiceProxy->GetAppStatsMahIpc(uids[i], powerMah, tempError);
+        EXPECT_EQ(appStatsMah[i], powerMah);
+        EXPECT_GT(appStatsPercent[i], StatsUtils::DEFAULT_VALUE);
+    }
+    size_t audioCount = 0;
+    for (const auto& item : breakdown.statsList_) {
+        if (item->GetConsumptionType() == BatteryStatsInfo::CONSUMPTION_TYPE_AUDIO) {
+            audioCount++;
+        }
+    }
+    EXPECT_EQ(audioCount, uids.size());
+
+    appStatsMah.clear();
+    appStatsPercent.clear();
+    g_statsServiceProxy->GetAppStatsBatchIpc(uids, 0, appStatsMah, appStatsPercent, breakdown, tempError);
+    EXPECT_EQ(tempError, static_cast<int32_t>(StatsError::ERR_PARAM_INVALID));
+    EXPECT_TRUE(appStatsMah.empty());
+    STATS_HILOGI(LABEL_TEST, "StatsServiceAudioTest_009 end");
+}
+
+/**
+ * @tc.name: StatsServiceAudioTest_010
+ * @tc.desc: test GetTopConsumers function(Audio)
+ * @tc.type: FUNC
+ */
+HWTEST_F (StatsServiceAudioTest, StatsServiceAudioTest_010, TestSize.Level0)
+{
+    STATS_HILOGI(LABEL_TEST, "StatsServiceAudioTest_010 start");
+    ASSERT_NE(g_statsServiceProxy, nullptr);
+    auto statsService = BatteryStatsService::GetInstance();
+    g_statsServiceProxy->ResetIpc();
+
+    int32_t uid = 10003;
+    int32_t pid = 3458;
+    int32_t stateRunning = 2;
+    int32_t stateStopped = 3;
+    StatsWriteHiSysEvent(statsService,
+        HiSysEvent::Domain::AUDIO, StatsHiSysEvent::STREAM_CHANGE, HiSysEvent::EventType::BEHAVIOR, "PID", pid,
+        "UID", uid, "STATE", stateRunning);
+    usleep(SERVICE_POWER_CONSUMPTION_DURATION_US);
+    StatsWriteHiSysEvent(statsService,
+        HiSysEvent::Domain::AUDIO, StatsHiSysEvent::STREAM_CHANGE, HiSysEvent::EventType::BEHAVIOR, "PID", pid,
+        "UID", uid, "STATE", stateStopped);
+
+    int32_t tempError;
+    uint64_t epoch = 0;
+    ParcelableBatteryStatsList topConsumers;
+    g_statsServiceProxy->GetTopConsumersIpc(1, BatteryStatsInfo::CONSUMPTION_TYPE_APP, 0, topConsumers, epoch,
+        tempError);
+    EXPECT_EQ(tempError, static_cast<int32_t>(StatsError::ERR_OK));
+    ASSERT_EQ(topConsumers.statsList_.size(), 1);
+    EXPECT_EQ(topConsumers.statsList_.front()->GetUid(), uid);
+    EXPECT_GT(epoch, 0);
+
+    // Passing the epoch back reads the same snapshot
+    uint64_t nextEpoch = 0;
+    g_statsServiceProxy->GetTopConsumersIpc(1, BatteryStatsInfo::CONSUMPTION_TYPE_APP, epoch, topConsumers,
+        nextEpoch, tempError);
+    EXPECT_EQ(nextEpoch, epoch);
+
+    g_statsServiceProxy->GetTopConsumersIpc(0, BatteryStatsInfo::CONSUMPTION_TYPE_APP, 0, topConsumers, nextEpoch,
+        tempError);
+    EXPECT_EQ(tempError, static_cast<int32_t>(StatsError::ERR_PARAM_INVALID));
+    EXPECT_TRUE(topConsumers.statsList_.empty());
+    STATS_HILOGI(LABEL_TEST, "StatsServiceAudioTest_010 end");
+}
+
+/**
+ * @tc.name: StatsServiceAudioTest_011
+ * @tc.desc: test GetAppStatsBatch function rejects empty and oversized queries(Audio)
+ * @tc.type: FUNC
+ */
+HWTEST_F (StatsServiceAudioTest, StatsServiceAudioTest_011, TestSize.Level0)
+{
+    STATS_HILOGI(LABEL_TEST, "StatsServiceAudioTest_011 start");
+    ASSERT_NE(g_statsServiceProxy, nullptr);
+    g_statsServiceProxy->ResetIpc();
+
+    int32_t tempError;
+    std::vector<double> appStatsMah;
+    std::vector<double> appStatsPercent;
+    ParcelableBatteryStatsList breakdown;
+    std::vector<int32_t> uids;
+    g_statsServiceProxy->GetAppStatsBatchIpc(uids, APP_STATS_FIELD_ALL, appStatsMah, appStatsPercent, breakdown,
+        tempError);
+    EXPECT_EQ(tempError, static_cast<int32_t>(StatsError::ERR_PARAM_INVALID));
+
+    int32_t firstUid = 10000;
+    for (size_t i = 0; i <= BatteryStatsService::APP_STATS_BATCH_MAX_BREAKDOWN_UIDS; i++) {
+        uids.push_back(firstUid + static_cast<int32_t>(i));
+    }
+    g_statsServiceProxy->GetAppStatsBatchIpc(uids, APP_STATS_FIELD_ALL, appStatsMah, appStatsPercent, breakdown,
+        tempError);
+    EXPECT_EQ(tempError, static_cast<int32_t>(StatsError::ERR_PARAM_INVALID));
+    EXPECT_TRUE(appStatsMah.empty());
+
+    // Without the breakdown the same uids fit in the reply
+    g_statsServiceProxy->GetAppStatsBatchIpc(uids, APP_STATS_FIELD_MAH, appStatsMah, appStatsPercent, breakdown,
+        tempError);
+    EXPECT_EQ(tempError, static_cast<int32_t>(StatsError::ERR_OK));
+    EXPECT_EQ(appStatsMah.size(), uids.size());
+    STATS_HILOGI(LABEL_TEST, "StatsServiceAudioTest_011 end");
+}
 }
\ No newline at end of file
@@ -14,10 +14,25 @@
  */
 
 #include "stats_service_core_test.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <vector>
+
+#include "stats_helper.h"
 #include "stats_log.h"
 
+#include "battery_stats_bundle_cache.h"
+#include "battery_stats_callback_stub.h"
 #include "battery_stats_core.h"
+#include "battery_stats_dumper.h"
+#include "battery_stats_info_pool.h"
 #include "battery_stats_service.h"
+#include "battery_stats_uid_slab.h"
+#include "battery_stats_user_resolver.h"
+#include "entities/camera_entity.h"
+#include "entities/uid_entity.h"
 
 using namespace OHOS;
 using namespace OHOS::PowerMgr;
@@ -26,6 +41,33 @@ using namespace testing::ext;
 
 namespace {
 static sptr<BatteryStatsService> g_statsService = nullptr;
+
+class StatsChangedCallback : public BatteryStatsCallbackStub {
+public:
+    ErrCode OnStatsChanged(const ParcelableBatteryStatsList& changed, uint64_t epoch) override
+    {
+        changedNum_ = changed.statsList_.size();
+        lastEpoch_ = epoch;
+        notifyCount_++;
+        return ERR_OK;
+    }
+    std::atomic_uint32_t notifyCount_ {0};
+    std::atomic_size_t changedNum_ {0};
+    std::atomic_uint64_t lastEpoch_ {0};
+};
+
+bool WaitForNotify(const sptr<StatsChangedCallback>& callback, uint32_t count)
+{
+    constexpr int32_t WAIT_TIMES = 50;
+    constexpr useconds_t WAIT_INTERVAL_US = 20000;
+    for (int32_t i = 0; i < WAIT_TIMES; i++) {
+        if (callback->notifyCount_ >= count) {
+            return true;
+        }
+        usleep(WAIT_INTERVAL_US);
+    }
+    return callback->notifyCount_ >= count;
+}
 } // namespace
 
 void StatsServiceCoreTest::SetUpTestCase()
@@ -307,4 +349,826 @@ HWTEST_F (StatsServiceCoreTest, StatsServiceCoreTest_007, TestSize.Level0)
     EXPECT_EQ(StatsUtils::DEFAULT_VALUE, uidEntity->GetStatsPowerMah(StatsUtils::STATS_TYPE_INVALID));
     STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_007 end");
 }
-}
\ No newline at end of file
+/**
+ * @tc.name: StatsServiceCoreTest_008
+ * @tc.desc: test debug event ring overwrites the oldest record when full
+ * @tc.type: FUNC
+ */
+HWTEST_F (StatsServiceCoreTest, StatsServiceCoreTest_008, TestSize.Level0)
+{
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_008 start");
+    size_t capacity = 2;
+    BatteryStatsDebugRing debugRing(capacity);
+    EXPECT_EQ(capacity, debugRing.GetCapacity());
+
+    StatsUtils::StatsData data;
+    data.type = StatsUtils::STATS_TYPE_BATTERY;
+    int32_t batteryLevels[] = { 10, 20, 30 };
+    for (auto level : batteryLevels) {
+        data.level = level;
+        debugRing.Push(data, StatsUtils::DEFAULT_VALUE);
+    }
+    EXPECT_EQ(capacity, debugRing.GetSize());
+    EXPECT_EQ(1, debugRing.GetOverwrittenCount());
+
+    std::string result;
+    debugRing.Dump(result);
+    EXPECT_TRUE(result.find("Battery level = 10,") == std::string::npos);
+    EXPECT_TRUE(result.find("Battery level = 20,") != std::string::npos);
+    EXPECT_TRUE(result.find("Battery level = 30,") != std::string::npos);
+    EXPECT_TRUE(result.find("overwritten: 1") != std::string::npos);
+
+    debugRing.Clear();
+    EXPECT_EQ(0, debugRing.GetSize());
+    EXPECT_EQ(0, debugRing.GetOverwrittenCount());
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_008 end");
+}
+/**
+ * @tc.name: StatsServiceCoreTest_009
+ * @tc.desc: test event coalescer suppresses redundant state transitions
+ * @tc.type: FUNC
+ */
+HWTEST_F (StatsServiceCoreTest, StatsServiceCoreTest_009, TestSize.Level0)
+{
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_009 start");
+    BatteryStatsCoalescer coalescer;
+    StatsUtils::StatsData audioData;
+    audioData.type = StatsUtils::STATS_TYPE_AUDIO_ON;
+    audioData.uid = 10003;
+    audioData.state = StatsUtils::STATS_STATE_ACTIVATED;
+    EXPECT_FALSE(coalescer.Coalesce(audioData));
+    EXPECT_TRUE(coalescer.Coalesce(audioData));
+    audioData.state = StatsUtils::STATS_STATE_DEACTIVATED;
+    EXPECT_FALSE(coalescer.Coalesce(audioData));
+
+    StatsUtils::StatsData brightnessData;
+    brightnessData.type = StatsUtils::STATS_TYPE_SCREEN_BRIGHTNESS;
+    brightnessData.level = 100;
+    EXPECT_FALSE(coalescer.Coalesce(brightnessData));
+    EXPECT_TRUE(coalescer.Coalesce(brightnessData));
+    StatsUtils::StatsData screenData;
+    screenData.type = StatsUtils::STATS_TYPE_SCREEN_ON;
+    screenData.state = StatsUtils::STATS_STATE_ACTIVATED;
+    EXPECT_FALSE(coalescer.Coalesce(screenData));
+    EXPECT_FALSE(coalescer.Coalesce(brightnessData));
+    EXPECT_EQ(2, coalescer.GetSuppressedCount());
+
+    StatsUtils::StatsData cameraData;
+    cameraData.type = StatsUtils::STATS_TYPE_CAMERA_ON;
+    cameraData.state = StatsUtils::STATS_STATE_ACTIVATED;
+    EXPECT_FALSE(coalescer.Coalesce(cameraData));
+    EXPECT_FALSE(coalescer.Coalesce(cameraData));
+
+    coalescer.Reset();
+    EXPECT_EQ(0, coalescer.GetSuppressedCount());
+    EXPECT_FALSE(coalescer.Coalesce(brightnessData));
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_009 end");
+}
+/**
+ * @tc.name: StatsServiceCoreTest_010
+ * @tc.desc: test BatteryStatsCore function ApplyBatch shares one timestamp per batch
+ * @tc.type: FUNC
+ */
+HWTEST_F (StatsServiceCoreTest, StatsServiceCoreTest_010, TestSize.Level0)
+{
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_010 start");
+    auto statsService = BatteryStatsService::GetInstance();
+    auto statsCore = statsService->GetBatteryStatsCore();
+    int32_t uidOne = 10004;
+    int32_t uidTwo = 10005;
+
+    std::vector<StatsUtils::StatsData> events(2);
+    events[0].type = StatsUtils::STATS_TYPE_AUDIO_ON;
+    events[0].uid = uidTwo;
+    events[0].state = StatsUtils::STATS_STATE_ACTIVATED;
+    events[1].type = StatsUtils::STATS_TYPE_AUDIO_ON;
+    events[1].uid = uidOne;
+    events[1].state = StatsUtils::STATS_STATE_ACTIVATED;
+    statsCore->ApplyBatch(events);
+    usleep(SERVICE_POWER_CONSUMPTION_DURATION_US);
+    events[0].state = StatsUtils::STATS_STATE_DEACTIVATED;
+    events[1].state = StatsUtils::STATS_STATE_DEACTIVATED;
+    statsCore->ApplyBatch(events);
+
+    EXPECT_EQ(statsCore->GetTotalTimeMs(uidOne, StatsUtils::STATS_TYPE_AUDIO_ON),
+        statsCore->GetTotalTimeMs(uidTwo, StatsUtils::STATS_TYPE_AUDIO_ON));
+    auto uids = statsCore->GetEntity(BatteryStatsInfo::CONSUMPTION_TYPE_APP)->GetUids();
+    EXPECT_TRUE(std::find(uids.begin(), uids.end(), uidOne) != uids.end());
+    EXPECT_TRUE(std::find(uids.begin(), uids.end(), uidTwo) != uids.end());
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_010 end");
+}
+
+/**
+ * @tc.name: StatsServiceCoreTest_011
+ * @tc.desc: test BatteryStatsCore function GetTopConsumers ranks from the compute pass
+ * @tc.type: FUNC
+ */
+HWTEST_F (StatsServiceCoreTest, StatsServiceCoreTest_011, TestSize.Level0)
+{
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_011 start");
+    auto statsService = BatteryStatsService::GetInstance();
+    auto statsCore = statsService->GetBatteryStatsCore();
+    int32_t uidOne = 10004;
+    int32_t uidTwo = 10005;
+
+    statsCore->UpdateStats(StatsUtils::STATS_TYPE_AUDIO_ON, StatsUtils::STATS_STATE_ACTIVATED,
+        StatsUtils::INVALID_VALUE, uidOne);
+    statsCore->UpdateStats(StatsUtils::STATS_TYPE_AUDIO_ON, StatsUtils::STATS_STATE_ACTIVATED,
+        StatsUtils::INVALID_VALUE, uidTwo);
+    usleep(SERVICE_POWER_CONSUMPTION_DURATION_US);
+    statsCore->UpdateStats(StatsUtils::STATS_TYPE_AUDIO_ON, StatsUtils::STATS_STATE_DEACTIVATED,
+        StatsUtils::INVALID_VALUE, uidTwo);
+    usleep(SERVICE_POWER_CONSUMPTION_DURATION_US);
+    statsCore->UpdateStats(StatsUtils::STATS_TYPE_AUDIO_ON, StatsUtils::STATS_STATE_DEACTIVATED,
+        StatsUtils::INVALID_VALUE, uidOne);
+
+    uint64_t epoch = statsCore->GetComputeEpoch();
+    statsCore->ComputePower();
+    EXPECT_EQ(epoch + 1, statsCore->GetComputeEpoch());
+    auto topApps = statsCore->GetTopConsumers(2, BatteryStatsInfo::CONSUMPTION_TYPE_APP);
+    ASSERT_EQ(2, topApps.size());
+    EXPECT_EQ(uidOne, topApps.front()->GetUid());
+    EXPECT_EQ(uidTwo, topApps.back()->GetUid());
+    EXPECT_GT(topApps.front()->GetPower(), topApps.back()->GetPower());
+
+    auto topAll = statsCore->GetTopConsumers(BatteryStatsCore::RANK_INDEX_SORTED_NUM,
+        BatteryStatsInfo::CONSUMPTION_TYPE_INVALID);
+    auto isUser = [](const std::shared_ptr<BatteryStatsInfo>& info) {
+        return info->GetConsumptionType() == BatteryStatsInfo::CONSUMPTION_TYPE_USER;
+    };
+    auto statsList = statsCore->GetBatteryStats();
+    size_t userNum = static_cast<size_t>(std::count_if(statsList.begin(), statsList.end(), isUser));
+    // User rows sum their apps, they are only ranked when asked for by type
+    EXPECT_EQ(statsList.size() - userNum, topAll.size());
+    EXPECT_TRUE(std::none_of(topAll.begin(), topAll.end(), isUser));
+    EXPECT_EQ(userNum, statsCore->GetTopConsumers(BatteryStatsCore::RANK_INDEX_SORTED_NUM,
+        BatteryStatsInfo::CONSUMPTION_TYPE_USER).size());
+    EXPECT_TRUE(std::is_sorted(topAll.begin(), topAll.end(),
+        [](const std::shared_ptr<BatteryStatsInfo>& lhs, const std::shared_ptr<BatteryStatsInfo>& rhs) {
+            return lhs->GetPower() > rhs->GetPower();
+        }));
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_011 end");
+}
+
+/**
+ * @tc.name: StatsServiceCoreTest_012
+ * @tc.desc: test BatteryStatsCore function GetBatteryStatsSince
+ * @tc.type: FUNC
+ */
+HWTEST_F (StatsServiceCoreTest, StatsServiceCoreTest_012, TestSize.Level0)
+{
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_012 start");
+    auto statsService = BatteryStatsService::GetInstance();
+    auto statsCore = statsService->GetBatteryStatsCore();
+    int32_t uid = 10004;
+    auto findUid = [uid](const BatteryStatsInfoList& statsInfoList) {
+        return std::find_if(statsInfoList.begin(), statsInfoList.end(),
+            [uid](const std::shared_ptr<BatteryStatsInfo>& info) { return info->GetUid() == uid; }) !=
+            statsInfoList.end();
+    };
+
+    statsCore->ComputePower();
+    auto fullDelta = statsCore->GetBatteryStatsSince(0);
+    EXPECT_TRUE(fullDelta.isFull);
+    EXPECT_EQ(statsCore->GetBatteryStats().size(), fullDelta.changed.size());
+
+    statsCore->UpdateStats(StatsUtils::STATS_TYPE_AUDIO_ON, StatsUtils::STATS_STATE_ACTIVATED,
+        StatsUtils::INVALID_VALUE, uid);
+    usleep(SERVICE_POWER_CONSUMPTION_DURATION_US);
+    statsCore->UpdateStats(StatsUtils::STATS_TYPE_AUDIO_ON, StatsUtils::STATS_STATE_DEACTIVATED,
+        StatsUtils::INVALID_VALUE, uid);
+    statsCore->ComputePower();
+    auto delta = statsCore->GetBatteryStatsSince(fullDelta.epoch);
+    EXPECT_FALSE(delta.isFull);
+    EXPECT_GT(delta.epoch, fullDelta.epoch);
+    EXPECT_TRUE(findUid(delta.changed));
+
+    statsCore->ComputePower();
+    auto steadyDelta = statsCore->GetBatteryStatsSince(statsCore->GetComputeEpoch() - 1);
+    EXPECT_FALSE(findUid(steadyDelta.changed));
+    EXPECT_TRUE(steadyDelta.removed.empty());
+
+    statsCore->Reset();
+    auto resetDelta = statsCore->GetBatteryStatsSince(delta.epoch);
+    EXPECT_TRUE(findUid(resetDelta.removed));
+    EXPECT_TRUE(statsCore->GetBatteryStatsSince(resetDelta.epoch + 1).isFull);
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_012 end");
+}
+
+/**
+ * @tc.name: StatsServiceCoreTest_013
+ * @tc.desc: test BatteryStatsService function SubscribeStatsIpc and UnsubscribeStatsIpc
+ * @tc.type: FUNC
+ */
+HWTEST_F (StatsServiceCoreTest, StatsServiceCoreTest_013, TestSize.Level0)
+{
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_013 start");
+    auto statsService = BatteryStatsService::GetInstance();
+    auto statsCore = statsService->GetBatteryStatsCore();
+    int32_t uid = 10005;
+    int32_t tempError = StatsUtils::INVALID_VALUE;
+    sptr<StatsChangedCallback> callback = new StatsChangedCallback();
+
+    statsService->SubscribeStatsIpc(callback, { uid }, {}, 0.0, 0.0, 0, tempError);
+    EXPECT_EQ(static_cast<int32_t>(StatsError::ERR_OK), tempError);
+    EXPECT_TRUE(statsService->GetBatteryStatsNotifier()->HasSubscription());
+
+    statsCore->UpdateStats(StatsUtils::STATS_TYPE_AUDIO_ON, StatsUtils::STATS_STATE_ACTIVATED,
+        StatsUtils::INVALID_VALUE, uid);
+    usleep(SERVICE_POWER_CONSUMPTION_DURATION_US);
+    statsCore->UpdateStats(StatsUtils::STATS_TYPE_AUDIO_ON, StatsUtils::STATS_STATE_DEACTIVATED,
+        StatsUtils::INVALID_VALUE, uid);
+    statsCore->ComputePower();
+    EXPECT_TRUE(WaitForNotify(callback, 1));
+    EXPECT_GT(callback->changedNum_.load(), 0);
+    EXPECT_EQ(statsCore->GetComputeEpoch(), callback->lastEpoch_.load());
+
+    // Nothing changed and the interval has not passed, so no second push
+    statsCore->ComputePower();
+    EXPECT_FALSE(WaitForNotify(callback, 2));
+
+    statsService->UnsubscribeStatsIpc(callback, tempError);
+    EXPECT_EQ(static_cast<int32_t>(StatsError::ERR_OK), tempError);
+    EXPECT_FALSE(statsService->GetBatteryStatsNotifier()->HasSubscription());
+    statsService->UnsubscribeStatsIpc(callback, tempError);
+    EXPECT_EQ(static_cast<int32_t>(StatsError::ERR_PARAM_INVALID), tempError);
+
+    statsService->SubscribeStatsIpc(callback, {}, {}, -1.0, 0.0, 0, tempError);
+    EXPECT_EQ(static_cast<int32_t>(StatsError::ERR_PARAM_INVALID), tempError);
+    statsService->SubscribeStatsIpc(nullptr, {}, {}, 0.0, 0.0, 0, tempError);
+    EXPECT_EQ(static_cast<int32_t>(StatsError::ERR_PARAM_INVALID), tempError);
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_013 end");
+}
+
+/**
+ * @tc.name: StatsServiceCoreTest_014
+ * @tc.desc: test BatteryStatsCore function ComputePowerShared
+ * @tc.type: FUNC
+ */
+HWTEST_F (StatsServiceCoreTest, StatsServiceCoreTest_014, TestSize.Level0)
+{
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_014 start");
+    auto statsService = BatteryStatsService::GetInstance();
+    auto statsCore = statsService->GetBatteryStatsCore();
+    int32_t uid = 10006;
+    int64_t freshnessMs = 60000;
+
+    uint64_t ticket = statsCore->GetComputeTicket();
+    statsCore->ComputePower();
+    uint64_t passCount = statsCore->GetComputePassCount();
+    statsCore->ComputePowerShared(ticket);
+    EXPECT_EQ(passCount, statsCore->GetComputePassCount());
+    statsCore->ComputePowerShared(statsCore->GetComputeTicket());
+    EXPECT_EQ(passCount + 1, statsCore->GetComputePassCount());
+
+    statsCore->SetComputeFreshnessMs(freshnessMs);
+    statsCore->ComputePowerShared(statsCore->GetComputeTicket());
+    EXPECT_EQ(passCount + 1, statsCore->GetComputePassCount());
+    statsCore->UpdateStats(StatsUtils::STATS_TYPE_AUDIO_ON, StatsUtils::STATS_STATE_ACTIVATED,
+        StatsUtils::INVALID_VALUE, uid);
+    statsCore->ComputePowerShared(statsCore->GetComputeTicket());
+    EXPECT_EQ(passCount + 2, statsCore->GetComputePassCount());
+    statsCore->UpdateStats(StatsUtils::STATS_TYPE_AUDIO_ON, StatsUtils::STATS_STATE_DEACTIVATED,
+        StatsUtils::INVALID_VALUE, uid);
+    statsCore->SetComputeFreshnessMs(0);
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_014 end");
+}
+
+/**
+ * @tc.name: StatsServiceCoreTest_015
+ * @tc.desc: test BatteryStatsDumper filters and streaming dump to fd
+ * @tc.type: FUNC
+ */
+HWTEST_F (StatsServiceCoreTest, StatsServiceCoreTest_015, TestSize.Level0)
+{
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_015 start");
+    BatteryStatsDumper::DumpFilter filter;
+    EXPECT_TRUE(BatteryStatsDumper::ParseFilter({"-batterystats"}, filter));
+    EXPECT_EQ(filter.sectionMask, static_cast<uint32_t>(BatteryStatsDumper::SECTION_ALL));
+    filter = {};
+    EXPECT_TRUE(BatteryStatsDumper::ParseFilter({"-batterystats", "-uid", "10007"}, filter));
+    EXPECT_EQ(filter.uid, 10007);
+    EXPECT_EQ(filter.sectionMask, static_cast<uint32_t>(BatteryStatsDumper::SECTION_APP));
+    filter = {};
+    EXPECT_TRUE(BatteryStatsDumper::ParseFilter({"-batterystats", "-section", "screen,history", "-top", "3"},
+        filter));
+    EXPECT_EQ(filter.sectionMask,
+        static_cast<uint32_t>(BatteryStatsDumper::SECTION_SCREEN | BatteryStatsDumper::SECTION_HISTORY));
+    EXPECT_EQ(filter.topNum, 3);
+    filter = {};
+    EXPECT_FALSE(BatteryStatsDumper::ParseFilter({"-batterystats", "-section", "unknown"}, filter));
+    EXPECT_FALSE(BatteryStatsDumper::ParseFilter({"-batterystats", "-uid"}, filter));
+    EXPECT_FALSE(BatteryStatsDumper::ParseFilter({"-batterystats", "-top", "abc"}, filter));
+
+    FILE* file = tmpfile();
+    ASSERT_NE(file, nullptr);
+    int32_t fd = fileno(file);
+    EXPECT_TRUE(BatteryStatsDumper::Dump({"-batterystats", "-uid", "10007"}, fd));
+    fflush(file);
+    rewind(file);
+    std::string streamed;
+    char buffer[256];
+    size_t readSize = 0;
+    while ((readSize = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        streamed.append(buffer, readSize);
+    }
+    fclose(file);
+    std::string result;
+    EXPECT_TRUE(BatteryStatsDumper::Dump({"-batterystats", "-uid", "10007"}, result));
+    EXPECT_EQ(streamed, result);
+    EXPECT_NE(result.find("10007(Bundle name: "), string::npos);
+    EXPECT_EQ(result.find("Event coalescer dump"), string::npos);
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_015 end");
+}
+
+/**
+ * @tc.name: StatsServiceCoreTest_016
+ * @tc.desc: test BatteryStatsBundleCache hit, miss, unresolved uids and invalidation
+ * @tc.type: FUNC
+ */
+HWTEST_F (StatsServiceCoreTest, StatsServiceCoreTest_016, TestSize.Level0)
+{
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_016 start");
+    BatteryStatsBundleCache bundleCache;
+    // Far above the uid of any installed app, so the bundle manager never resolves it
+    int32_t unknownUid = 2000000000;
+    int32_t uid = 10008;
+    std::string bundleName = "com.example.stats";
+
+    bundleCache.Prefetch({unknownUid});
+    EXPECT_EQ(bundleCache.GetMissCount(), 1);
+    // Seeded as well, so the test does not depend on the bundle manager answering
+    bundleCache.unresolvedMap_[unknownUid] = StatsHelper::GetBootTimeMs();
+    EXPECT_EQ(bundleCache.PeekBundleName(unknownUid), "NULL");
+    EXPECT_EQ(bundleCache.GetBundleName(unknownUid), "NULL");
+    bundleCache.Prefetch({unknownUid});
+    EXPECT_EQ(bundleCache.GetMissCount(), 1);
+    EXPECT_EQ(bundleCache.GetHitCount(), 1);
+    // An unresolved uid is looked up again once its entry expired
+    bundleCache.unresolvedMap_[unknownUid] =
+        StatsHelper::GetBootTimeMs() - BatteryStatsBundleCache::UNRESOLVED_TTL_MS;
+    bundleCache.Prefetch({unknownUid});
+    EXPECT_EQ(bundleCache.GetMissCount(), 2);
+
+    bundleCache.bundleNameMap_[uid] = bundleName;
+    bundleCache.Prefetch({uid});
+    EXPECT_EQ(bundleCache.GetMissCount(), 2);
+    EXPECT_EQ(bundleCache.GetBundleName(uid), bundleName);
+    EXPECT_EQ(bundleCache.PeekBundleName(uid), bundleName);
+    EXPECT_EQ(bundleCache.GetHitCount(), 3);
+
+    bundleCache.Invalidate(uid);
+    EXPECT_EQ(bundleCache.PeekBundleName(uid), "NULL");
+    bundleCache.unresolvedMap_[uid] = StatsHelper::GetBootTimeMs();
+    bundleCache.Invalidate(uid);
+    EXPECT_EQ(bundleCache.unresolvedMap_.count(uid), 0);
+    bundleCache.bundleNameMap_[uid] = bundleName;
+    bundleCache.Clear();
+    EXPECT_EQ(bundleCache.PeekBundleName(uid), "NULL");
+    std::string result;
+    bundleCache.DumpInfo(result);
+    EXPECT_NE(result.find("Cached uids: 0, hits: 3, misses: 2, unresolved uids: 0"), string::npos);
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_016 end");
+}
+
+/**
+ * @tc.name: StatsServiceCoreTest_017
+ * @tc.desc: test BatteryStatsUserResolver maps uids to users without account lookups on the standard layout
+ * @tc.type: FUNC
+ */
+HWTEST_F (StatsServiceCoreTest, StatsServiceCoreTest_017, TestSize.Level0)
+{
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_017 start");
+    BatteryStatsUserResolver userResolver;
+    int32_t userId = 100;
+    int32_t appUid = 10010;
+    EXPECT_EQ(userResolver.GetUserId(appUid), 0);
+    EXPECT_EQ(userResolver.GetUserId(userId * BatteryStatsUserResolver::UID_RANGE_PER_USER + appUid), userId);
+    EXPECT_EQ(userResolver.GetCachedNum(), 0);
+
+    userResolver.GetUserId(StatsUtils::INVALID_VALUE - 1);
+    EXPECT_EQ(userResolver.GetCachedNum(), 1);
+    userResolver.Refresh();
+    EXPECT_EQ(userResolver.GetCachedNum(), 0);
+
+    auto statsCore = BatteryStatsService::GetInstance()->GetBatteryStatsCore();
+    EXPECT_EQ(statsCore->GetUserId(userId * BatteryStatsUserResolver::UID_RANGE_PER_USER + appUid), userId);
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_017 end");
+}
+
+/**
+ * @tc.name: StatsServiceCoreTest_018
+ * @tc.desc: test removed and long idle uids are compacted while their power stays in the total
+ * @tc.type: FUNC
+ */
+HWTEST_F (StatsServiceCoreTest, StatsServiceCoreTest_018, TestSize.Level0)
+{
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_018 start");
+    auto statsCore = BatteryStatsService::GetInstance()->GetBatteryStatsCore();
+    auto uidEntity = statsCore->GetEntity(BatteryStatsInfo::CONSUMPTION_TYPE_APP);
+    int32_t uid = 10011;
+    int32_t idleUid = 10012;
+    int32_t activeUid = 10015;
+    auto appEntity = std::static_pointer_cast<UidEntity>(uidEntity);
+    auto hasUid = [&uidEntity](int32_t target) {
+        auto uids = uidEntity->GetUids();
+        return std::find(uids.begin(), uids.end(), target) != uids.end();
+    };
+
+    statsCore->UpdateStats(StatsUtils::STATS_TYPE_AUDIO_ON, StatsUtils::STATS_STATE_ACTIVATED,
+        StatsUtils::INVALID_VALUE, uid);
+    usleep(SERVICE_POWER_CONSUMPTION_DURATION_US);
+    statsCore->UpdateStats(StatsUtils::STATS_TYPE_AUDIO_ON, StatsUtils::STATS_STATE_DEACTIVATED,
+        StatsUtils::INVALID_VALUE, uid);
+    statsCore->ComputePower();
+    EXPECT_GT(statsCore->GetAppStatsMah(uid), StatsUtils::DEFAULT_VALUE);
+    double totalPower = BatteryStatsEntity::GetTotalPowerMah();
+
+    statsCore->RemoveUid(uid);
+    statsCore->ComputePower();
+    EXPECT_FALSE(hasUid(uid));
+    EXPECT_EQ(statsCore->GetAppStatsMah(uid), StatsUtils::DEFAULT_VALUE);
+    EXPECT_EQ(statsCore->GetTotalTimeMs(uid, StatsUtils::STATS_TYPE_AUDIO_ON), StatsUtils::DEFAULT_VALUE);
+    EXPECT_GE(BatteryStatsEntity::GetTotalPowerMah(), totalPower);
+
+    appEntity->idleCompactMs_ = SERVICE_POWER_CONSUMPTION_DURATION_US / US_PER_MS / 2;
+    uidEntity->UpdateUidMap(idleUid);
+    statsCore->UpdateStats(StatsUtils::STATS_TYPE_AUDIO_ON, StatsUtils::STATS_STATE_ACTIVATED,
+        StatsUtils::INVALID_VALUE, activeUid);
+    statsCore->ComputePower();
+    EXPECT_TRUE(hasUid(idleUid));
+    usleep(SERVICE_POWER_CONSUMPTION_DURATION_US);
+    statsCore->ComputePower();
+    EXPECT_FALSE(hasUid(idleUid));
+    EXPECT_TRUE(hasUid(activeUid));
+    statsCore->UpdateStats(StatsUtils::STATS_TYPE_AUDIO_ON, StatsUtils::STATS_STATE_DEACTIVATED,
+        StatsUtils::INVALID_VALUE, activeUid);
+    appEntity->idleCompactMs_ = UidEntity::IDLE_COMPACT_MS;
+
+    std::string result;
+    statsCore->DumpHistory(result);
+    EXPECT_NE(result.find("App uid lifecycle dump"), string::npos);
+    EXPECT_EQ(result.find("Removed apps power: 0mAh"), string::npos);
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_018 end");
+}
+
+/**
+ * @tc.name: StatsServiceCoreTest_019
+ * @tc.desc: test BatteryStatsUidSlab keeps the slots of one uid in one row and recycles released rows
+ * @tc.type: FUNC
+ */
+HWTEST_F (StatsServiceCoreTest, StatsServiceCoreTest_019, TestSize.Level0)
+{
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_019 start");
+    BatteryStatsUidSlab uidSlab;
+    int32_t uid = 10013;
+    int32_t otherUid = 10014;
+    int64_t activeTimeMs = 100;
+
+    EXPECT_EQ(uidSlab.GetTimer(uid, BatteryStatsUidSlab::TIMER_AUDIO_ON), nullptr);
+    auto audioTimer = uidSlab.GetOrCreateTimer(uid, BatteryStatsUidSlab::TIMER_AUDIO_ON);
+    ASSERT_NE(audioTimer, nullptr);
+    audioTimer->AddRunningTimeMs(activeTimeMs);
+    uidSlab.GetOrCreateTimer(uid, BatteryStatsUidSlab::TIMER_GNSS_ON);
+    uidSlab.GetOrCreateCounter(uid, BatteryStatsUidSlab::COUNTER_ALARM);
+    EXPECT_EQ(uidSlab.GetRowNum(), 1);
+    EXPECT_EQ(uidSlab.GetTimer(uid, BatteryStatsUidSlab::TIMER_AUDIO_ON), audioTimer.get());
+    EXPECT_EQ(uidSlab.GetTimer(uid, BatteryStatsUidSlab::TIMER_AUDIO_ON)->GetRunningTimeMs(), activeTimeMs);
+    EXPECT_EQ(uidSlab.GetTimer(uid, BatteryStatsUidSlab::TIMER_WAKELOCK_HOLD), nullptr);
+
+    uidSlab.ResetTimers(BatteryStatsUidSlab::TIMER_AUDIO_ON);
+    EXPECT_EQ(audioTimer->GetRunningTimeMs(), StatsUtils::DEFAULT_VALUE);
+
+    EXPECT_EQ(uidSlab.ReleaseTimer(uid, BatteryStatsUidSlab::TIMER_AUDIO_ON), 1);
+    EXPECT_EQ(uidSlab.ReleaseTimer(uid, BatteryStatsUidSlab::TIMER_AUDIO_ON), 0);
+    EXPECT_EQ(uidSlab.ReleaseTimer(uid, BatteryStatsUidSlab::TIMER_GNSS_ON), 1);
+    EXPECT_EQ(uidSlab.GetRowNum(), 1);
+    EXPECT_EQ(uidSlab.ReleaseCounter(uid, BatteryStatsUidSlab::COUNTER_ALARM), 1);
+    EXPECT_EQ(uidSlab.GetRowNum(), 0);
+    audioTimer->AddRunningTimeMs(activeTimeMs);
+
+    auto otherTimer = uidSlab.GetOrCreateTimer(otherUid, BatteryStatsUidSlab::TIMER_AUDIO_ON);
+    EXPECT_EQ(otherTimer.get(), audioTimer.get());
+    EXPECT_EQ(otherTimer->GetRunningTimeMs(), StatsUtils::DEFAULT_VALUE);
+    EXPECT_EQ(uidSlab.GetTimer(uid, BatteryStatsUidSlab::TIMER_AUDIO_ON), nullptr);
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_019 end");
+}
+
+/**
+ * @tc.name: StatsServiceCoreTest_020
+ * @tc.desc: test GetLevelTimesMs reports every screen brightness and radio signal level in one call
+ * @tc.type: FUNC
+ */
+HWTEST_F (StatsServiceCoreTest, StatsServiceCoreTest_020, TestSize.Level0)
+{
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_020 start");
+    auto statsCore = BatteryStatsService::GetInstance()->GetBatteryStatsCore();
+    auto screenEntity = statsCore->GetEntity(BatteryStatsInfo::CONSUMPTION_TYPE_SCREEN);
+    auto phoneEntity = statsCore->GetEntity(BatteryStatsInfo::CONSUMPTION_TYPE_PHONE);
+    int16_t brightness = 100;
+    int16_t signalLevel = 3;
+    int64_t activeTimeMs = 100;
+
+    auto brightnessTimer = screenEntity->GetOrCreateTimer(StatsUtils::STATS_TYPE_SCREEN_BRIGHTNESS, brightness);
+    ASSERT_NE(brightnessTimer, nullptr);
+    brightnessTimer->AddRunningTimeMs(activeTimeMs);
+    EXPECT_EQ(screenEntity->GetOrCreateTimer(StatsUtils::STATS_TYPE_SCREEN_BRIGHTNESS,
+        StatsUtils::SCREEN_BRIGHTNESS_BIN + 1), nullptr);
+    auto phoneTimer = phoneEntity->GetOrCreateTimer(StatsUtils::STATS_TYPE_PHONE_DATA, signalLevel);
+    ASSERT_NE(phoneTimer, nullptr);
+    phoneTimer->AddRunningTimeMs(activeTimeMs);
+
+    std::vector<int64_t> levelTimesMs;
+    screenEntity->GetLevelTimesMs(StatsUtils::STATS_TYPE_SCREEN_BRIGHTNESS, levelTimesMs);
+    ASSERT_EQ(levelTimesMs.size(), StatsUtils::SCREEN_BRIGHTNESS_BIN + 1);
+    EXPECT_EQ(levelTimesMs[brightness], activeTimeMs);
+    EXPECT_EQ(levelTimesMs[0], StatsUtils::DEFAULT_VALUE);
+
+    phoneEntity->GetLevelTimesMs(StatsUtils::STATS_TYPE_PHONE_DATA, levelTimesMs);
+    ASSERT_EQ(levelTimesMs.size(), StatsUtils::RADIO_SIGNAL_BIN);
+    EXPECT_EQ(levelTimesMs[signalLevel], activeTimeMs);
+    phoneEntity->GetLevelTimesMs(StatsUtils::STATS_TYPE_PHONE_ACTIVE, levelTimesMs);
+    EXPECT_EQ(levelTimesMs[signalLevel], StatsUtils::DEFAULT_VALUE);
+    phoneEntity->GetLevelTimesMs(StatsUtils::STATS_TYPE_SCREEN_ON, levelTimesMs);
+    EXPECT_TRUE(levelTimesMs.empty());
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_020 end");
+}
+
+/**
+ * @tc.name: StatsServiceCoreTest_021
+ * @tc.desc: test CameraEntity interns device ids, counts ids past the limit as overflow and reports time per device
+ * @tc.type: FUNC
+ */
+HWTEST_F (StatsServiceCoreTest, StatsServiceCoreTest_021, TestSize.Level0)
+{
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_021 start");
+    CameraEntity cameraEntity;
+    std::string frontDeviceId = "Camera0";
+    std::string rearDeviceId = "Camera1";
+    int32_t uid = 10015;
+    int32_t otherUid = 10016;
+    int64_t frontTimeMs = 100;
+    int64_t rearTimeMs = 300;
+
+    uint16_t frontIndex = cameraEntity.InternDeviceId(frontDeviceId);
+    uint16_t rearIndex = cameraEntity.InternDeviceId(rearDeviceId);
+    EXPECT_NE(frontIndex, rearIndex);
+    EXPECT_EQ(cameraEntity.InternDeviceId(frontDeviceId), frontIndex);
+    EXPECT_EQ(cameraEntity.GetDeviceIds().size(), 2);
+    EXPECT_EQ(cameraEntity.GetOrCreateDeviceTimer(CameraEntity::INVALID_DEVICE_INDEX, uid), nullptr);
+
+    cameraEntity.GetOrCreateDeviceTimer(frontIndex, uid)->AddRunningTimeMs(frontTimeMs);
+    cameraEntity.GetOrCreateDeviceTimer(rearIndex, uid)->AddRunningTimeMs(rearTimeMs);
+    cameraEntity.GetOrCreateTimer(rearDeviceId, otherUid, StatsUtils::STATS_TYPE_CAMERA_ON)
+        ->AddRunningTimeMs(rearTimeMs);
+    EXPECT_EQ(cameraEntity.GetActiveTimeMs(uid, StatsUtils::STATS_TYPE_CAMERA_ON), frontTimeMs + rearTimeMs);
+    EXPECT_EQ(cameraEntity.GetDeviceActiveTimeMs(frontDeviceId, uid), frontTimeMs);
+    EXPECT_EQ(cameraEntity.GetDeviceActiveTimeMs(rearDeviceId), rearTimeMs + rearTimeMs);
+    EXPECT_EQ(cameraEntity.GetDeviceActiveTimeMs("Unknown"), StatsUtils::DEFAULT_VALUE);
+    EXPECT_GT(cameraEntity.GetDevicePowerMah(rearDeviceId), cameraEntity.GetDevicePowerMah(frontDeviceId));
+
+    EXPECT_EQ(cameraEntity.RemoveUid(uid), 2);
+    EXPECT_EQ(cameraEntity.GetActiveTimeMs(uid, StatsUtils::STATS_TYPE_CAMERA_ON), StatsUtils::DEFAULT_VALUE);
+    EXPECT_EQ(cameraEntity.GetDeviceActiveTimeMs(rearDeviceId), rearTimeMs);
+    EXPECT_EQ(cameraEntity.InternDeviceId(rearDeviceId), rearIndex);
+
+    cameraEntity.GetOrCreateDeviceTimer(frontIndex, otherUid)->StartRunning(StatsHelper::GetOnBatteryBootTimeMs());
+    EXPECT_EQ(cameraEntity.RemoveUid(otherUid), 1);
+    EXPECT_TRUE(cameraEntity.IsUidActive(otherUid));
+
+    for (uint16_t i = cameraEntity.GetDeviceIds().size(); i < CameraEntity::MAX_DEVICE_NUM; i++) {
+        cameraEntity.InternDeviceId("Camera" + std::to_string(i));
+    }
+    uint16_t overflowIndex = cameraEntity.InternDeviceId("CameraExtra0");
+    EXPECT_EQ(cameraEntity.InternDeviceId("CameraExtra1"), overflowIndex);
+    EXPECT_EQ(cameraEntity.GetDeviceIds().size(), CameraEntity::MAX_DEVICE_NUM + 1);
+    cameraEntity.GetOrCreateTimer("CameraExtra1", uid, StatsUtils::STATS_TYPE_CAMERA_ON)->AddRunningTimeMs(frontTimeMs);
+    EXPECT_EQ(cameraEntity.GetActiveTimeMs(uid, StatsUtils::STATS_TYPE_CAMERA_ON), frontTimeMs);
+    EXPECT_EQ(cameraEntity.GetDeviceActiveTimeMs(CameraEntity::OVERFLOW_DEVICE_ID, uid), frontTimeMs);
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_021 end");
+}
+
+/**
+ * @tc.name: StatsServiceCoreTest_022
+ * @tc.desc: test BatteryStatsInfoPool only recycles unreferenced records and steady compute passes allocate none
+ * @tc.type: FUNC
+ */
+HWTEST_F (StatsServiceCoreTest, StatsServiceCoreTest_022, TestSize.Level0)
+{
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_022 start");
+    BatteryStatsInfoPool infoPool;
+    int32_t uid = 10017;
+
+    auto appInfo = infoPool.Acquire(BatteryStatsInfo::CONSUMPTION_TYPE_APP);
+    appInfo->SetUid(uid);
+    auto otherInfo = infoPool.Acquire(BatteryStatsInfo::CONSUMPTION_TYPE_APP);
+    EXPECT_NE(otherInfo, appInfo);
+    EXPECT_EQ(infoPool.GetCreatedCount(), 2);
+    auto* appInfoAddr = appInfo.get();
+    appInfo.reset();
+    auto reusedInfo = infoPool.Acquire(BatteryStatsInfo::CONSUMPTION_TYPE_APP);
+    EXPECT_EQ(reusedInfo.get(), appInfoAddr);
+    EXPECT_EQ(reusedInfo->GetUid(), uid);
+    EXPECT_EQ(infoPool.GetReusedCount(), 1);
+    auto partInfo = infoPool.Acquire(BatteryStatsInfo::CONSUMPTION_TYPE_SCREEN);
+    EXPECT_EQ(partInfo->GetConsumptionType(), BatteryStatsInfo::CONSUMPTION_TYPE_SCREEN);
+    EXPECT_EQ(partInfo->GetUid(), StatsUtils::INVALID_VALUE);
+    EXPECT_EQ(infoPool.GetSize(), 3);
+
+    auto statsCore = BatteryStatsService::GetInstance()->GetBatteryStatsCore();
+    statsCore->UpdateStats(StatsUtils::STATS_TYPE_AUDIO_ON, StatsUtils::STATS_STATE_ACTIVATED,
+        StatsUtils::INVALID_VALUE, uid);
+    usleep(SERVICE_POWER_CONSUMPTION_DURATION_US);
+    statsCore->UpdateStats(StatsUtils::STATS_TYPE_AUDIO_ON, StatsUtils::STATS_STATE_DEACTIVATED,
+        StatsUtils::INVALID_VALUE, uid);
+    // The records of the last pass are still ranked while the next one runs, so two passes fill the pool
+    statsCore->ComputePower();
+    statsCore->ComputePower();
+    const auto& statsInfoPool = BatteryStatsEntity::GetStatsInfoPool();
+    uint64_t createdCount = statsInfoPool.GetCreatedCount();
+    uint64_t reusedCount = statsInfoPool.GetReusedCount();
+    constexpr int32_t STEADY_PASS_NUM = 3;
+    for (int32_t i = 0; i < STEADY_PASS_NUM; i++) {
+        statsCore->ComputePower();
+    }
+    EXPECT_EQ(statsInfoPool.GetCreatedCount(), createdCount);
+    EXPECT_GT(statsInfoPool.GetReusedCount(), reusedCount);
+    EXPECT_GT(statsCore->GetAppStatsMah(uid), StatsUtils::DEFAULT_VALUE);
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_022 end");
+}
+
+/**
+ * @tc.name: StatsServiceCoreTest_023
+ * @tc.desc: test energy is kept in whole nAh and the total equals the sum of its consumers exactly
+ * @tc.type: FUNC
+ */
+HWTEST_F (StatsServiceCoreTest, StatsServiceCoreTest_023, TestSize.Level0)
+{
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_023 start");
+    int64_t energyNah = 123456789012;
+    EXPECT_EQ(StatsUtils::ConvertToEnergyNah(StatsUtils::ConvertToPowerMah(energyNah)), energyNah);
+    double averageMa = 0.1;
+    EXPECT_EQ(StatsUtils::ConvertToEnergyNah(averageMa, StatsUtils::MS_IN_HOUR), 100000);
+
+    auto statsCore = BatteryStatsService::GetInstance()->GetBatteryStatsCore();
+    std::vector<int32_t> uids = { 10018, 10019, 10020 };
+    for (int32_t uid : uids) {
+        statsCore->UpdateStats(StatsUtils::STATS_TYPE_AUDIO_ON, StatsUtils::STATS_STATE_ACTIVATED,
+            StatsUtils::INVALID_VALUE, uid);
+    }
+    usleep(SERVICE_POWER_CONSUMPTION_DURATION_US);
+    for (int32_t uid : uids) {
+        statsCore->UpdateStats(StatsUtils::STATS_TYPE_AUDIO_ON, StatsUtils::STATS_STATE_DEACTIVATED,
+            StatsUtils::INVALID_VALUE, uid);
+    }
+    statsCore->ComputePower();
+
+    int64_t sumEnergyNah = StatsUtils::DEFAULT_VALUE;
+    for (const auto& info : BatteryStatsEntity::GetStatsInfoList()) {
+        if (info->GetConsumptionType() != BatteryStatsInfo::CONSUMPTION_TYPE_USER) {
+            sumEnergyNah += StatsUtils::ConvertToEnergyNah(info->GetPower());
+        }
+    }
+    int64_t totalEnergyNah = StatsUtils::ConvertToEnergyNah(BatteryStatsEntity::GetTotalPowerMah());
+    EXPECT_GT(totalEnergyNah, StatsUtils::DEFAULT_VALUE);
+    EXPECT_EQ(sumEnergyNah, totalEnergyNah);
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_023 end");
+}
+
+/**
+ * @tc.name: StatsServiceCoreTest_024
+ * @tc.desc: test a held back stop is applied with the time it was reported at
+ * @tc.type: FUNC
+ */
+HWTEST_F (StatsServiceCoreTest, StatsServiceCoreTest_024, TestSize.Level0)
+{
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_024 start");
+    std::atomic<int64_t> appliedTimeMs {StatsUtils::INVALID_VALUE};
+    BatteryStatsCoalescer coalescer;
+    coalescer.SetApplyCallback([&appliedTimeMs](const StatsUtils::StatsData& data, int64_t timeMs) {
+        appliedTimeMs = timeMs;
+    });
+    constexpr int64_t FLAP_WINDOW_MS = 200;
+    coalescer.SetFlapWindowMs(FLAP_WINDOW_MS);
+
+    StatsUtils::StatsData audioData;
+    audioData.type = StatsUtils::STATS_TYPE_AUDIO_ON;
+    audioData.uid = 10021;
+    audioData.state = StatsUtils::STATS_STATE_ACTIVATED;
+    EXPECT_FALSE(coalescer.Coalesce(audioData));
+    audioData.state = StatsUtils::STATS_STATE_DEACTIVATED;
+    int64_t stopTimeMs = StatsHelper::GetOnBatteryBootTimeMs();
+    EXPECT_TRUE(coalescer.Coalesce(audioData));
+    constexpr useconds_t FLUSH_WAIT_US = 3 * FLAP_WINDOW_MS * StatsUtils::US_IN_MS;
+    usleep(FLUSH_WAIT_US);
+    EXPECT_NE(appliedTimeMs.load(), StatsUtils::INVALID_VALUE);
+    EXPECT_LT(appliedTimeMs.load() - stopTimeMs, FLAP_WINDOW_MS);
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_024 end");
+}
+
+/**
+ * @tc.name: StatsServiceCoreTest_025
+ * @tc.desc: test the detector applies admitted events through ApplyBatch
+ * @tc.type: FUNC
+ */
+HWTEST_F (StatsServiceCoreTest, StatsServiceCoreTest_025, TestSize.Level0)
+{
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_025 start");
+    auto statsService = BatteryStatsService::GetInstance();
+    auto statsCore = statsService->GetBatteryStatsCore();
+    auto detector = statsService->GetBatteryStatsDetector();
+    ASSERT_NE(detector, nullptr);
+    statsCore->SetCoalesceWindowMs(StatsUtils::DEFAULT_VALUE);
+    int32_t uid = 10022;
+
+    StatsUtils::StatsData audioData;
+    audioData.type = StatsUtils::STATS_TYPE_AUDIO_ON;
+    audioData.uid = uid;
+    audioData.state = StatsUtils::STATS_STATE_ACTIVATED;
+    detector->HandleStatsChangedEvent(audioData);
+    usleep(SERVICE_POWER_CONSUMPTION_DURATION_US);
+    audioData.state = StatsUtils::STATS_STATE_DEACTIVATED;
+    detector->HandleStatsChangedEvent(audioData);
+
+    StatsUtils::StatsData alarmData;
+    alarmData.type = StatsUtils::STATS_TYPE_ALARM;
+    alarmData.uid = uid;
+    alarmData.traffic = 1;
+    constexpr int32_t ALARM_NUM = 3;
+    for (int32_t i = 0; i < ALARM_NUM; i++) {
+        detector->HandleStatsChangedEvent(alarmData);
+    }
+
+    EXPECT_GT(statsCore->GetTotalTimeMs(uid, StatsUtils::STATS_TYPE_AUDIO_ON), StatsUtils::DEFAULT_VALUE);
+    EXPECT_EQ(statsCore->GetTotalConsumptionCount(StatsUtils::STATS_TYPE_ALARM, uid), ALARM_NUM);
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_025 end");
+}
+
+/**
+ * @tc.name: StatsServiceCoreTest_026
+ * @tc.desc: test a camera still running when its uid is removed is not counted twice once it stops
+ * @tc.type: FUNC
+ */
+HWTEST_F (StatsServiceCoreTest, StatsServiceCoreTest_026, TestSize.Level0)
+{
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_026 start");
+    auto statsCore = BatteryStatsService::GetInstance()->GetBatteryStatsCore();
+    int32_t uid = 10023;
+    std::string deviceId = "Camera0";
+
+    statsCore->UpdateStats(StatsUtils::STATS_TYPE_CAMERA_ON, StatsUtils::STATS_STATE_ACTIVATED,
+        StatsUtils::INVALID_VALUE, uid, deviceId);
+    usleep(SERVICE_POWER_CONSUMPTION_DURATION_US);
+    statsCore->ComputePower();
+    double appPower = statsCore->GetAppStatsMah(uid);
+    EXPECT_GT(appPower, StatsUtils::DEFAULT_VALUE);
+
+    statsCore->RemoveUid(uid);
+    statsCore->ComputePower();
+    double totalPower = BatteryStatsEntity::GetTotalPowerMah();
+    statsCore->UpdateStats(StatsUtils::STATS_TYPE_CAMERA_ON, StatsUtils::STATS_STATE_DEACTIVATED,
+        StatsUtils::INVALID_VALUE, uid, deviceId);
+    statsCore->ComputePower();
+    EXPECT_LT(statsCore->GetAppStatsMah(uid), appPower / 2);
+    EXPECT_LT(BatteryStatsEntity::GetTotalPowerMah() - totalPower, appPower / 2);
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_026 end");
+}
+
+/**
+ * @tc.name: StatsServiceCoreTest_027
+ * @tc.desc: test a held back stop ends the timer at its own time even when a compute pass ran inside the window
+ * @tc.type: FUNC
+ */
+HWTEST_F (StatsServiceCoreTest, StatsServiceCoreTest_027, TestSize.Level0)
+{
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_027 start");
+    constexpr int64_t FLAP_WINDOW_MS = 100;
+    StatsHelper::ActiveTimer timer;
+    std::atomic<int64_t> stopTimeMs {StatsUtils::INVALID_VALUE};
+    BatteryStatsCoalescer coalescer;
+    coalescer.SetApplyCallback([&timer, &stopTimeMs](const StatsUtils::StatsData& data, int64_t timeMs) {
+        timer.StopRunning(timeMs);
+        stopTimeMs = timeMs;
+    });
+    coalescer.SetFlapWindowMs(FLAP_WINDOW_MS);
+
+    StatsUtils::StatsData audioData;
+    audioData.type = StatsUtils::STATS_TYPE_AUDIO_ON;
+    audioData.uid = 10024;
+    audioData.state = StatsUtils::STATS_STATE_ACTIVATED;
+    EXPECT_FALSE(coalescer.Coalesce(audioData));
+    int64_t startTimeMs = StatsHelper::GetOnBatteryBootTimeMs();
+    timer.StartRunning(startTimeMs);
+    usleep(SERVICE_POWER_CONSUMPTION_DURATION_US);
+    audioData.state = StatsUtils::STATS_STATE_DEACTIVATED;
+    EXPECT_TRUE(coalescer.Coalesce(audioData));
+
+    // A compute pass inside the window moves the start of the timer past the held back stop
+    usleep(FLAP_WINDOW_MS * US_PER_MS / 2);
+    timer.GetRunningTimeMs(StatsHelper::GetOnBatteryBootTimeMs());
+    usleep(SERVICE_POWER_CONSUMPTION_DURATION_US);
+    ASSERT_NE(stopTimeMs.load(), StatsUtils::INVALID_VALUE);
+    EXPECT_EQ(timer.GetRunningTimeMs(), stopTimeMs.load() - startTimeMs);
+    STATS_HILOGI(LABEL_TEST, "StatsServiceCoreTest_027 end");
+}
+}
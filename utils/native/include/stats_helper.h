@@ -16,6 +16,8 @@
 #ifndef STATS_HELPER_H
 #define STATS_HELPER_H
 
+#include <algorithm>
+#include <atomic>
 #include <cinttypes>
 
 #include "stats_log.h"
@@ -25,49 +27,87 @@ namespace OHOS {
 namespace PowerMgr {
 class StatsHelper {
 public:
+    /**
+     * Lock free timer, the running flag and the start time are packed into one atomic word
+     * so concurrent readers and writers never see one without the other.
+     */
     class ActiveTimer {
     public:
         ActiveTimer() = default;
         ~ActiveTimer() = default;
         bool StartRunning()
         {
-            if (isRunning_) {
-                STATS_HILOGD(COMP_SVC, "Active timer was already started");
-                return false;
-            }
-            startTimeMs_ = GetOnBatteryBootTimeMs();
-            isRunning_ = true;
+            return StartRunning(GetOnBatteryBootTimeMs());
+        }
+
+        // Start with an on battery boot time the caller has already read, so a batch shares one clock read
+        bool StartRunning(int64_t startTimeMs)
+        {
+            uint64_t state = state_.load(std::memory_order_acquire);
+            do {
+                if (IsRunning(state)) {
+                    STATS_HILOGD(COMP_SVC, "Active timer was already started");
+                    return false;
+                }
+            } while (!state_.compare_exchange_weak(state, PackState(startTimeMs, true), std::memory_order_acq_rel,
+                std::memory_order_acquire));
             STATS_HILOGD(COMP_SVC, "Active timer is started");
             return true;
         }
 
         bool StopRunning()
         {
-            if (!isRunning_) {
-                STATS_HILOGD(COMP_SVC, "No related active timer is running");
-                return false;
+            return StopRunning(GetOnBatteryBootTimeMs());
+        }
+
+        bool StopRunning(int64_t stopTimeMs)
+        {
+            uint64_t state = state_.load(std::memory_order_acquire);
+            do {
+                if (!IsRunning(state)) {
+                    STATS_HILOGD(COMP_SVC, "No related active timer is running");
+                    return false;
+                }
+            } while (!state_.compare_exchange_weak(state, PackState(GetStartTimeMs(state), false),
+                std::memory_order_acq_rel, std::memory_order_acquire));
+            int64_t startTimeMs = GetStartTimeMs(state);
+            if (stopTimeMs > startTimeMs) {
+                totalTimeMs_.fetch_add(stopTimeMs - startTimeMs, std::memory_order_relaxed);
+            } else if (stopTimeMs < startTimeMs) {
+                // A read after a held back stop moved the start past it, so take back the time counted beyond it
+                int64_t totalTimeMs = totalTimeMs_.load(std::memory_order_relaxed);
+                while (!totalTimeMs_.compare_exchange_weak(totalTimeMs,
+                    std::max<int64_t>(totalTimeMs - (startTimeMs - stopTimeMs), StatsUtils::DEFAULT_VALUE),
+                    std::memory_order_relaxed)) {
+                }
             }
-            auto stopTimeMs = GetOnBatteryBootTimeMs();
-            totalTimeMs_ += stopTimeMs - startTimeMs_;
-            isRunning_ = false;
             STATS_HILOGD(COMP_SVC, "Active timer is stopped");
             return true;
         }
 
         int64_t GetRunningTimeMs()
         {
-            if (isRunning_) {
-                auto tmpStopTimeMs = GetOnBatteryBootTimeMs();
-                totalTimeMs_ += tmpStopTimeMs - startTimeMs_;
-                startTimeMs_ = tmpStopTimeMs;
+            return GetRunningTimeMs(GetComputeTimeMs());
+        }
+
+        int64_t GetRunningTimeMs(int64_t nowMs)
+        {
+            uint64_t state = state_.load(std::memory_order_acquire);
+            // A timer started after the pinned compute time has nothing to add yet
+            while (IsRunning(state) && nowMs > GetStartTimeMs(state)) {
+                if (state_.compare_exchange_weak(state, PackState(nowMs, true), std::memory_order_acq_rel,
+                    std::memory_order_acquire)) {
+                    totalTimeMs_.fetch_add(nowMs - GetStartTimeMs(state), std::memory_order_relaxed);
+                    break;
+                }
             }
-            return totalTimeMs_;
+            return totalTimeMs_.load(std::memory_order_relaxed);
         }
 
         void AddRunningTimeMs(int64_t avtiveTime)
         {
             if (avtiveTime > StatsUtils::DEFAULT_VALUE) {
-                totalTimeMs_ += avtiveTime;
+                totalTimeMs_.fetch_add(avtiveTime, std::memory_order_relaxed);
                 STATS_HILOGD(COMP_SVC, "Add on active Time: %{public}" PRId64 "", avtiveTime);
             } else {
                 STATS_HILOGW(COMP_SVC, "Invalid active time, ignore");
@@ -76,14 +116,31 @@ public:
 
         void Reset()
         {
-            isRunning_ = false;
-            startTimeMs_ = GetOnBatteryBootTimeMs();
-            totalTimeMs_ = StatsUtils::DEFAULT_VALUE;
+            state_.store(PackState(GetOnBatteryBootTimeMs(), false), std::memory_order_release);
+            totalTimeMs_.store(StatsUtils::DEFAULT_VALUE, std::memory_order_relaxed);
+        }
+
+        bool IsRunning()
+        {
+            return IsRunning(state_.load(std::memory_order_acquire));
         }
     private:
-        bool isRunning_ = false;
-        int64_t startTimeMs_ = StatsUtils::DEFAULT_VALUE;
-        int64_t totalTimeMs_ = StatsUtils::DEFAULT_VALUE;
+        static constexpr uint64_t RUNNING_FLAG = 1;
+        static uint64_t PackState(int64_t startTimeMs, bool isRunning)
+        {
+            uint64_t startTime = startTimeMs > StatsUtils::DEFAULT_VALUE ? static_cast<uint64_t>(startTimeMs) : 0;
+            return (startTime << 1) | (isRunning ? RUNNING_FLAG : 0);
+        }
+        static bool IsRunning(uint64_t state)
+        {
+            return (state & RUNNING_FLAG) != 0;
+        }
+        static int64_t GetStartTimeMs(uint64_t state)
+        {
+            return static_cast<int64_t>(state >> 1);
+        }
+        std::atomic<uint64_t> state_ {0};
+        std::atomic<int64_t> totalTimeMs_ {StatsUtils::DEFAULT_VALUE};
     };
 
     class Counter {
@@ -94,10 +151,10 @@ public:
         {
             if (count > StatsUtils::DEFAULT_VALUE) {
                 if (IsOnBattery()) {
-                    totalCount_ += count;
+                    totalCount_.fetch_add(count, std::memory_order_relaxed);
                 }
                 STATS_HILOGD(COMP_SVC, "Add data bytes: %{public}" PRId64 ", total data bytes is: %{public}" PRId64 "",
-                    count, totalCount_);
+                    count, GetCount());
             } else {
                 STATS_HILOGW(COMP_SVC, "Invalid data counts");
             }
@@ -105,19 +162,34 @@ public:
 
         int64_t GetCount()
         {
-            return totalCount_;
+            return totalCount_.load(std::memory_order_relaxed);
         }
 
         void Reset()
         {
-            totalCount_ = StatsUtils::DEFAULT_VALUE;
+            totalCount_.store(StatsUtils::DEFAULT_VALUE, std::memory_order_relaxed);
         }
     private:
-        int64_t totalCount_ = StatsUtils::DEFAULT_VALUE;
+        std::atomic<int64_t> totalCount_ {StatsUtils::DEFAULT_VALUE};
+    };
+    /**
+     * Pins the on battery boot time for timer reads on the current thread.
+     * All timers read inside the scope see the same instant, nested scopes keep the outermost time.
+     */
+    class ComputeTimeScope {
+    public:
+        ComputeTimeScope();
+        ~ComputeTimeScope();
+        ComputeTimeScope(const ComputeTimeScope&) = delete;
+        ComputeTimeScope& operator=(const ComputeTimeScope&) = delete;
+    private:
+        bool isOwner_ = false;
     };
     static void SetOnBattery(bool onBattery);
     static void SetScreenOff(bool screenOff);
     static int64_t GetOnBatteryBootTimeMs();
+    static int64_t GetOnBatteryBootTimeMs(int64_t currentBootTimeMs);
+    static int64_t GetComputeTimeMs();
     static int64_t GetOnBatteryUpTimeMs();
     static bool IsOnBattery();
     static bool IsOnBatteryScreenOff();
@@ -130,6 +202,8 @@ private:
     static int64_t onBatteryUpTimeMs_;
     static bool onBattery_;
     static bool screenOff_;
+    static thread_local bool isComputeTimePinned_;
+    static thread_local int64_t computeTimeMs_;
 };
 } // namespace PowerMgr
 } // namespace OHOS
@@ -32,6 +32,7 @@ public:
     static constexpr uint32_t MS_IN_SECOND = 1000;
     static constexpr uint32_t NS_IN_MS = 1000000;
     static constexpr uint32_t US_IN_MS = 1000;
+    static constexpr int64_t NAH_IN_MAH = 1000000;
 
     static constexpr const char* CURRENT_INVALID = "invalid";
     static constexpr const char* CURRENT_BLUETOOTH_BR_ON = "bluetooth_br_on";
@@ -116,6 +117,10 @@ public:
 
     static std::string ConvertStatsType(StatsType statsType);
     static bool ParseStrtollResult(const std::string& str, int64_t& result);
+    // Energy is summed as whole nAh, so a total is exact and does not depend on the order of its terms
+    static int64_t ConvertToEnergyNah(double averageMa, int64_t timeMs);
+    static int64_t ConvertToEnergyNah(double powerMah);
+    static double ConvertToPowerMah(int64_t energyNah);
 private:
     static std::string ConvertTypeForConn(StatsType statsType);
     static std::string ConvertTypeForCpu(StatsType statsType);
@@ -26,6 +26,24 @@ int64_t StatsHelper::onBatteryBootTimeMs_ = StatsUtils::DEFAULT_VALUE;
 int64_t StatsHelper::onBatteryUpTimeMs_ = StatsUtils::DEFAULT_VALUE;
 bool StatsHelper::onBattery_ = false;
 bool StatsHelper::screenOff_ = false;
+thread_local bool StatsHelper::isComputeTimePinned_ = false;
+thread_local int64_t StatsHelper::computeTimeMs_ = StatsUtils::DEFAULT_VALUE;
+
+StatsHelper::ComputeTimeScope::ComputeTimeScope()
+{
+    if (!isComputeTimePinned_) {
+        computeTimeMs_ = GetOnBatteryBootTimeMs();
+        isComputeTimePinned_ = true;
+        isOwner_ = true;
+    }
+}
+
+StatsHelper::ComputeTimeScope::~ComputeTimeScope()
+{
+    if (isOwner_) {
+        isComputeTimePinned_ = false;
+    }
+}
 
 int64_t StatsHelper::GetBootTimeMs()
 {
@@ -94,9 +112,13 @@ bool StatsHelper::IsOnBatteryScreenOff()
 }
 
 int64_t StatsHelper::GetOnBatteryBootTimeMs()
+{
+    return GetOnBatteryBootTimeMs(GetBootTimeMs());
+}
+
+int64_t StatsHelper::GetOnBatteryBootTimeMs(int64_t currentBootTimeMs)
 {
     int64_t onBatteryBootTimeMs = onBatteryBootTimeMs_;
-    int64_t currentBootTimeMs = GetBootTimeMs();
     if (IsOnBattery()) {
         onBatteryBootTimeMs += currentBootTimeMs - latestUnplugBootTimeMs_;
     }
@@ -106,6 +128,11 @@ int64_t StatsHelper::GetOnBatteryBootTimeMs()
     return onBatteryBootTimeMs;
 }
 
+int64_t StatsHelper::GetComputeTimeMs()
+{
+    return isComputeTimePinned_ ? computeTimeMs_ : GetOnBatteryBootTimeMs();
+}
+
 int64_t StatsHelper::GetOnBatteryUpTimeMs()
 {
     int64_t onBatteryUpTimeMs = onBatteryUpTimeMs_;
@@ -15,6 +15,8 @@
 
 #include "stats_utils.h"
 
+#include <cmath>
+
 #include "stats_log.h"
 
 namespace OHOS {
@@ -212,5 +214,20 @@ bool StatsUtils::ParseStrtollResult(const std::string& str, int64_t& result)
     }
     return true;
 }
+
+int64_t StatsUtils::ConvertToEnergyNah(double averageMa, int64_t timeMs)
+{
+    return std::llround(averageMa * static_cast<double>(timeMs) * NAH_IN_MAH / MS_IN_HOUR);
+}
+
+int64_t StatsUtils::ConvertToEnergyNah(double powerMah)
+{
+    return std::llround(powerMah * NAH_IN_MAH);
+}
+
+double StatsUtils::ConvertToPowerMah(int64_t energyNah)
+{
+    return static_cast<double>(energyNah) / NAH_IN_MAH;
+}
 } // namespace PowerMgr
 } // namespace OHOS
\ No newline at end of file